@@ -0,0 +1,105 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Per-opcode totals for the panel bus.
+struct BusOpcodeStats
+{
+  uint32_t commands;
+  uint32_t dataBytes;
+  uint32_t csAssertions;
+  uint32_t busUs;
+  uint32_t busyUs;
+};
+
+// Attributes bus activity to controller opcodes. A CS window is charged to
+// the opcode current when it closes, so a command's own window and the data
+// windows that follow it land on the same row. BUSY time is charged to the
+// last opcode sent before BUSY went active. Times are caller-supplied
+// microseconds and may wrap.
+class BusProfiler
+{
+public:
+  void begin(uint32_t nowUs)
+  {
+    _windowStartUs = nowUs;
+  }
+
+  // Bytes sent inside the open window; dc false marks opcode bytes.
+  void bytes(bool dc, const uint8_t *data, size_t count)
+  {
+    if (count == 0) return;
+    if (dc)
+    {
+      _stats[_opcode].dataBytes += static_cast<uint32_t>(count);
+      return;
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+      _opcode = data[i];
+      ++_stats[_opcode].commands;
+    }
+  }
+
+  void end(uint32_t nowUs)
+  {
+    BusOpcodeStats &row = _stats[_opcode];
+    ++row.csAssertions;
+    row.busUs += nowUs - _windowStartUs;
+  }
+
+  void busyEdge(bool active, uint32_t nowUs)
+  {
+    if (active)
+    {
+      _busyOpcode = _opcode;
+      _busyStartUs = nowUs;
+      _busyOpen = true;
+      return;
+    }
+    if (!_busyOpen) return;
+    _stats[_busyOpcode].busyUs += nowUs - _busyStartUs;
+    _busyOpen = false;
+  }
+
+  void reset()
+  {
+    memset(_stats, 0, sizeof(_stats));
+    _busyOpen = false;
+  }
+
+  const BusOpcodeStats &stats(uint8_t opcode) const
+  {
+    return _stats[opcode];
+  }
+
+  bool used(uint8_t opcode) const
+  {
+    const BusOpcodeStats &row = _stats[opcode];
+    return row.commands != 0 || row.csAssertions != 0 || row.busyUs != 0;
+  }
+
+  BusOpcodeStats total() const
+  {
+    BusOpcodeStats sum = {};
+    for (const BusOpcodeStats &row : _stats)
+    {
+      sum.commands += row.commands;
+      sum.dataBytes += row.dataBytes;
+      sum.csAssertions += row.csAssertions;
+      sum.busUs += row.busUs;
+      sum.busyUs += row.busyUs;
+    }
+    return sum;
+  }
+
+private:
+  BusOpcodeStats _stats[256] = {};
+  uint8_t _opcode = 0;
+  uint8_t _busyOpcode = 0;
+  bool _busyOpen = false;
+  uint32_t _windowStartUs = 0;
+  uint32_t _busyStartUs = 0;
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Builds lines from a byte stream without blocking. '\r' is dropped, '\n'
+// completes the line; an overlong line is truncated and flagged.
+template <size_t LineMax>
+class LineAssembler
+{
+public:
+  // Returns true when c completed a line, available through line().
+  bool feed(char c)
+  {
+    if (_complete)
+    {
+      _length = 0;
+      _overflow = false;
+      _complete = false;
+    }
+    if (c == '\r') return false;
+    if (c == '\n')
+    {
+      _buffer[_length] = '\0';
+      _complete = true;
+      return true;
+    }
+    if (_length < LineMax - 1)
+    {
+      _buffer[_length++] = c;
+    }
+    else
+    {
+      _overflow = true;
+    }
+    return false;
+  }
+
+  const char *line() const
+  {
+    return _buffer;
+  }
+
+  size_t length() const
+  {
+    return _length;
+  }
+
+  bool overflow() const
+  {
+    return _overflow;
+  }
+
+private:
+  char _buffer[LineMax] = {};
+  size_t _length = 0;
+  bool _overflow = false;
+  bool _complete = false;
+};
+
+// Fixed-capacity FIFO of text lines sitting between reception and execution.
+template <size_t Depth, size_t LineMax>
+class LineQueue
+{
+public:
+  bool empty() const
+  {
+    return _count == 0;
+  }
+
+  bool full() const
+  {
+    return _count == Depth;
+  }
+
+  size_t size() const
+  {
+    return _count;
+  }
+
+  bool push(const char *line, size_t length)
+  {
+    if (full()) return false;
+    if (length > LineMax - 1) length = LineMax - 1;
+    char *slot = _lines[(_head + _count) % Depth];
+    memcpy(slot, line, length);
+    slot[length] = '\0';
+    ++_count;
+    return true;
+  }
+
+  const char *front() const
+  {
+    return empty() ? nullptr : _lines[_head];
+  }
+
+  void pop()
+  {
+    if (empty()) return;
+    _head = (_head + 1) % Depth;
+    --_count;
+  }
+
+private:
+  char _lines[Depth][LineMax] = {};
+  size_t _head = 0;
+  size_t _count = 0;
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Console dispatch without heap: lines are split in place and the command
+// word is looked up by binary search in a table sorted at compile time.
+
+constexpr char commandLower(char c)
+{
+  return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+constexpr bool commandSpace(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+// Orders a lowercase table name against the first keyLen chars of key,
+// ignoring case in key. Negative when name sorts first.
+constexpr int commandCompare(const char *name, const char *key, size_t keyLen)
+{
+  for (size_t i = 0; i < keyLen; ++i)
+  {
+    const char k = commandLower(key[i]);
+    if (name[i] != k) return static_cast<unsigned char>(name[i]) - static_cast<unsigned char>(k);
+  }
+  return name[keyLen] == '\0' ? 0 : 1;
+}
+
+constexpr size_t commandLength(const char *s)
+{
+  size_t n = 0;
+  while (s[n] != '\0') ++n;
+  return n;
+}
+
+template <typename Handler, typename Kind>
+struct CommandSpec
+{
+  const char *name;
+  uint8_t minArgs;
+  uint8_t maxArgs;
+  Kind kind;
+  Handler run;
+  const char *usage;
+};
+
+template <typename Spec, size_t N>
+constexpr bool commandTableSorted(const Spec (&table)[N])
+{
+  for (size_t i = 1; i < N; ++i)
+  {
+    const char *prev = table[i - 1].name;
+    if (commandCompare(prev, table[i].name, commandLength(table[i].name)) >= 0) return false;
+  }
+  return true;
+}
+
+template <typename Spec, size_t N>
+const Spec *findCommand(const Spec (&table)[N], const char *key, size_t keyLen)
+{
+  size_t lo = 0;
+  size_t hi = N;
+  while (lo < hi)
+  {
+    const size_t mid = lo + (hi - lo) / 2;
+    const int order = commandCompare(table[mid].name, key, keyLen);
+    if (order == 0) return &table[mid];
+    if (order < 0)
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+  return nullptr;
+}
+
+// First whitespace-delimited word of line, without modifying it.
+inline const char *commandWord(const char *line, size_t &length)
+{
+  while (commandSpace(*line)) ++line;
+  length = 0;
+  while (line[length] != '\0' && !commandSpace(line[length])) ++length;
+  return line;
+}
+
+// Cuts line into words by writing terminators over the separators. Stores at
+// most maxArgs pointers but returns the total word count, so callers can
+// reject surplus arguments.
+inline size_t splitArgs(char *line, char **argv, size_t maxArgs)
+{
+  size_t count = 0;
+  while (*line != '\0')
+  {
+    while (commandSpace(*line)) *line++ = '\0';
+    if (*line == '\0') break;
+    if (count < maxArgs) argv[count] = line;
+    ++count;
+    while (*line != '\0' && !commandSpace(*line)) ++line;
+  }
+  return count;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "command_table.h"
+
+// The serial console's command set: names, argument counts, kinds and
+// usage, plus the argument parsers. The firmware dispatches through it and
+// the host tools that replay console sessions use the same table, so they
+// cannot drift apart. 'stats' and 'timing' are only there when
+// EPD_BUS_STATS / EPD_REFRESH_TELEMETRY are set where this is included.
+
+static constexpr size_t RAW_DATA_MAX = 9;
+static constexpr size_t COMMAND_ARGS_MAX = 1 + RAW_DATA_MAX;
+
+// Offsets, base offsets and rotation only change state; they coalesce into
+// one redraw of the final state. Raw register commands are barriers that
+// flush a pending redraw first so the panel sees them in order. Stream
+// commands flush the same way but switch console input on core0.
+enum class CommandKind : uint8_t
+{
+  Info,
+  State,
+  Redraw,
+  Barrier,
+  Stream
+};
+
+// Handlers provides the handler type Fn and one static handler per
+// command; table is sorted by name, checked where it is used.
+template <typename Handlers>
+struct ConsoleCommands
+{
+  using Spec = CommandSpec<typename Handlers::Fn, CommandKind>;
+
+  static constexpr Spec table[] = {
+    {"base", 3, 3, CommandKind::State, Handlers::base, "base <rot> <x> <y>"},
+    {"bin", 0, 1, CommandKind::Stream, Handlers::binary, "bin [uc|ssd]"},
+    {"clear", 0, 0, CommandKind::Barrier, Handlers::clear, "clear"},
+    {"contrast", 0, 0, CommandKind::Barrier, Handlers::contrast, "contrast"},
+    {"d", 0, 1, CommandKind::Redraw, Handlers::redraw, "d [force]"},
+    {"diag", 4, 4, CommandKind::Barrier, Handlers::diag, "diag <sx> <ex> <sy> <ey>"},
+    {"gate", 2, 2, CommandKind::Barrier, Handlers::gate, "gate <start> <end> (decimal)"},
+    {"h", 0, 0, CommandKind::Info, Handlers::help, "h"},
+    {"hs", 2, 2, CommandKind::Barrier, Handlers::hscan, "hs <start> <end> (decimal, multiples of 8)"},
+    {"o", 2, 2, CommandKind::State, Handlers::offsets, "o <x> <y>"},
+    {"r", 0, 0, CommandKind::State, Handlers::resetOffsets, "r"},
+    {"rawcmd", 1, 1 + RAW_DATA_MAX, CommandKind::Barrier, Handlers::raw, "rawcmd <cmd> [data..] (hex)"},
+    {"rb", 0, 0, CommandKind::State, Handlers::resetBase, "rb"},
+    {"rot", 1, 1, CommandKind::State, Handlers::rotation, "rot <0-3>"},
+    {"s", 0, 0, CommandKind::Info, Handlers::status, "s"},
+#if EPD_BUS_STATS
+    {"stats", 0, 1, CommandKind::Barrier, Handlers::stats, "stats [reset]"},
+#endif
+#if EPD_REFRESH_TELEMETRY
+    {"timing", 0, 1, CommandKind::Barrier, Handlers::timing, "timing [reset]"},
+#endif
+    {"wash", 0, 0, CommandKind::Barrier, Handlers::wash, "wash"},
+  };
+};
+
+template <typename Handlers>
+constexpr typename ConsoleCommands<Handlers>::Spec ConsoleCommands<Handlers>::table[];
+
+// Whole token must be a number, otherwise the command is rejected.
+inline bool parseNumber(const char *token, long &outValue, int base)
+{
+  char *end = nullptr;
+  outValue = strtol(token, &end, base);
+  return end != token && *end == '\0';
+}
+
+inline bool parseHexByte(const char *token, uint8_t &outValue)
+{
+  long value = 0;
+  if (!parseNumber(token, value, 16) || value < 0x00 || value > 0xFF) return false;
+  outValue = static_cast<uint8_t>(value);
+  return true;
+}
+
+inline bool parseOffset(const char *token, int16_t &outValue)
+{
+  long value = 0;
+  if (!parseNumber(token, value, 10) || value < INT16_MIN || value > INT16_MAX) return false;
+  outValue = static_cast<int16_t>(value);
+  return true;
+}
+
+inline bool parseRotationValue(const char *token, uint8_t &outRotation)
+{
+  long value = 0;
+  if (!parseNumber(token, value, 10) || value < 0 || value > 3) return false;
+  outRotation = static_cast<uint8_t>(value);
+  return true;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <stdint.h>
+
+// Inclusive bounding box in logical (rotated) display coordinates.
+struct DirtyRect
+{
+  int16_t x0;
+  int16_t y0;
+  int16_t x1;
+  int16_t y1;
+
+  static DirtyRect none()
+  {
+    return DirtyRect{INT16_MAX, INT16_MAX, INT16_MIN, INT16_MIN};
+  }
+
+  bool empty() const
+  {
+    return x1 < x0 || y1 < y0;
+  }
+
+  int16_t width() const
+  {
+    return empty() ? 0 : x1 - x0 + 1;
+  }
+
+  int16_t height() const
+  {
+    return empty() ? 0 : y1 - y0 + 1;
+  }
+
+  int32_t area() const
+  {
+    return static_cast<int32_t>(width()) * height();
+  }
+
+  bool operator==(const DirtyRect &o) const
+  {
+    return x0 == o.x0 && y0 == o.y0 && x1 == o.x1 && y1 == o.y1;
+  }
+
+  bool operator!=(const DirtyRect &o) const
+  {
+    return !(*this == o);
+  }
+
+  void add(const DirtyRect &r)
+  {
+    if (r.empty()) return;
+    if (r.x0 < x0) x0 = r.x0;
+    if (r.y0 < y0) y0 = r.y0;
+    if (r.x1 > x1) x1 = r.x1;
+    if (r.y1 > y1) y1 = r.y1;
+  }
+
+  // Overlapping or edge to edge.
+  bool touches(const DirtyRect &r) const
+  {
+    return !empty() && !r.empty() && r.x0 <= x1 + 1 && x0 <= r.x1 + 1 && r.y0 <= y1 + 1 && y0 <= r.y1 + 1;
+  }
+};
+
+// Up to MAX_RECTS disjoint boxes. A box that touches one already held is
+// merged with it; when all slots are taken, the new box joins the one whose
+// bounding box grows the least.
+struct DirtyRegion
+{
+  static constexpr uint8_t MAX_RECTS = 4;
+
+  DirtyRect rects[MAX_RECTS];
+  uint8_t count = 0;
+
+  bool empty() const
+  {
+    return count == 0;
+  }
+
+  int32_t area() const
+  {
+    int32_t sum = 0;
+    for (uint8_t i = 0; i < count; ++i) sum += rects[i].area();
+    return sum;
+  }
+
+  DirtyRect bounds() const
+  {
+    DirtyRect all = DirtyRect::none();
+    for (uint8_t i = 0; i < count; ++i) all.add(rects[i]);
+    return all;
+  }
+
+  void add(DirtyRect r)
+  {
+    if (r.empty()) return;
+    for (;;)
+    {
+      uint8_t i = 0;
+      while (i < count && !rects[i].touches(r)) ++i;
+      if (i == count && count < MAX_RECTS) break;
+      if (i == count) i = cheapestMerge(r);
+      r.add(rects[i]);
+      rects[i] = rects[--count];
+    }
+    rects[count++] = r;
+  }
+
+  // Merges boxes until at most n are left.
+  void reduce(uint8_t n)
+  {
+    if (n == 0) n = 1;
+    while (count > n)
+    {
+      const DirtyRect last = rects[--count];
+      rects[cheapestMerge(last)].add(last);
+      // the grown box may now touch others
+      const DirtyRegion copy = *this;
+      count = 0;
+      for (uint8_t i = 0; i < copy.count; ++i) add(copy.rects[i]);
+    }
+  }
+
+private:
+  static int32_t growth(const DirtyRect &a, const DirtyRect &b)
+  {
+    DirtyRect u = a;
+    u.add(b);
+    return u.area() - a.area() - b.area();
+  }
+
+  uint8_t cheapestMerge(const DirtyRect &r) const
+  {
+    uint8_t best = 0;
+    for (uint8_t i = 1; i < count; ++i)
+    {
+      if (growth(rects[i], r) < growth(rects[best], r)) best = i;
+    }
+    return best;
+  }
+};
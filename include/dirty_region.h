@@ -0,0 +1,334 @@
+#pragma once
+
+#include <Adafruit_GFX.h>
+#include <stdint.h>
+#include "dirty_rect.h"
+
+// Records every primitive drawn through the GFX API as (bounding box,
+// signature); a rectangle outline as its four edges. A frame is first
+// rendered in dry-run mode, which only records; comparing it entry by entry
+// with the last committed frame yields the boxes that actually changed, i.e.
+// the windows that need a refresh. A line that only grew, shrank or slid
+// along its own row or column dirties just the pixels at its ends, so a
+// 1 px nudge of an outline dirties the two edges across the nudge.
+template <typename Base>
+class DirtyTracking : public Base
+{
+public:
+  using Base::Base;
+
+  // Start recording a frame. With dryRun set nothing reaches the buffer.
+  void beginTracking(bool dryRun)
+  {
+    _curCount = 0;
+    _overflow = false;
+    _dryRun = dryRun;
+    _tracking = true;
+  }
+
+  // Stop recording and return the region that differs from the committed
+  // frame. The whole screen is returned when there is no usable baseline.
+  DirtyRegion endTracking()
+  {
+    _tracking = false;
+    _dryRun = false;
+    DirtyRegion dirty;
+    if (!_prevValid || _overflow || _prevRotation != this->getRotation())
+    {
+      dirty.add(fullScreen());
+      return dirty;
+    }
+    const uint8_t count = _curCount > _prevCount ? _curCount : _prevCount;
+    for (uint8_t i = 0; i < count; ++i)
+    {
+      if (i >= _prevCount)
+      {
+        dirty.add(_cur[i].box);
+      }
+      else if (i >= _curCount)
+      {
+        dirty.add(_prev[i].box);
+      }
+      else if (_cur[i].sig != _prev[i].sig || _cur[i].box != _prev[i].box)
+      {
+        if (!addLineEnds(dirty, _prev[i], _cur[i]))
+        {
+          dirty.add(_cur[i].box);
+          dirty.add(_prev[i].box);
+        }
+      }
+    }
+    return dirty;
+  }
+
+  // The recorded frame is now what the panel shows.
+  void commitTracking()
+  {
+    _deferred = false;
+    if (_overflow)
+    {
+      _prevValid = false;
+      return;
+    }
+    for (uint8_t i = 0; i < _curCount; ++i) _prev[i] = _cur[i];
+    _prevCount = _curCount;
+    _prevRotation = this->getRotation();
+    _prevValid = true;
+  }
+
+  // Panel content was changed behind the tracker's back (raw commands,
+  // clearScreen); the next frame must be pushed in full.
+  void invalidateTracking()
+  {
+    _deferred = false;
+    _prevValid = false;
+  }
+
+  // The recorded frame was pushed and its refresh is still running; the
+  // outcome commits or invalidates it. No frame may be tracked meanwhile.
+  void deferCommit()
+  {
+    _deferred = true;
+  }
+
+  bool commitDeferred() const
+  {
+    return _deferred;
+  }
+
+  DirtyRect fullScreen() const
+  {
+    return DirtyRect{0, 0, static_cast<int16_t>(this->width() - 1), static_cast<int16_t>(this->height() - 1)};
+  }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override
+  {
+    Scope scope(*this, KIND_PIXEL, x, y, 1, 1, color);
+    if (scope.draw) Base::drawPixel(x, y, color);
+  }
+
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override
+  {
+    Scope scope(*this, KIND_HLINE, x, y, w, 1, color);
+    if (scope.draw) Base::drawFastHLine(x, y, w, color);
+  }
+
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override
+  {
+    Scope scope(*this, KIND_VLINE, x, y, 1, h, color);
+    if (scope.draw) Base::drawFastVLine(x, y, h, color);
+  }
+
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override
+  {
+    Scope scope(*this, KIND_FILL, x, y, w, h, color);
+    if (scope.draw) Base::fillRect(x, y, w, h, color);
+  }
+
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override
+  {
+    bool draw = true;
+    if (_tracking && _depth == 0)
+    {
+      // four edges, so moving one side leaves the others clean
+      recordShape(KIND_HLINE, x, y, w, 1, color);
+      recordShape(KIND_HLINE, x, y + h - 1, w, 1, color);
+      recordShape(KIND_VLINE, x, y, 1, h, color);
+      recordShape(KIND_VLINE, x + w - 1, y, 1, h, color);
+      draw = !_dryRun;
+    }
+    ++_depth;
+    if (draw) Base::drawRect(x, y, w, h, color);
+    --_depth;
+  }
+
+  void fillScreen(uint16_t color) override
+  {
+    Scope scope(*this, KIND_SCREEN, 0, 0, this->width(), this->height(), color);
+    if (scope.draw) Base::fillScreen(color);
+  }
+
+  size_t write(uint8_t c) override
+  {
+    if (!_tracking || _depth > 0) return Base::write(c);
+    int16_t cx = this->cursor_x;
+    int16_t cy = this->cursor_y;
+    int16_t minx = INT16_MAX;
+    int16_t miny = INT16_MAX;
+    int16_t maxx = INT16_MIN;
+    int16_t maxy = INT16_MIN;
+    this->charBounds(c, &cx, &cy, &minx, &miny, &maxx, &maxy);
+    if (minx <= maxx && miny <= maxy)
+    {
+      recordText(c, DirtyRect{minx, miny, maxx, maxy});
+    }
+    if (_dryRun)
+    {
+      this->cursor_x = cx;
+      this->cursor_y = cy;
+      return 1;
+    }
+    ++_depth;
+    const size_t n = Base::write(c);
+    --_depth;
+    return n;
+  }
+
+private:
+  enum : uint8_t
+  {
+    KIND_PIXEL = 1,
+    KIND_HLINE,
+    KIND_VLINE,
+    KIND_FILL,
+    KIND_SCREEN,
+    KIND_TEXT
+  };
+
+  struct Entry
+  {
+    DirtyRect box;
+    uint32_t sig;
+    uint16_t color;
+    uint8_t kind;
+  };
+
+  static constexpr uint8_t MAX_ENTRIES = 48;
+
+  // Records the outermost primitive only; nested calls (drawRect ->
+  // drawFastHLine -> drawPixel) just draw.
+  struct Scope
+  {
+    DirtyTracking &gfx;
+    bool draw;
+
+    Scope(DirtyTracking &g, uint8_t kind, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+      : gfx(g), draw(true)
+    {
+      if (!gfx._tracking || gfx._depth > 0)
+      {
+        ++gfx._depth;
+        return;
+      }
+      gfx.recordShape(kind, x, y, w, h, color);
+      draw = !gfx._dryRun;
+      ++gfx._depth;
+    }
+
+    ~Scope()
+    {
+      --gfx._depth;
+    }
+  };
+
+  static uint32_t mix(uint32_t hash, uint32_t value)
+  {
+    for (uint8_t i = 0; i < 4; ++i)
+    {
+      hash ^= (value >> (i * 8)) & 0xFF;
+      hash *= 16777619UL;
+    }
+    return hash;
+  }
+
+  bool clip(DirtyRect &box) const
+  {
+    if (box.x0 < 0) box.x0 = 0;
+    if (box.y0 < 0) box.y0 = 0;
+    if (box.x1 >= this->width()) box.x1 = this->width() - 1;
+    if (box.y1 >= this->height()) box.y1 = this->height() - 1;
+    return !box.empty();
+  }
+
+  void push(uint8_t kind, const DirtyRect &box, uint32_t sig, uint16_t color)
+  {
+    if (_curCount >= MAX_ENTRIES)
+    {
+      _overflow = true;
+      return;
+    }
+    _cur[_curCount++] = Entry{box, sig, color, kind};
+  }
+
+  // Two lines of one colour on the same row (or column): only the spans
+  // covered by one of them and not the other changed.
+  static bool addLineEnds(DirtyRegion &dirty, const Entry &a, const Entry &b)
+  {
+    if (a.kind != b.kind || a.color != b.color) return false;
+    if (a.kind == KIND_HLINE && a.box.y0 == b.box.y0)
+    {
+      addSpan(dirty, a.box.x0, b.box.x0, a.box.x1, b.box.x1, [&](int16_t p0, int16_t p1)
+      {
+        return DirtyRect{p0, a.box.y0, p1, a.box.y1};
+      });
+      return true;
+    }
+    if (a.kind == KIND_VLINE && a.box.x0 == b.box.x0)
+    {
+      addSpan(dirty, a.box.y0, b.box.y0, a.box.y1, b.box.y1, [&](int16_t p0, int16_t p1)
+      {
+        return DirtyRect{a.box.x0, p0, a.box.x1, p1};
+      });
+      return true;
+    }
+    return false;
+  }
+
+  // [a0, a1] and [b0, b1] along a line; adds what lies in just one of them.
+  template <typename Box>
+  static void addSpan(DirtyRegion &dirty, int16_t a0, int16_t b0, int16_t a1, int16_t b1, Box box)
+  {
+    if (a1 < b0 || b1 < a0)
+    {
+      dirty.add(box(a0, a1));
+      dirty.add(box(b0, b1));
+      return;
+    }
+    if (a0 != b0) dirty.add(box(a0 < b0 ? a0 : b0, (a0 < b0 ? b0 : a0) - 1));
+    if (a1 != b1) dirty.add(box((a1 < b1 ? a1 : b1) + 1, a1 < b1 ? b1 : a1));
+  }
+
+  void recordShape(uint8_t kind, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+  {
+    if (w <= 0 || h <= 0) return;
+    DirtyRect box{x, y, static_cast<int16_t>(x + w - 1), static_cast<int16_t>(y + h - 1)};
+    if (!clip(box)) return;
+    uint32_t sig = mix(2166136261UL, kind);
+    sig = mix(sig, (static_cast<uint32_t>(static_cast<uint16_t>(x)) << 16) | static_cast<uint16_t>(y));
+    sig = mix(sig, (static_cast<uint32_t>(static_cast<uint16_t>(w)) << 16) | static_cast<uint16_t>(h));
+    sig = mix(sig, color);
+    push(kind, box, sig, color);
+  }
+
+  // Consecutive characters on one text line are folded into a single entry.
+  void recordText(uint8_t c, DirtyRect box)
+  {
+    if (!clip(box)) return;
+    const uint32_t style = (static_cast<uint32_t>(this->textcolor) << 16) | this->textbgcolor;
+    if (_curCount > 0)
+    {
+      Entry &last = _cur[_curCount - 1];
+      if (last.kind == KIND_TEXT && last.box.y0 == box.y0 && last.box.y1 == box.y1 && box.x0 >= last.box.x0)
+      {
+        last.box.add(box);
+        last.sig = mix(mix(last.sig, c), style);
+        return;
+      }
+    }
+    uint32_t sig = mix(2166136261UL, KIND_TEXT);
+    sig = mix(sig, (static_cast<uint32_t>(static_cast<uint16_t>(box.x0)) << 16) | static_cast<uint16_t>(box.y0));
+    push(KIND_TEXT, box, mix(mix(sig, c), style), this->textcolor);
+  }
+
+  Entry _prev[MAX_ENTRIES];
+  Entry _cur[MAX_ENTRIES];
+  uint8_t _prevCount = 0;
+  uint8_t _curCount = 0;
+  uint8_t _prevRotation = 0;
+  uint8_t _depth = 0;
+  bool _prevValid = false;
+  bool _deferred = false;
+  bool _tracking = false;
+  bool _dryRun = false;
+  bool _overflow = false;
+};
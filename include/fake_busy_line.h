@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "refresh_engine.h"
+
+// Host stand-in for the panel's BUSY pin. Each command keeps BUSY asserted
+// for a configurable time on a clock that only moves via advance(), so the
+// completion and timeout paths of RefreshEngine run deterministically.
+class FakeBusyLine : public RefreshPort
+{
+public:
+  static constexpr size_t MAX_LOG = 32;
+
+  // How long BUSY stays asserted after cmd; unlisted commands use 0 ms.
+  void setBusyFor(uint8_t cmd, uint32_t ms)
+  {
+    _busyMs[cmd] = ms;
+  }
+
+  // A stuck line never releases, as with a disconnected or dead panel.
+  void setStuck(bool stuck)
+  {
+    _stuck = stuck;
+  }
+
+  void advance(uint32_t ms)
+  {
+    _now += ms;
+  }
+
+  void sendCommand(uint8_t cmd) override
+  {
+    if (_logCount < MAX_LOG) _log[_logCount++] = cmd;
+    _busyUntil = _now + _busyMs[cmd];
+  }
+
+  bool busyActive() override
+  {
+    return _stuck || _now < _busyUntil;
+  }
+
+  uint32_t nowMs() override
+  {
+    return _now;
+  }
+
+  uint32_t releaseMs() const
+  {
+    return _busyUntil;
+  }
+
+  size_t commandCount() const
+  {
+    return _logCount;
+  }
+
+  uint8_t command(size_t index) const
+  {
+    return index < _logCount ? _log[index] : 0;
+  }
+
+private:
+  uint32_t _busyMs[256] = {};
+  uint8_t _log[MAX_LOG] = {};
+  size_t _logCount = 0;
+  uint32_t _now = 0;
+  uint32_t _busyUntil = 0;
+  bool _stuck = false;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdint.h>
+
+// Glyph number of every printable ASCII character in a subset font (the
+// 'subset' string of ST7735_TFT.h's GFXfont), so drawing a character is a
+// table read instead of a search through the string. Built by the compiler
+// from the subset string; characters outside 0x20..0x7F have no entry.
+struct SubsetIndex
+{
+  static constexpr uint8_t FIRST = 0x20;
+  static constexpr uint8_t SIZE = 96;
+  static constexpr uint8_t NONE = 0xFF;
+
+  uint8_t glyph[SIZE];
+
+  // Glyph number of c, or -1 when the font lacks it.
+  constexpr int16_t operator[](uint8_t c) const
+  {
+    return (c >= FIRST && c - FIRST < SIZE && glyph[c - FIRST] != NONE) ? glyph[c - FIRST] : -1;
+  }
+};
+
+// First occurrence wins, as with strchr().
+constexpr SubsetIndex subsetIndex(const char *subset)
+{
+  SubsetIndex index{};
+  for (uint8_t i = 0; i < SubsetIndex::SIZE; ++i) index.glyph[i] = SubsetIndex::NONE;
+  for (uint16_t i = 0; subset[i] != '\0' && i < SubsetIndex::NONE; ++i)
+  {
+    const uint8_t c = static_cast<uint8_t>(subset[i]);
+    if (c < SubsetIndex::FIRST || c - SubsetIndex::FIRST >= SubsetIndex::SIZE) continue;
+    if (index.glyph[c - SubsetIndex::FIRST] == SubsetIndex::NONE)
+    {
+      index.glyph[c - SubsetIndex::FIRST] = static_cast<uint8_t>(i);
+    }
+  }
+  return index;
+}
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "panel_traits.h"
+
+// Rows y0..y1 and byte columns xb0..xb1 of a plane, inclusive.
+struct RowBand
+{
+  uint16_t y0;
+  uint16_t y1;
+  uint16_t xb0;
+  uint16_t xb1;
+
+  static RowBand none()
+  {
+    return RowBand{1, 0, 1, 0};
+  }
+
+  bool empty() const
+  {
+    return y1 < y0 || xb1 < xb0;
+  }
+
+  uint16_t rows() const
+  {
+    return empty() ? 0 : y1 - y0 + 1;
+  }
+
+  uint16_t bytes() const
+  {
+    return empty() ? 0 : xb1 - xb0 + 1;
+  }
+
+  bool operator==(const RowBand &o) const
+  {
+    return y0 == o.y0 && y1 == o.y1 && xb0 == o.xb0 && xb1 == o.xb1;
+  }
+
+  bool operator!=(const RowBand &o) const
+  {
+    return !(*this == o);
+  }
+};
+
+// The black and red planes last written to the controller, so a push only
+// sends what changed. Planes are given as rows of 'stride' bytes, word
+// aligned with stride a multiple of 4 (PlaneRaster's planes are). diff()
+// XORs the new frame against the shadow a word at a time: rows from the top
+// and from the bottom until one differs, then the words of the rows in
+// between ORed together to find the first and last changed byte column.
+// Bits past the panel width never count. Once the band is written,
+// commit() copies it into the shadow.
+template <typename PanelT>
+class FrameShadow
+{
+public:
+  static constexpr uint16_t STRIDE = (PanelT::rowBytes + 3) / 4 * 4;
+  static constexpr uint16_t WORDS = STRIDE / 4;
+
+  static constexpr RowBand all()
+  {
+    return RowBand{0, PanelT::height - 1, 0, PanelT::rowBytes - 1};
+  }
+
+  // False until reset(); the controller RAM is unknown.
+  bool valid() const
+  {
+    return _valid;
+  }
+
+  void invalidate()
+  {
+    _valid = false;
+  }
+
+  // The controller now holds these planes in full.
+  void reset(const uint8_t *black, const uint8_t *red, size_t stride)
+  {
+    commit(black, red, stride, all());
+    _valid = true;
+  }
+
+  // The band of the new planes inside 'limit' that differs from the shadow;
+  // empty when nothing does, all of 'limit' while the shadow is not valid.
+  RowBand diff(const uint8_t *black, const uint8_t *red, size_t stride, const RowBand &limit = all()) const
+  {
+    if (!_valid || limit.empty()) return limit;
+    uint32_t mask[WORDS];
+    columnMask(limit, mask);
+    const uint32_t *b = reinterpret_cast<const uint32_t *>(black);
+    const uint32_t *r = reinterpret_cast<const uint32_t *>(red);
+    const size_t words = stride / 4;
+    uint16_t y0 = limit.y0;
+    uint16_t y1 = limit.y1;
+    while (y0 <= y1 && !rowDiffers(b + y0 * words, r + y0 * words, y0, mask)) ++y0;
+    if (y0 > y1) return RowBand::none();
+    while (!rowDiffers(b + y1 * words, r + y1 * words, y1, mask)) --y1;
+    uint32_t changed[WORDS] = {};
+    for (uint16_t y = y0; y <= y1; ++y)
+    {
+      const uint32_t *nb = b + y * words;
+      const uint32_t *nr = r + y * words;
+      const uint32_t *sb = _black + y * WORDS;
+      const uint32_t *sr = _red + y * WORDS;
+      for (uint16_t w = 0; w < WORDS; ++w) changed[w] |= (nb[w] ^ sb[w]) | (nr[w] ^ sr[w]);
+    }
+    for (uint16_t w = 0; w < WORDS; ++w) changed[w] &= mask[w];
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(changed);
+    uint16_t xb0 = 0;
+    while (bytes[xb0] == 0) ++xb0;
+    uint16_t xb1 = STRIDE - 1;
+    while (bytes[xb1] == 0) --xb1;
+    return RowBand{y0, y1, xb0, xb1};
+  }
+
+  // The band of these planes was written to the controller.
+  void commit(const uint8_t *black, const uint8_t *red, size_t stride, const RowBand &band)
+  {
+    if (band.empty()) return;
+    uint8_t *sb = reinterpret_cast<uint8_t *>(_black);
+    uint8_t *sr = reinterpret_cast<uint8_t *>(_red);
+    for (uint16_t y = band.y0; y <= band.y1; ++y)
+    {
+      memcpy(sb + y * STRIDE + band.xb0, black + y * stride + band.xb0, band.bytes());
+      memcpy(sr + y * STRIDE + band.xb0, red + y * stride + band.xb0, band.bytes());
+    }
+  }
+
+private:
+  static constexpr size_t PLANE_WORDS = static_cast<size_t>(WORDS) * PanelT::height;
+
+  // Bytes xb0..xb1 of a row, less the bits past the panel width.
+  static void columnMask(const RowBand &limit, uint32_t *mask)
+  {
+    uint8_t *bytes = reinterpret_cast<uint8_t *>(mask);
+    memset(bytes, 0, STRIDE);
+    for (uint16_t xb = limit.xb0; xb <= limit.xb1 && xb < PanelT::rowBytes; ++xb) bytes[xb] = 0xFF;
+    if (PanelT::width & 7) bytes[PanelT::rowBytes - 1] &= static_cast<uint8_t>(0xFF << (8 - (PanelT::width & 7)));
+  }
+
+  bool rowDiffers(const uint32_t *nb, const uint32_t *nr, uint16_t y, const uint32_t *mask) const
+  {
+    const uint32_t *sb = _black + y * WORDS;
+    const uint32_t *sr = _red + y * WORDS;
+    for (uint16_t w = 0; w < WORDS; ++w)
+    {
+      if (((nb[w] ^ sb[w]) | (nr[w] ^ sr[w])) & mask[w]) return true;
+    }
+    return false;
+  }
+
+  uint32_t _black[PLANE_WORDS];
+  uint32_t _red[PLANE_WORDS];
+  bool _valid = false;
+};
+
+// Controller RAM windows in pixel coordinates (x0, x1 widened to whole
+// bytes), sent through any Bus with command(uint8_t) and data(const uint8_t *,
+// size_t): the raw command path of the firmware or a host model.
+
+// RAM window and both address counters at its origin.
+template <typename Bus>
+void setRamWindow(Bus &bus, Ssd16xxController, uint16_t x0, uint16_t x1, uint16_t y0, uint16_t y1)
+{
+  const uint8_t xRange[] = {static_cast<uint8_t>(x0 / 8), static_cast<uint8_t>(x1 / 8)};
+  const uint8_t yRange[] = {static_cast<uint8_t>(y0 & 0xFF), static_cast<uint8_t>(y0 >> 8),
+                            static_cast<uint8_t>(y1 & 0xFF), static_cast<uint8_t>(y1 >> 8)};
+  bus.command(Ssd16xxController::ramXRange);
+  bus.data(xRange, sizeof(xRange));
+  bus.command(Ssd16xxController::ramYRange);
+  bus.data(yRange, sizeof(yRange));
+  bus.command(Ssd16xxController::ramXCounter);
+  bus.data(xRange, 1);
+  bus.command(Ssd16xxController::ramYCounter);
+  bus.data(yRange, 2);
+}
+
+// partial in + window, as GxEPD2_213c sets up its partial RAM area
+template <typename Bus>
+void setRamWindow(Bus &bus, Uc8151Controller, uint16_t x0, uint16_t x1, uint16_t y0, uint16_t y1)
+{
+  const uint8_t area[] = {static_cast<uint8_t>(x0 & 0xF8), static_cast<uint8_t>(x1 | 0x07),
+                          static_cast<uint8_t>(y0 >> 8), static_cast<uint8_t>(y0 & 0xFF),
+                          static_cast<uint8_t>(y1 >> 8), static_cast<uint8_t>(y1 & 0xFF), 0x01};
+  bus.command(Uc8151Controller::partialIn);
+  bus.command(Uc8151Controller::partialWindow);
+  bus.data(area, sizeof(area));
+}
+
+template <typename Bus>
+void sendBandRows(Bus &bus, const RowBand &band, const uint8_t *plane, size_t stride)
+{
+  for (uint16_t y = band.y0; y <= band.y1; ++y) bus.data(plane + y * stride + band.xb0, band.bytes());
+}
+
+// Both planes of a band, already in the controller's encoding. SSD16xx
+// needs the counters back at the window origin before the second plane.
+template <typename Bus>
+void sendBand(Bus &bus, Ssd16xxController, const RowBand &band, const uint8_t *black, const uint8_t *red,
+              size_t stride)
+{
+  if (band.empty()) return;
+  const uint16_t x0 = band.xb0 * 8;
+  const uint16_t x1 = band.xb1 * 8 + 7;
+  setRamWindow(bus, Ssd16xxController(), x0, x1, band.y0, band.y1);
+  bus.command(Ssd16xxController::blackPlane);
+  sendBandRows(bus, band, black, stride);
+  setRamWindow(bus, Ssd16xxController(), x0, x1, band.y0, band.y1);
+  bus.command(Ssd16xxController::redPlane);
+  sendBandRows(bus, band, red, stride);
+}
+
+template <typename Bus>
+void sendBand(Bus &bus, Uc8151Controller, const RowBand &band, const uint8_t *black, const uint8_t *red,
+              size_t stride)
+{
+  if (band.empty()) return;
+  setRamWindow(bus, Uc8151Controller(), band.xb0 * 8, band.xb1 * 8 + 7, band.y0, band.y1);
+  bus.command(Uc8151Controller::blackPlane);
+  sendBandRows(bus, band, black, stride);
+  bus.command(Uc8151Controller::redPlane);
+  sendBandRows(bus, band, red, stride);
+  bus.command(Uc8151Controller::partialOut);
+}
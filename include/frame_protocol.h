@@ -0,0 +1,187 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Binary console frames, entered with the 'bin' command:
+//
+//   0xE5 | target | length (u16 LE) | payload[length] | CRC-32 (u32 LE)
+//
+// The CRC (IEEE, reflected, as zlib) covers target, length and payload.
+// Plane payloads are forwarded to the controller while they arrive, so a bad
+// CRC can only be reported after the bytes are already in panel RAM.
+
+static constexpr uint8_t FRAME_MAGIC = 0xE5;
+static constexpr size_t FRAME_HEADER_BYTES = 4;
+static constexpr size_t FRAME_TRAILER_BYTES = 4;
+static constexpr size_t FRAME_WINDOW_BYTES = 8;
+
+enum class FrameTarget : uint8_t
+{
+  Black = 'B',        // black plane (UC8151 0x10, SSD16xx 0x24)
+  Red = 'R',          // red plane (UC8151 0x13, SSD16xx 0x26)
+  PackedBlack = 'b',  // black plane in row_codec.h format
+  PackedRed = 'r',    // red plane in row_codec.h format
+  Window = 'W',       // RAM window: x0, x1, y0, y1 as u16 LE
+  Update = 'U',       // refresh the panel, empty payload
+  Exit = 'X'          // back to the text console, empty payload
+};
+
+// Nibble table: 64 bytes of flash, two lookups per byte.
+inline uint32_t frameCrc32Update(uint32_t crc, const uint8_t *data, size_t count)
+{
+  static const uint32_t TABLE[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+  };
+  for (size_t i = 0; i < count; ++i)
+  {
+    crc ^= data[i];
+    crc = (crc >> 4) ^ TABLE[crc & 0x0F];
+    crc = (crc >> 4) ^ TABLE[crc & 0x0F];
+  }
+  return crc;
+}
+
+inline uint32_t frameCrc32(const uint8_t *data, size_t count)
+{
+  return ~frameCrc32Update(0xFFFFFFFFUL, data, count);
+}
+
+inline void frameEncodeHeader(uint8_t *out, FrameTarget target, uint16_t length)
+{
+  out[0] = FRAME_MAGIC;
+  out[1] = static_cast<uint8_t>(target);
+  out[2] = static_cast<uint8_t>(length & 0xFF);
+  out[3] = static_cast<uint8_t>(length >> 8);
+}
+
+// CRC over header bytes 1..3 and the payload, ready for the trailer.
+inline void frameEncodeTrailer(uint8_t *out, const uint8_t *header, const uint8_t *payload, uint16_t length)
+{
+  uint32_t crc = frameCrc32Update(0xFFFFFFFFUL, header + 1, FRAME_HEADER_BYTES - 1);
+  crc = ~frameCrc32Update(crc, payload, length);
+  for (size_t i = 0; i < FRAME_TRAILER_BYTES; ++i)
+  {
+    out[i] = static_cast<uint8_t>(crc >> (8 * i));
+  }
+}
+
+struct FrameEvent
+{
+  enum class Kind : uint8_t
+  {
+    None,
+    Begin,  // header parsed: target, length
+    Data,   // payload slice: data, size (points into the fed buffer)
+    End     // trailer parsed: crcOk
+  };
+
+  Kind kind;
+  uint8_t target;
+  uint16_t length;
+  const uint8_t *data;
+  size_t size;
+  bool crcOk;
+};
+
+// Byte-stream parser that never copies payload bytes. Bytes before a magic
+// byte are skipped, which also resynchronises after garbage.
+class FrameDecoder
+{
+public:
+  void reset()
+  {
+    _state = State::Magic;
+  }
+
+  // Consumes input up to and including the next event and returns how many
+  // bytes were used; event.kind is None when the input ran out first.
+  size_t feed(const uint8_t *input, size_t count, FrameEvent &event)
+  {
+    event.kind = FrameEvent::Kind::None;
+    size_t used = 0;
+    while (used < count)
+    {
+      const uint8_t b = input[used];
+      switch (_state)
+      {
+        case State::Magic:
+          ++used;
+          if (b == FRAME_MAGIC)
+          {
+            _crc = 0xFFFFFFFFUL;
+            _state = State::Target;
+          }
+          break;
+        case State::Target:
+          ++used;
+          _crc = frameCrc32Update(_crc, &b, 1);
+          _target = b;
+          _state = State::LengthLow;
+          break;
+        case State::LengthLow:
+          ++used;
+          _crc = frameCrc32Update(_crc, &b, 1);
+          _length = b;
+          _state = State::LengthHigh;
+          break;
+        case State::LengthHigh:
+          ++used;
+          _crc = frameCrc32Update(_crc, &b, 1);
+          _length = static_cast<uint16_t>(_length | (b << 8));
+          _remaining = _length;
+          _received = 0;
+          _trailerBytes = 0;
+          _state = _length > 0 ? State::Payload : State::Trailer;
+          event.kind = FrameEvent::Kind::Begin;
+          event.target = _target;
+          event.length = _length;
+          return used;
+        case State::Payload:
+        {
+          const size_t n = (count - used) < _remaining ? (count - used) : _remaining;
+          _crc = frameCrc32Update(_crc, input + used, n);
+          _remaining -= n;
+          if (_remaining == 0) _state = State::Trailer;
+          event.kind = FrameEvent::Kind::Data;
+          event.target = _target;
+          event.length = _length;
+          event.data = input + used;
+          event.size = n;
+          return used + n;
+        }
+        case State::Trailer:
+          ++used;
+          _received |= static_cast<uint32_t>(b) << (8 * _trailerBytes);
+          if (++_trailerBytes < FRAME_TRAILER_BYTES) break;
+          _state = State::Magic;
+          event.kind = FrameEvent::Kind::End;
+          event.target = _target;
+          event.length = _length;
+          event.crcOk = ~_crc == _received;
+          return used;
+      }
+    }
+    return used;
+  }
+
+private:
+  enum class State : uint8_t
+  {
+    Magic,
+    Target,
+    LengthLow,
+    LengthHigh,
+    Payload,
+    Trailer
+  };
+
+  State _state = State::Magic;
+  uint8_t _target = 0;
+  uint16_t _length = 0;
+  size_t _remaining = 0;
+  uint32_t _crc = 0;
+  uint32_t _received = 0;
+  uint8_t _trailerBytes = 0;
+};
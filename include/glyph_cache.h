@@ -0,0 +1,479 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "font_index.h"
+#include "glyph_codec.h"
+#include "plane_raster.h"
+
+// One glyph as its font stores it, in logical orientation.
+struct GlyphSource
+{
+  enum : uint8_t
+  {
+    BITSTREAM,  // GFXglyph bitstream: row-major, rows not padded, MSB first
+    COLUMNS,    // classic 5x8 layout: one byte per column, LSB on top
+    RUNS        // PackedFont runs (glyph_codec.h), read in order only
+  };
+
+  const uint8_t *bits;
+  uint8_t width;
+  uint8_t height;
+  int8_t xOffset;  // cursor to the top-left corner
+  int8_t yOffset;
+  uint8_t xAdvance;
+  uint8_t layout;
+  const PackedFont *packed;  // RUNS: the font with the run codes
+
+  // BITSTREAM and COLUMNS only.
+  bool pixel(uint8_t x, uint8_t y) const
+  {
+    if (layout == COLUMNS) return (bits[x] >> y) & 1;
+    const uint16_t i = static_cast<uint16_t>(y) * width + x;
+    return bits[i >> 3] & (0x80 >> (i & 7));
+  }
+};
+
+// A font the glyph cache can draw: the classic 5x8 column font, as a
+// table (Font[] in TextFonts.h) or one glyph at a time as Adafruit_GFX
+// draws it (PlaneDisplay), a GFXfont, Adafruit's
+// or the ST7735_TFT.h one with its 'subset' string, or a PackedFont;
+// subset fonts are looked up through their SubsetIndex when they come
+// with one. Only pointers are kept
+// and the font is read in place; the RP2040 and the host have one address
+// space, so no pgm_read_*.
+class GlyphFace
+{
+public:
+  GlyphFace() = default;
+
+  // 'count' glyphs of 5 column bytes starting at character 'first'.
+  static GlyphFace columns(const uint8_t *font, uint8_t first, uint16_t count)
+  {
+    GlyphFace face;
+    face._font = font;
+    face._first = first;
+    face._count = count;
+    face._lookup = &columnGlyph;
+    return face;
+  }
+
+  // The 5x8 font one glyph at a time: every character reads the same 5
+  // column bytes, which the caller fills before the glyph is rendered.
+  static GlyphFace column(const uint8_t *columns)
+  {
+    GlyphFace face;
+    face._font = columns;
+    face._lookup = &sameColumns;
+    return face;
+  }
+
+  template <typename FontT>
+  static GlyphFace gfx(const FontT &font)
+  {
+    GlyphFace face;
+    face._font = &font;
+    face._lookup = &gfxGlyph<FontT>;
+    return face;
+  }
+
+  template <typename FontT>
+  static GlyphFace gfx(const FontT &font, const SubsetIndex &index)
+  {
+    GlyphFace face = gfx(font);
+    face._index = &index;
+    return face;
+  }
+
+  static GlyphFace packed(const PackedFont &font)
+  {
+    GlyphFace face;
+    face._font = &font;
+    face._lookup = &packedGlyph;
+    return face;
+  }
+
+  static GlyphFace packed(const PackedFont &font, const SubsetIndex &index)
+  {
+    GlyphFace face = packed(font);
+    face._index = &index;
+    return face;
+  }
+
+  bool valid() const
+  {
+    return _lookup != nullptr;
+  }
+
+  const void *font() const
+  {
+    return _font;
+  }
+
+  bool glyph(uint8_t c, GlyphSource &out) const
+  {
+    return _lookup != nullptr && _lookup(*this, c, out);
+  }
+
+  // Bytes of the largest strip any glyph needs, in any rotation and phase.
+  uint16_t maxStripBytes() const
+  {
+    uint16_t most = 0;
+    for (uint16_t c = 0; c < 256; ++c)
+    {
+      GlyphSource g;
+      if (!glyph(static_cast<uint8_t>(c), g)) continue;
+      const uint16_t across = (7 + g.width + 7) / 8 * g.height;
+      const uint16_t down = (7 + g.height + 7) / 8 * g.width;
+      if (across > most) most = across;
+      if (down > most) most = down;
+    }
+    return most;
+  }
+
+private:
+  using Lookup = bool (*)(const GlyphFace &, uint8_t, GlyphSource &);
+
+  static bool sameColumns(const GlyphFace &face, uint8_t, GlyphSource &out)
+  {
+    out = GlyphSource{static_cast<const uint8_t *>(face._font), 5, 8, 0, 0, 6, GlyphSource::COLUMNS, nullptr};
+    return true;
+  }
+
+  static bool columnGlyph(const GlyphFace &face, uint8_t c, GlyphSource &out)
+  {
+    if (c < face._first || c - face._first >= face._count) return false;
+    const uint8_t *bits = static_cast<const uint8_t *>(face._font) + (c - face._first) * 5;
+    out = GlyphSource{bits, 5, 8, 0, 0, 6, GlyphSource::COLUMNS, nullptr};
+    return true;
+  }
+
+  // Without a SubsetIndex, subset fonts search their 'subset' string; a
+  // font of that type without one is contiguous from 'first'.
+  template <typename FontT>
+  static auto glyphIndex(const FontT &font, uint8_t c, int) -> decltype(font.subset, int16_t())
+  {
+    if (font.subset == nullptr) return glyphIndex(font, c, 0L);
+    const char *hit = c ? strchr(font.subset, c) : nullptr;
+    return hit ? static_cast<int16_t>(hit - font.subset) : -1;
+  }
+
+  template <typename FontT>
+  static int16_t glyphIndex(const FontT &font, uint8_t c, long)
+  {
+    return (c >= font.first && c <= font.last) ? static_cast<int16_t>(c - font.first) : -1;
+  }
+
+  template <typename FontT>
+  static bool gfxGlyph(const GlyphFace &face, uint8_t c, GlyphSource &out)
+  {
+    const FontT &font = *static_cast<const FontT *>(face._font);
+    const int16_t index = face._index ? (*face._index)[c] : glyphIndex(font, c, 0);
+    if (index < 0) return false;
+    const auto &g = font.glyph[index];
+    out = GlyphSource{font.bitmap + g.bitmapOffset, g.width, g.height, g.xOffset, g.yOffset, g.xAdvance,
+                      GlyphSource::BITSTREAM, nullptr};
+    return true;
+  }
+
+  static bool packedGlyph(const GlyphFace &face, uint8_t c, GlyphSource &out)
+  {
+    const PackedFont &font = *static_cast<const PackedFont *>(face._font);
+    const int16_t index = face._index ? (*face._index)[c] : glyphIndex(font, c, 0);
+    if (index < 0) return false;
+    const PackedGlyph &g = font.glyph[index];
+    out = GlyphSource{font.bitmap + g.bitmapOffset, g.width, g.height, g.xOffset, g.yOffset, g.xAdvance,
+                      GlyphSource::RUNS, &font};
+    return true;
+  }
+
+  const void *_font = nullptr;
+  const SubsetIndex *_index = nullptr;
+  uint16_t _count = 0;
+  uint8_t _first = 0;
+  Lookup _lookup = nullptr;
+};
+
+// The glyph as a logical 1bpp bitmap, MSB first with rows padded to a
+// byte, as PlaneRaster::blit() takes it. False when that needs more than
+// 'capacity' bytes.
+inline bool unpackGlyph(const GlyphSource &glyph, uint8_t *bitmap, size_t capacity)
+{
+  const uint16_t stride = (glyph.width + 7) / 8;
+  const size_t bytes = static_cast<size_t>(stride) * glyph.height;
+  if (bytes > capacity) return false;
+  memset(bitmap, 0, bytes);
+  if (glyph.layout == GlyphSource::RUNS)
+  {
+    RunDecoder runs(*glyph.packed, glyph.bits, static_cast<uint32_t>(glyph.width) * glyph.height);
+    for (uint8_t y = 0; y < glyph.height; ++y)
+    {
+      for (uint8_t x = 0; x < glyph.width; ++x)
+      {
+        if (runs.next()) bitmap[y * stride + (x >> 3)] |= static_cast<uint8_t>(0x80 >> (x & 7));
+      }
+    }
+    return true;
+  }
+  for (uint8_t y = 0; y < glyph.height; ++y)
+  {
+    for (uint8_t x = 0; x < glyph.width; ++x)
+    {
+      if (glyph.pixel(x, y)) bitmap[y * stride + (x >> 3)] |= static_cast<uint8_t>(0x80 >> (x & 7));
+    }
+  }
+  return true;
+}
+
+// Glyphs pre-rendered in panel orientation, one strip per (character,
+// rotation, x phase): whole-byte rows already shifted to the phase, so a
+// glyph lands with one AND/OR per byte (PlaneRaster::mergeStrip) instead of
+// a drawPixel per set bit. Slots are sized for the largest glyph of the
+// bound face, BudgetBytes holds as many as fit and the least recently used
+// one is refilled on a miss. One face at a time; binding another flushes.
+template <typename PanelT, size_t BudgetBytes>
+class GlyphCache
+{
+public:
+  struct Stats
+  {
+    uint32_t hits;
+    uint32_t misses;
+    uint16_t slots;
+    uint16_t slotBytes;
+  };
+
+  void bind(const GlyphFace &face)
+  {
+    if (face.font() == _face.font() && _slots > 0) return;
+    _face = face;
+    const uint16_t bytes = (HEADER_BYTES + face.maxStripBytes() + 3) / 4 * 4;
+    const size_t fit = bytes > HEADER_BYTES ? BudgetBytes / bytes : 0;
+    _slotBytes = bytes;
+    _slots = static_cast<uint16_t>(fit < MAX_SLOTS ? fit : MAX_SLOTS);
+    flush();
+  }
+
+  const GlyphFace &face() const
+  {
+    return _face;
+  }
+
+  void flush()
+  {
+    for (uint16_t i = 0; i < _slots; ++i) header(i).key = EMPTY;
+    memset(_hint, NO_SLOT, sizeof(_hint));
+    _clock = 0;
+    _hits = 0;
+    _misses = 0;
+  }
+
+  Stats stats() const
+  {
+    return Stats{_hits, _misses, _slots, _slotBytes};
+  }
+
+  // Draws 'glyph' (character c of the bound face) with the cursor at
+  // logical (x, y) into a PlaneRaster of PanelT, full frame or page. False
+  // when no slot can hold it; the caller draws it another way.
+  template <typename Raster>
+  bool draw(Raster &raster, uint8_t rotation, uint8_t c, const GlyphSource &glyph, int16_t x, int16_t y,
+            PlaneInk ink)
+  {
+    return draw(raster, rotation, c, glyph, x, y, ink, []() {});
+  }
+
+  // The same, for a glyph whose bits are only valid after load() ran;
+  // load() is called when a slot is filled, not on a hit.
+  template <typename Raster, typename Load>
+  bool draw(Raster &raster, uint8_t rotation, uint8_t c, const GlyphSource &glyph, int16_t x, int16_t y,
+            PlaneInk ink, Load load)
+  {
+    if (glyph.width == 0 || glyph.height == 0) return true;
+    if (_slots == 0) return false;
+    int16_t px = x + glyph.xOffset, py = y + glyph.yOffset, pw = glyph.width, ph = glyph.height;
+    switch (rotation & 3)
+    {
+      case 1:
+        RotationMap<1, PanelT::width, PanelT::height>::rect(px, py, pw, ph);
+        break;
+      case 2:
+        RotationMap<2, PanelT::width, PanelT::height>::rect(px, py, pw, ph);
+        break;
+      case 3:
+        RotationMap<3, PanelT::width, PanelT::height>::rect(px, py, pw, ph);
+        break;
+    }
+    const int16_t xb = px >= 0 ? px / 8 : -((7 - px) / 8);
+    const uint8_t phase = static_cast<uint8_t>(px - xb * 8);
+    const uint16_t key = static_cast<uint16_t>(c << 5 | (rotation & 3) << 3 | phase);
+    const uint16_t slot = find(key, glyph, rotation & 3, phase, load);
+    if (slot == NO_SLOT) return false;
+    const SlotHeader &h = header(slot);
+    raster.mergeStrip(xb, py + h.top, bits(slot), h.rowBytes, h.rows, ink);
+    return true;
+  }
+
+private:
+  struct SlotHeader
+  {
+    uint16_t stamp;
+    uint16_t key;
+    uint8_t rowBytes;
+    uint8_t rows;
+    uint8_t top;  // blank rows above the strip
+    uint8_t reserved;
+  };
+
+  static constexpr uint16_t HEADER_BYTES = sizeof(SlotHeader);
+  static constexpr uint16_t MAX_SLOTS = 255;
+  static constexpr uint8_t NO_SLOT = 0xFF;
+  static constexpr uint16_t EMPTY = 0xFFFF;
+
+  SlotHeader &header(uint16_t slot)
+  {
+    return *reinterpret_cast<SlotHeader *>(_arena + static_cast<size_t>(slot) * _slotBytes / 4);
+  }
+
+  uint8_t *bits(uint16_t slot)
+  {
+    return reinterpret_cast<uint8_t *>(_arena + static_cast<size_t>(slot) * _slotBytes / 4) + HEADER_BYTES;
+  }
+
+  static uint8_t hash(uint16_t key)
+  {
+    return static_cast<uint8_t>((static_cast<uint32_t>(key) * 40503UL) >> 8);
+  }
+
+  template <typename Load>
+  uint16_t find(uint16_t key, const GlyphSource &glyph, uint8_t rotation, uint8_t phase, Load &load)
+  {
+    const uint8_t h = hash(key);
+    uint16_t slot = _hint[h];
+    if (slot == NO_SLOT || header(slot).key != key)
+    {
+      slot = NO_SLOT;
+      for (uint16_t i = 0; i < _slots; ++i)
+      {
+        if (header(i).key == key)
+        {
+          slot = i;
+          break;
+        }
+      }
+    }
+    if (slot == NO_SLOT)
+    {
+      slot = victim();
+      load();
+      if (!fill(slot, key, glyph, rotation, phase)) return NO_SLOT;
+      ++_misses;
+    }
+    else
+    {
+      ++_hits;
+    }
+    _hint[h] = static_cast<uint8_t>(slot);
+    if (++_clock == 0)
+    {
+      // stamps are 16 bits; on wrap everything becomes equally old
+      for (uint16_t i = 0; i < _slots; ++i) header(i).stamp = 0;
+      _clock = 1;
+    }
+    header(slot).stamp = _clock;
+    return slot;
+  }
+
+  uint16_t victim()
+  {
+    uint16_t oldest = 0;
+    uint16_t age = 0;
+    for (uint16_t i = 0; i < _slots; ++i)
+    {
+      const SlotHeader &h = header(i);
+      if (h.key == EMPTY) return i;
+      if (static_cast<uint16_t>(_clock - h.stamp) >= age)
+      {
+        age = _clock - h.stamp;
+        oldest = i;
+      }
+    }
+    return oldest;
+  }
+
+  // Renders the glyph turned to panel orientation and shifted by 'phase',
+  // then drops blank rows at the top and bottom. Packed glyphs are decoded
+  // here, once per slot, so drawing from the cache costs the same for them.
+  bool fill(uint16_t slot, uint16_t key, const GlyphSource &glyph, uint8_t rotation, uint8_t phase)
+  {
+    const uint8_t pw = (rotation & 1) ? glyph.height : glyph.width;
+    const uint8_t ph = (rotation & 1) ? glyph.width : glyph.height;
+    const uint8_t rowBytes = (phase + pw + 7) / 8;
+    if (static_cast<uint16_t>(rowBytes) * ph + HEADER_BYTES > _slotBytes) return false;
+    SlotHeader &h = header(slot);
+    uint8_t *out = bits(slot);
+    memset(out, 0, static_cast<size_t>(rowBytes) * ph);
+    uint8_t first = ph, last = 0;
+    if (glyph.layout == GlyphSource::RUNS)
+    {
+      RunDecoder runs(*glyph.packed, glyph.bits, static_cast<uint32_t>(glyph.width) * glyph.height);
+      render(out, rowBytes, glyph, rotation, phase, first, last, [&](uint8_t, uint8_t) { return runs.next(); });
+    }
+    else
+    {
+      render(out, rowBytes, glyph, rotation, phase, first, last,
+             [&](uint8_t x, uint8_t y) { return glyph.pixel(x, y); });
+    }
+    h.key = key;
+    h.rowBytes = rowBytes;
+    h.top = first < ph ? first : 0;
+    h.rows = first < ph ? last - first + 1 : 0;
+    if (h.top > 0) memmove(out, out + h.top * rowBytes, static_cast<size_t>(h.rows) * rowBytes);
+    return true;
+  }
+
+  // Visits the glyph's pixels in bitstream order, which is the only order
+  // a RunDecoder can give them in.
+  template <typename PixelFn>
+  static void render(uint8_t *out, uint8_t rowBytes, const GlyphSource &glyph, uint8_t rotation, uint8_t phase,
+                     uint8_t &first, uint8_t &last, PixelFn pixel)
+  {
+    for (uint8_t gy = 0; gy < glyph.height; ++gy)
+    {
+      for (uint8_t gx = 0; gx < glyph.width; ++gx)
+      {
+        if (!pixel(gx, gy)) continue;
+        uint8_t u = gx, v = gy;
+        switch (rotation)
+        {
+          case 1:
+            u = glyph.height - 1 - gy;
+            v = gx;
+            break;
+          case 2:
+            u = glyph.width - 1 - gx;
+            v = glyph.height - 1 - gy;
+            break;
+          case 3:
+            u = gy;
+            v = glyph.width - 1 - gx;
+            break;
+        }
+        const uint16_t bit = phase + u;
+        out[v * rowBytes + (bit >> 3)] |= 0x80 >> (bit & 7);
+        if (v < first) first = v;
+        if (v > last) last = v;
+      }
+    }
+  }
+
+  uint32_t _arena[(BudgetBytes + 3) / 4];
+  uint8_t _hint[256];
+  GlyphFace _face;
+  uint16_t _clock = 0;
+  uint32_t _hits = 0;
+  uint32_t _misses = 0;
+  uint16_t _slots = 0;
+  uint16_t _slotBytes = 0;
+};
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Packed glyph bitmaps, written by tools/epd_fontpack.cpp from GFXfont
+// headers. A glyph is its GFXglyph bitstream (row-major, MSB first) as
+// alternating runs, white first, each run coded with the font's canonical
+// Huffman code for that colour. Symbols below RUN_ESCAPE are run lengths,
+// RUN_ESCAPE adds RUN_ESCAPE to the next symbol of the same run. Only the
+// first white run can be empty, so an empty white run after it ends the
+// glyph (the rest is white). Every glyph starts on a byte.
+
+static constexpr uint8_t RUN_CODE_BITS = 12;  // longest code
+static constexpr uint8_t RUN_SYMBOLS = 16;
+static constexpr uint8_t RUN_ESCAPE = RUN_SYMBOLS - 1;
+
+// Canonical Huffman code: how many codes of each length, and the symbols
+// in code order.
+struct RunCode
+{
+  uint8_t counts[RUN_CODE_BITS + 1];
+  uint8_t symbols[RUN_SYMBOLS];
+};
+
+struct PackedGlyph
+{
+  uint16_t bitmapOffset;
+  uint8_t width;
+  uint8_t height;
+  uint8_t xAdvance;
+  int8_t xOffset;
+  int8_t yOffset;
+};
+
+struct PackedFont
+{
+  const uint8_t *bitmap;
+  const PackedGlyph *glyph;
+  uint16_t first;
+  uint16_t last;
+  uint8_t yAdvance;
+  const char *subset;  // as in ST7735_TFT.h's GFXfont; nullptr when contiguous
+  RunCode white;
+  RunCode black;
+};
+
+// Pixels of one packed glyph in bitstream order, decoded a run at a time.
+class RunDecoder
+{
+public:
+  RunDecoder(const PackedFont &font, const uint8_t *in, uint32_t pixels)
+    : _font(font),
+      _in(in),
+      _left(pixels)
+  {
+  }
+
+  RunDecoder(const PackedFont &font, const PackedGlyph &glyph)
+    : RunDecoder(font, font.bitmap + glyph.bitmapOffset, static_cast<uint32_t>(glyph.width) * glyph.height)
+  {
+  }
+
+  bool next()
+  {
+    if (_left == 0) return false;
+    --_left;
+    if (_tail) return false;
+    while (_run == 0)
+    {
+      _ink = !_ink;
+      _run = length(_ink ? _font.black : _font.white);
+      if (!_ink && _run == 0 && !_first)
+      {
+        _tail = true;
+        return false;
+      }
+      _first = false;
+    }
+    --_run;
+    return _ink;
+  }
+
+private:
+  uint8_t bit()
+  {
+    if (_bits == 0)
+    {
+      _byte = *_in++;
+      _bits = 8;
+    }
+    --_bits;
+    return (_byte >> _bits) & 1;
+  }
+
+  uint8_t symbol(const RunCode &code)
+  {
+    int16_t value = 0, first = 0, index = 0;
+    for (uint8_t len = 1; len <= RUN_CODE_BITS; ++len)
+    {
+      value |= bit();
+      const int16_t count = code.counts[len];
+      if (value - first < count) return code.symbols[index + value - first];
+      index += count;
+      first = (first + count) << 1;
+      value <<= 1;
+    }
+    return 0;  // not a code: ends the run, and soon the glyph
+  }
+
+  uint32_t length(const RunCode &code)
+  {
+    uint32_t run = 0;
+    uint8_t s;
+    while ((s = symbol(code)) == RUN_ESCAPE) run += RUN_ESCAPE;
+    return run + s;
+  }
+
+  const PackedFont &_font;
+  const uint8_t *_in;
+  uint32_t _left;
+  uint32_t _run = 0;
+  uint8_t _byte = 0;
+  uint8_t _bits = 0;
+  bool _ink = true;  // the first run read is white
+  bool _first = true;
+  bool _tail = false;
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "refresh_engine.h"
+
+// Compile-time descriptions of the controllers and panels the firmware and
+// the host tools drive. Code that talks to a panel is templated on these, so
+// a new panel is a new PanelTraits alias and every size below is a constant.
+
+enum class ControllerFamily : uint8_t
+{
+  Uc8151,
+  Ssd16xx
+};
+
+// UC8151 / IL0373: GxEPD2_213c and the 2.15" GDEW0215T11 of the lib.
+struct Uc8151Controller
+{
+  static constexpr ControllerFamily family = ControllerFamily::Uc8151;
+  static constexpr uint8_t blackPlane = 0x10;
+  static constexpr uint8_t redPlane = 0x13;
+  static constexpr uint8_t partialWindow = 0x90;
+  static constexpr uint8_t partialIn = 0x91;
+  static constexpr uint8_t partialOut = 0x92;
+  static constexpr uint8_t powerOn = 0x04;
+  static constexpr uint8_t displayRefresh = 0x12;
+  static constexpr uint8_t powerOff = 0x02;
+
+  static constexpr RefreshOpcodes refreshOpcodes()
+  {
+    return {powerOn, displayRefresh, powerOff};
+  }
+};
+
+// SSD16xx: RAM window and address counters, refresh through the update
+// control sequence and master activation.
+struct Ssd16xxController
+{
+  static constexpr ControllerFamily family = ControllerFamily::Ssd16xx;
+  static constexpr uint8_t blackPlane = 0x24;
+  static constexpr uint8_t redPlane = 0x26;
+  static constexpr uint8_t ramXRange = 0x44;
+  static constexpr uint8_t ramYRange = 0x45;
+  static constexpr uint8_t ramXCounter = 0x4E;
+  static constexpr uint8_t ramYCounter = 0x4F;
+  static constexpr uint8_t updateControl = 0x22;
+  static constexpr uint8_t updateFull = 0xF7;
+  static constexpr uint8_t masterActivation = 0x20;
+};
+
+// Geometry in the controller's native orientation, 1 bit per pixel with
+// rows padded to a byte. FastPartial is set for panels whose window refresh
+// runs a short partial waveform; the tri-colour panels below run the full
+// waveform for any window, so a partial push there saves only bus bytes.
+template <typename ControllerT, uint16_t Width, uint16_t Height, bool FastPartial = false>
+struct PanelTraits
+{
+  using Controller = ControllerT;
+  static constexpr uint16_t width = Width;
+  static constexpr uint16_t height = Height;
+  static constexpr bool fastPartialRefresh = FastPartial;
+  static constexpr uint16_t rowBytes = (Width + 7) / 8;
+  static constexpr size_t planeBytes = static_cast<size_t>(rowBytes) * Height;
+  // Longest row in any rotation, for row-sized scratch buffers.
+  static constexpr uint16_t maxRowBytes = ((Width > Height ? Width : Height) + 7) / 8;
+
+  static constexpr uint16_t widthFor(uint8_t rotation)
+  {
+    return (rotation & 1) ? Height : Width;
+  }
+
+  static constexpr uint16_t heightFor(uint8_t rotation)
+  {
+    return (rotation & 1) ? Width : Height;
+  }
+};
+
+// GxEPD2_213c, the panel the firmware drives
+using Panel213c = PanelTraits<Uc8151Controller, 104, 212>;
+// lib/pio_ws2812_E-ink/epd.h (EPD_WIDTH x EPD_HEIGHT)
+using Panel215 = PanelTraits<Uc8151Controller, 112, 208>;
+// 2.13" SSD1680 tri-colour, 250x122 in landscape
+using Panel213Ssd = PanelTraits<Ssd16xxController, 122, 250>;
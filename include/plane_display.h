@@ -0,0 +1,406 @@
+#pragma once
+
+#include <Adafruit_GFX.h>
+#include "glyph_cache.h"
+#include "plane_raster.h"
+
+// Drop-in for the part of GxEPD2_3C the firmware uses (init, full/partial
+// window, firstPage/nextPage, public epd2), drawing into a PlaneRaster
+// instead of GxEPD2's private page buffers. The GFX primitives that
+// matter for the diagnostics frame go straight to the raster kernels, and
+// drawBitmap() without a background to PlaneRaster::blit(); the rest of
+// Adafruit_GFX (circles, scaled text) ends in drawPixel() or fillRect() as
+// usual. Text at size 1 comes from a GlyphCache of GlyphBudget bytes as
+// pre-shifted byte strips, for any GFXfont, for PackedFonts
+// (setPackedFont()) and for the built-in 5x8 font, whose glyphs are read
+// from Adafruit_GFX's own table through drawChar() when a slot is filled;
+// a glyph that gets no slot is unpacked and blitted.
+//
+// With PageRows at the panel height (the default) the raster holds the full
+// frame and there is one page; a partial window only limits what
+// nextPage() sends, through writeImagePart(). Below it there are two page
+// rasters of PageRows physical rows, and the firstPage()/nextPage() loop
+// draws the frame once per page as with GxEPD2_3C's paged buffer. A driver
+// with writeImagePartAsync()/finishImagePart() gets each page handed over
+// and clocks it out while the next page is drawn into the other raster;
+// any other driver writes it in place.
+// Every call picks the raster's kernel for the rotation with one switch
+// (PlaneRaster's rotation overloads); the pixel loops inside carry none.
+template <typename Driver, typename PanelT, size_t GlyphBudget = 2048, uint16_t PageRows = PanelT::height>
+class PlaneDisplay : public Adafruit_GFX
+{
+public:
+  using Raster = PlaneRaster<PanelT, PageRows>;
+  using Glyphs = GlyphCache<PanelT, GlyphBudget>;
+  static constexpr uint8_t PAGE_BUFFERS = Raster::PAGED ? 2 : 1;
+
+  Driver epd2;
+
+  explicit PlaneDisplay(Driver driver) : Adafruit_GFX(PanelT::width, PanelT::height), epd2(driver)
+  {
+    _raster->fill(planeInk(0xFFFF));
+  }
+
+  void init(uint32_t serial_diag_bitrate, bool initial, uint16_t reset_duration = 10, bool pulldown_rst_mode = false)
+  {
+    epd2.init(serial_diag_bitrate, initial, reset_duration, pulldown_rst_mode);
+    setFullWindow();
+  }
+
+  void setFullWindow()
+  {
+    _partial = false;
+    _pwX = 0;
+    _pwY = 0;
+    _pwW = PanelT::width;
+    _pwH = PanelT::height;
+  }
+
+  // Same rounding as GxEPD2_3C: mapped to physical coordinates, then x and
+  // w widened to whole bytes.
+  void setPartialWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+  {
+    x = x < width() ? x : width();
+    y = y < height() ? y : height();
+    w = w < width() - x ? w : width() - x;
+    h = h < height() - y ? h : height() - y;
+    switch (getRotation())
+    {
+      case 1:
+        _pwX = PanelT::width - y - h;
+        _pwY = x;
+        _pwW = h;
+        _pwH = w;
+        break;
+      case 2:
+        _pwX = PanelT::width - x - w;
+        _pwY = PanelT::height - y - h;
+        _pwW = w;
+        _pwH = h;
+        break;
+      case 3:
+        _pwX = y;
+        _pwY = PanelT::height - x - w;
+        _pwW = h;
+        _pwH = w;
+        break;
+      default:
+        _pwX = x;
+        _pwY = y;
+        _pwW = w;
+        _pwH = h;
+        break;
+    }
+    _pwW += _pwX % 8;
+    if (_pwW % 8 > 0) _pwW += 8 - _pwW % 8;
+    _pwX -= _pwX % 8;
+    _partial = true;
+  }
+
+  // Pages start at the window's first row.
+  void firstPage()
+  {
+    _pageY = _pwY;
+    _raster->setPage(_pwY);
+    fillScreen(0xFFFF);
+  }
+
+  // Sends the page's rows of the window; after the last one, refreshes the
+  // window and returns false.
+  bool nextPage()
+  {
+    const uint16_t end = _pwY + _pwH;
+    const uint16_t pageEnd = _raster->top() + Raster::ROWS;
+    const uint16_t rows = (pageEnd < end ? pageEnd : end) - _pageY;
+    if (Raster::PAGED)
+    {
+      writePage(epd2, *_raster, _pwX, _pageY, _pwW, rows, 0);
+    }
+    else
+    {
+      epd2.writeImagePart(_raster->black(), _raster->red(), _pwX, _pageY, Raster::BITMAP_WIDTH, Raster::ROWS,
+                          _pwX, _pageY, _pwW, rows);
+    }
+    _pageY += rows;
+    if (_pageY < end)
+    {
+      // the driver is done with the other raster once it took this one
+      _raster = _raster == &_pages[0] ? &_pages[PAGE_BUFFERS - 1] : &_pages[0];
+      _raster->setPage(_pageY);
+      _raster->fill(planeInk(0xFFFF));
+      return true;
+    }
+    finishPages(epd2, 0);
+    if (_partial) epd2.refresh(_pwX, _pwY, _pwW, _pwH);
+    else epd2.refresh(false);
+    return false;
+  }
+
+  // The raster being drawn: the whole frame, or in paged mode the current page.
+  const Raster &raster() const
+  {
+    return *_raster;
+  }
+
+  // Text in a PackedFont (glyph_codec.h) instead of the GFXfont or the 5x8
+  // font until called with nullptr. Glyphs are decoded as the cache fills
+  // their slots; text size is ignored, packed glyphs are drawn at size 1.
+  void setPackedFont(const PackedFont *font, const SubsetIndex *index = nullptr)
+  {
+    _packedFont = font;
+    _packed = !font ? GlyphFace() : index ? GlyphFace::packed(*font, *index) : GlyphFace::packed(*font);
+  }
+
+  const Glyphs &glyphs() const
+  {
+    return _glyphs;
+  }
+
+  using Adafruit_GFX::write;
+
+  // Adafruit_GFX::write() with the glyph drawn from the cache; cursor
+  // advance and wrapping are the library's.
+  size_t write(uint8_t c) override
+  {
+    if (_packedFont) return writePacked(c);
+    if (c == '\n' || c == '\r' || textsize_x != 1 || textsize_y != 1) return Adafruit_GFX::write(c);
+    const GlyphFace face = gfxFont ? GlyphFace::gfx(*gfxFont) : _classic;
+    const uint8_t code = (!gfxFont && !_cp437 && c >= 176) ? static_cast<uint8_t>(c + 1) : c;
+    GlyphSource glyph;
+    if (!face.glyph(code, glyph)) return Adafruit_GFX::write(c);
+    if (gfxFont)
+    {
+      if (glyph.width > 0 && glyph.height > 0)
+      {
+        if (wrap && cursor_x + glyph.xOffset + glyph.width > _width)
+        {
+          cursor_x = 0;
+          cursor_y += gfxFont->yAdvance;
+        }
+        drawGlyph(c, code, face, glyph, textcolor);
+      }
+    }
+    else
+    {
+      if (wrap && cursor_x + 6 > _width)
+      {
+        cursor_x = 0;
+        cursor_y += 8;
+      }
+      if (textbgcolor != textcolor) _raster->fillRect(getRotation(), cursor_x, cursor_y, 6, 8, planeInk(textbgcolor));
+      drawGlyph(c, code, face, glyph, textcolor);
+    }
+    cursor_x += glyph.xAdvance;
+    return 1;
+  }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override
+  {
+    _raster->pixel(getRotation(), x, y, planeInk(color));
+  }
+
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override
+  {
+    _raster->fillRect(getRotation(), x, y, w, 1, planeInk(color));
+  }
+
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override
+  {
+    _raster->fillRect(getRotation(), x, y, 1, h, planeInk(color));
+  }
+
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override
+  {
+    _raster->fillRect(getRotation(), x, y, w, h, planeInk(color));
+  }
+
+  using Adafruit_GFX::drawBitmap;
+
+  // Set bits in color, clear bits left alone, rotated with 8x8 block
+  // transposes; flash and RAM are one address space on the RP2040. Images
+  // longer than the panel on a side take the library's per-pixel path.
+  void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color)
+  {
+    if (w > BITMAP_SIDE_MAX || h > BITMAP_SIDE_MAX)
+    {
+      Adafruit_GFX::drawBitmap(x, y, bitmap, w, h, color);
+      return;
+    }
+    _raster->blit(getRotation(), x, y, bitmap, w, h, planeInk(color));
+  }
+
+  void drawBitmap(int16_t x, int16_t y, uint8_t *bitmap, int16_t w, int16_t h, uint16_t color)
+  {
+    drawBitmap(x, y, const_cast<const uint8_t *>(bitmap), w, h, color);
+  }
+
+  void fillScreen(uint16_t color) override
+  {
+    _raster->fill(planeInk(color));
+  }
+
+protected:
+  // Adafruit_GFX::charBounds() that also knows setPackedFont(), so
+  // DirtyTracking boxes packed text where write() draws it.
+  void charBounds(unsigned char c, int16_t *x, int16_t *y, int16_t *minx, int16_t *miny, int16_t *maxx,
+                  int16_t *maxy)
+  {
+    if (!_packedFont)
+    {
+      Adafruit_GFX::charBounds(c, x, y, minx, miny, maxx, maxy);
+      return;
+    }
+    if (c == '\n')
+    {
+      *x = 0;
+      *y += _packedFont->yAdvance;
+      return;
+    }
+    GlyphSource glyph;
+    if (c == '\r' || !_packed.glyph(c, glyph)) return;
+    if (glyph.width > 0 && glyph.height > 0)
+    {
+      if (wrap && *x + glyph.xOffset + glyph.width > _width)
+      {
+        *x = 0;
+        *y += _packedFont->yAdvance;
+      }
+      const int16_t x0 = *x + glyph.xOffset;
+      const int16_t y0 = *y + glyph.yOffset;
+      if (x0 < *minx) *minx = x0;
+      if (y0 < *miny) *miny = y0;
+      if (x0 + glyph.width - 1 > *maxx) *maxx = x0 + glyph.width - 1;
+      if (y0 + glyph.height - 1 > *maxy) *maxy = y0 + glyph.height - 1;
+    }
+    *x += glyph.xAdvance;
+  }
+
+private:
+  template <typename D>
+  static auto writePage(D &driver, const Raster &page, uint16_t x, uint16_t y, uint16_t w, uint16_t h, int)
+      -> decltype(driver.writeImagePartAsync(page.black(), page.red(), 0, 0, 0, 0, 0, 0, 0, 0), void())
+  {
+    driver.writeImagePartAsync(page.black(), page.red(), x, y - page.top(), Raster::BITMAP_WIDTH, Raster::ROWS, x,
+                               y, w, h);
+  }
+
+  template <typename D>
+  static void writePage(D &driver, const Raster &page, uint16_t x, uint16_t y, uint16_t w, uint16_t h, long)
+  {
+    driver.writeImagePart(page.black(), page.red(), x, y - page.top(), Raster::BITMAP_WIDTH, Raster::ROWS, x, y,
+                          w, h);
+  }
+
+  template <typename D>
+  static auto finishPages(D &driver, int) -> decltype(driver.finishImagePart(), void())
+  {
+    driver.finishImagePart();
+  }
+
+  template <typename D>
+  static void finishPages(D &, long)
+  {
+  }
+
+  // write() for PackedFonts, with the GFXfont rules for newline and wrap.
+  size_t writePacked(uint8_t c)
+  {
+    if (c == '\n')
+    {
+      cursor_x = 0;
+      cursor_y += _packedFont->yAdvance;
+      return 1;
+    }
+    GlyphSource glyph;
+    if (c == '\r' || !_packed.glyph(c, glyph)) return 1;
+    if (glyph.width > 0 && glyph.height > 0)
+    {
+      if (wrap && cursor_x + glyph.xOffset + glyph.width > _width)
+      {
+        cursor_x = 0;
+        cursor_y += _packedFont->yAdvance;
+      }
+      drawGlyph(c, c, _packed, glyph, textcolor);
+    }
+    cursor_x += glyph.xAdvance;
+    return 1;
+  }
+
+  // A 5x8 Adafruit_GFX whose drawPixel() sets bits in 5 column bytes:
+  // glcdfont.c's table is static to Adafruit_GFX.cpp, so a classic glyph
+  // is copied out of it through drawChar() just before it is rendered.
+  class ClassicGlyph : public Adafruit_GFX
+  {
+  public:
+    ClassicGlyph() : Adafruit_GFX(5, 8)
+    {
+    }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t) override
+    {
+      if (x >= 0 && x < 5 && y >= 0 && y < 8) columns[x] |= static_cast<uint8_t>(1 << y);
+    }
+
+    // Character c as Adafruit_GFX::write() would draw it, cp437 shift
+    // included.
+    void load(uint8_t c, bool cp437Font)
+    {
+      memset(columns, 0, sizeof(columns));
+      cp437(cp437Font);
+      drawChar(0, 0, c, 1, 1, 1, 1);
+    }
+
+    uint8_t columns[5] = {};
+  };
+
+  // Without a slot the glyph is unpacked into a bitmap and blitted; one
+  // larger than GLYPH_BITMAP_BYTES goes through drawChar(), or for a packed
+  // font is decoded straight to drawPixel().
+  void drawGlyph(uint8_t c, uint8_t code, const GlyphFace &face, const GlyphSource &glyph, uint16_t color)
+  {
+    const bool classic = glyph.bits == _classicGlyph.columns;
+    auto load = [&]() {
+      if (classic) _classicGlyph.load(c, _cp437);
+    };
+    _glyphs.bind(face);
+    if (_glyphs.draw(*_raster, getRotation(), code, glyph, cursor_x, cursor_y, planeInk(color), load)) return;
+    load();
+    uint8_t bitmap[GLYPH_BITMAP_BYTES];
+    if (unpackGlyph(glyph, bitmap, sizeof(bitmap)))
+    {
+      _raster->blit(getRotation(), cursor_x + glyph.xOffset, cursor_y + glyph.yOffset, bitmap, glyph.width,
+                    glyph.height, planeInk(color));
+      return;
+    }
+    if (glyph.layout != GlyphSource::RUNS)
+    {
+      drawChar(cursor_x, cursor_y, c, color, color, 1, 1);
+      return;
+    }
+    RunDecoder runs(*glyph.packed, glyph.bits, static_cast<uint32_t>(glyph.width) * glyph.height);
+    for (uint8_t y = 0; y < glyph.height; ++y)
+    {
+      for (uint8_t x = 0; x < glyph.width; ++x)
+      {
+        if (runs.next()) drawPixel(cursor_x + glyph.xOffset + x, cursor_y + glyph.yOffset + y, color);
+      }
+    }
+  }
+
+  static constexpr int16_t BITMAP_SIDE_MAX = PanelT::maxRowBytes * 8;
+  static constexpr size_t GLYPH_BITMAP_BYTES = 128;  // 32 x 32 px
+
+  Raster _pages[PAGE_BUFFERS];
+  Raster *_raster = _pages;
+  uint16_t _pageY = 0;  // first row nextPage() sends
+  Glyphs _glyphs;
+  ClassicGlyph _classicGlyph;
+  GlyphFace _classic = GlyphFace::column(_classicGlyph.columns);
+  GlyphFace _packed;
+  const PackedFont *_packedFont = nullptr;
+  bool _partial = false;
+  uint16_t _pwX = 0;
+  uint16_t _pwY = 0;
+  uint16_t _pwW = PanelT::width;
+  uint16_t _pwH = PanelT::height;
+};
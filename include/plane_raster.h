@@ -0,0 +1,577 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// What a pixel becomes on the two planes, as whole-byte fill patterns: 0x00
+// marks black (black plane) or red (red plane), 0xFF leaves white.
+struct PlaneInk
+{
+  uint8_t black;
+  uint8_t red;
+};
+
+// GxEPD2_3C colour rules: GxEPD_WHITE/BLACK/RED/YELLOW, any other RGB565
+// value goes red when the red field dominates, else black when dark.
+inline PlaneInk planeInk(uint16_t color)
+{
+  if (color == 0xFFFF) return PlaneInk{0xFF, 0xFF};
+  if (color == 0x0000) return PlaneInk{0x00, 0xFF};
+  if (color == 0xF800 || color == 0xFFE0) return PlaneInk{0xFF, 0x00};
+  if ((color & 0xF100) > (0xF100 / 2)) return PlaneInk{0xFF, 0x00};
+  if ((((color & 0xF800) >> 8) + ((color & 0x07E0) >> 3) + ((color & 0x001F) << 3)) < ((3 * 256) / 2))
+  {
+    return PlaneInk{0x00, 0xFF};
+  }
+  return PlaneInk{0xFF, 0xFF};
+}
+
+// Transposes an 8x8 bit block, MSB-first rows: bit (7 - k) of out[j] is
+// bit (7 - j) of in[k]. Two 32-bit halves, so it stays cheap on the M0+.
+inline void transpose8(const uint8_t in[8], uint8_t out[8])
+{
+  uint32_t x = (static_cast<uint32_t>(in[0]) << 24) | (static_cast<uint32_t>(in[1]) << 16) |
+               (static_cast<uint32_t>(in[2]) << 8) | in[3];
+  uint32_t y = (static_cast<uint32_t>(in[4]) << 24) | (static_cast<uint32_t>(in[5]) << 16) |
+               (static_cast<uint32_t>(in[6]) << 8) | in[7];
+  uint32_t t = (x ^ (x >> 7)) & 0x00AA00AAUL;
+  x = x ^ t ^ (t << 7);
+  t = (y ^ (y >> 7)) & 0x00AA00AAUL;
+  y = y ^ t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCCUL;
+  x = x ^ t ^ (t << 14);
+  t = (y ^ (y >> 14)) & 0x0000CCCCUL;
+  y = y ^ t ^ (t << 14);
+  t = (x & 0xF0F0F0F0UL) | ((y >> 4) & 0x0F0F0F0FUL);
+  y = ((x << 4) & 0xF0F0F0F0UL) | (y & 0x0F0F0F0FUL);
+  x = t;
+  out[0] = static_cast<uint8_t>(x >> 24);
+  out[1] = static_cast<uint8_t>(x >> 16);
+  out[2] = static_cast<uint8_t>(x >> 8);
+  out[3] = static_cast<uint8_t>(x);
+  out[4] = static_cast<uint8_t>(y >> 24);
+  out[5] = static_cast<uint8_t>(y >> 16);
+  out[6] = static_cast<uint8_t>(y >> 8);
+  out[7] = static_cast<uint8_t>(y);
+}
+
+inline uint8_t reverseBits(uint8_t b)
+{
+  static const uint8_t NIBBLE[16] = {0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, 0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF};
+  return static_cast<uint8_t>((NIBBLE[b & 0x0F] << 4) | NIBBLE[b >> 4]);
+}
+
+// GxEPD2_3C's rotation transform for a W x H panel, one specialization per
+// rotation so the mapping is straight-line code. point() maps a logical
+// pixel, rect() a logical rectangle, to physical coordinates.
+template <uint8_t Rotation, uint16_t W, uint16_t H>
+struct RotationMap;
+
+template <uint16_t W, uint16_t H>
+struct RotationMap<0, W, H>
+{
+  static constexpr int16_t width = W;
+  static constexpr int16_t height = H;
+
+  static void point(int16_t &, int16_t &)
+  {
+  }
+
+  static void rect(int16_t &, int16_t &, int16_t &, int16_t &)
+  {
+  }
+};
+
+template <uint16_t W, uint16_t H>
+struct RotationMap<1, W, H>
+{
+  static constexpr int16_t width = H;
+  static constexpr int16_t height = W;
+
+  static void point(int16_t &x, int16_t &y)
+  {
+    const int16_t t = x;
+    x = W - 1 - y;
+    y = t;
+  }
+
+  static void rect(int16_t &x, int16_t &y, int16_t &w, int16_t &h)
+  {
+    const int16_t t = x;
+    x = W - y - h;
+    y = t;
+    const int16_t u = w;
+    w = h;
+    h = u;
+  }
+};
+
+template <uint16_t W, uint16_t H>
+struct RotationMap<2, W, H>
+{
+  static constexpr int16_t width = W;
+  static constexpr int16_t height = H;
+
+  static void point(int16_t &x, int16_t &y)
+  {
+    x = W - 1 - x;
+    y = H - 1 - y;
+  }
+
+  static void rect(int16_t &x, int16_t &y, int16_t &w, int16_t &h)
+  {
+    x = W - x - w;
+    y = H - y - h;
+  }
+};
+
+template <uint16_t W, uint16_t H>
+struct RotationMap<3, W, H>
+{
+  static constexpr int16_t width = H;
+  static constexpr int16_t height = W;
+
+  static void point(int16_t &x, int16_t &y)
+  {
+    const int16_t t = x;
+    x = y;
+    y = H - 1 - t;
+  }
+
+  static void rect(int16_t &x, int16_t &y, int16_t &w, int16_t &h)
+  {
+    const int16_t t = x;
+    x = y;
+    y = H - t - w;
+    const int16_t u = w;
+    w = h;
+    h = u;
+  }
+};
+
+// Black and red planes of PanelT in controller bit order (MSB is the
+// leftmost pixel, 1 is white), with rows padded to a 32-bit word so the
+// span kernel works on aligned words. Coordinates are physical unless a
+// rotation is given. With PageRows below the panel height the planes hold
+// one page, PageRows physical rows from top(); every kernel clips to it, so
+// a frame is drawn page by page by repeating the same calls after setPage(). Each rotation is its own instantiation (pixelAt<R>,
+// fillRectAt<R>, blitAt<R>); a rectangle is mapped to physical coordinates
+// once, so no kernel looks at the rotation per pixel. The overloads taking
+// a runtime rotation switch once per call.
+//
+// Kernels, picked per rectangle:
+//   full rows     one memset per plane over the covered rows
+//   one byte col  a precomputed byte mask applied down the column
+//   otherwise     masked 32-bit read-modify-write at the span ends, plain
+//                 word stores in between
+template <typename PanelT, uint16_t PageRows = PanelT::height>
+class PlaneRaster
+{
+public:
+  static_assert(PageRows > 0 && PageRows <= PanelT::height, "page rows out of range");
+
+  static constexpr uint16_t WIDTH = PanelT::width;
+  static constexpr uint16_t HEIGHT = PanelT::height;
+  static constexpr uint16_t ROWS = PageRows;
+  static constexpr bool PAGED = ROWS < HEIGHT;
+  static constexpr uint16_t STRIDE = (PanelT::rowBytes + 3) / 4 * 4;
+  static constexpr uint16_t BITMAP_WIDTH = STRIDE * 8;  // w_bitmap for writeImagePart
+  static constexpr size_t PLANE_BYTES = static_cast<size_t>(STRIDE) * ROWS;
+
+  // First physical row held; always 0 for a full frame.
+  int16_t top() const
+  {
+    return PAGED ? _top : 0;
+  }
+
+  void setPage(int16_t top)
+  {
+    _top = top;
+  }
+
+  const uint8_t *black() const
+  {
+    return reinterpret_cast<const uint8_t *>(_black);
+  }
+
+  const uint8_t *red() const
+  {
+    return reinterpret_cast<const uint8_t *>(_red);
+  }
+
+  void fill(PlaneInk ink)
+  {
+    memset(_black, ink.black, PLANE_BYTES);
+    memset(_red, ink.red, PLANE_BYTES);
+  }
+
+  void pixel(int16_t x, int16_t y, PlaneInk ink)
+  {
+    if (x < 0 || y < 0 || x >= WIDTH || y >= HEIGHT || !onPage(y)) return;
+    setBit(reinterpret_cast<uint8_t *>(_black), x, y - top(), ink.black);
+    setBit(reinterpret_cast<uint8_t *>(_red), x, y - top(), ink.red);
+  }
+
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, PlaneInk ink)
+  {
+    if (!clip(x, y, w, h, WIDTH, HEIGHT) || !clipToPage(y, h)) return;
+    y -= top();
+    if (x == 0 && w == WIDTH)
+    {
+      const size_t offset = static_cast<size_t>(y) * STRIDE;
+      const size_t count = static_cast<size_t>(h) * STRIDE;
+      memset(reinterpret_cast<uint8_t *>(_black) + offset, ink.black, count);
+      memset(reinterpret_cast<uint8_t *>(_red) + offset, ink.red, count);
+      return;
+    }
+    const uint16_t x1 = x + w - 1;
+    if ((x >> 3) == (x1 >> 3))
+    {
+      const uint8_t mask = (0xFF >> (x & 7)) & (0xFF << (7 - (x1 & 7)));
+      column(reinterpret_cast<uint8_t *>(_black), x >> 3, y, h, mask, ink.black);
+      column(reinterpret_cast<uint8_t *>(_red), x >> 3, y, h, mask, ink.red);
+      return;
+    }
+    spans(_black, x, x1, y, h, ink.black);
+    spans(_red, x, x1, y, h, ink.red);
+  }
+
+  template <uint8_t R>
+  void pixelAt(int16_t x, int16_t y, PlaneInk ink)
+  {
+    using Map = RotationMap<R, WIDTH, HEIGHT>;
+    if (x < 0 || y < 0 || x >= Map::width || y >= Map::height) return;
+    Map::point(x, y);
+    if (!onPage(y)) return;
+    setBit(reinterpret_cast<uint8_t *>(_black), x, y - top(), ink.black);
+    setBit(reinterpret_cast<uint8_t *>(_red), x, y - top(), ink.red);
+  }
+
+  template <uint8_t R>
+  void fillRectAt(int16_t x, int16_t y, int16_t w, int16_t h, PlaneInk ink)
+  {
+    using Map = RotationMap<R, WIDTH, HEIGHT>;
+    if (!clip(x, y, w, h, Map::width, Map::height)) return;
+    Map::rect(x, y, w, h);
+    fillRect(x, y, w, h, ink);
+  }
+
+  // Adafruit_GFX::drawBitmap for a logical-orientation 1bpp image (MSB
+  // first, rows padded to a byte): set bits take ink, clear bits leave the
+  // planes alone. The image is turned into physical rows a band at a time
+  // (8x8 transposes for rotations 1 and 3) and merged with byte masks;
+  // images with rows longer than the panel's are ignored.
+  template <uint8_t R>
+  void blitAt(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, PlaneInk ink)
+  {
+    if (w <= 0 || h <= 0) return;
+    int16_t px = x, py = y, pw = w, ph = h;
+    RotationMap<R, WIDTH, HEIGHT>::rect(px, py, pw, ph);
+    const uint16_t stride = (w + 7) / 8;
+    const uint16_t rowBytes = (pw + 7) / 8;
+    uint8_t band[8][BAND_ROW_MAX];
+    if (rowBytes > BAND_ROW_MAX) return;
+    for (int16_t v0 = 0; v0 < ph; v0 += 8)
+    {
+      // band rows are physical rows py + v0 + j
+      if (PAGED && (py + v0 + 8 <= top() || py + v0 >= top() + ROWS)) continue;
+      if (R == 0 || R == 2)
+      {
+        // rows map to rows; only rotation 2 reverses them
+        for (uint8_t j = 0; j < 8 && v0 + j < ph; ++j)
+        {
+          const int16_t v = v0 + j;
+          const uint8_t *src = bitmap + static_cast<size_t>(R == 0 ? v : h - 1 - v) * stride;
+          if (R == 0 || (w & 7) == 0)
+          {
+            for (uint16_t ub = 0; ub < rowBytes; ++ub)
+            {
+              band[j][ub] = R == 0 ? src[ub] : reverseBits(src[rowBytes - 1 - ub]);
+            }
+            continue;
+          }
+          for (uint16_t ub = 0; ub < rowBytes; ++ub)
+          {
+            band[j][ub] = reverseBits(sourceByte(src, w - 8 - ub * 8, w));
+          }
+        }
+      }
+      else
+      {
+        // physical columns u are source rows, physical rows v source columns;
+        // the 8 source columns of a band are the same bits of every row
+        const int32_t bit = R == 1 ? v0 : w - 8 - v0;
+        const bool inside = bit >= 0 && bit + 8 <= w;
+        const int32_t byte = bit >> 3;
+        const uint8_t shift = bit & 7;
+        for (uint16_t ub = 0; ub < rowBytes; ++ub)
+        {
+          uint8_t in[8];
+          uint8_t out[8];
+          for (uint8_t k = 0; k < 8; ++k)
+          {
+            const int16_t u = ub * 8 + k;
+            if (u >= pw)
+            {
+              in[k] = 0;
+              continue;
+            }
+            const uint8_t *src = bitmap + static_cast<size_t>(R == 1 ? h - 1 - u : u) * stride;
+            if (!inside) in[k] = sourceByte(src, bit, w);
+            else if (shift == 0) in[k] = src[byte];
+            else in[k] = static_cast<uint8_t>((src[byte] << shift) | (src[byte + 1] >> (8 - shift)));
+          }
+          transpose8(in, out);
+          for (uint8_t j = 0; j < 8; ++j) band[R == 1 ? j : 7 - j][ub] = out[j];
+        }
+      }
+      for (uint8_t j = 0; j < 8 && v0 + j < ph; ++j)
+      {
+        mergeRow(band[j], rowBytes, pw, px, py + v0 + j, ink);
+      }
+    }
+  }
+
+  // Physical rows of set bits already aligned to byte column xb (glyph
+  // strips): one AND/OR per byte and plane, clipped to the panel and page.
+  void mergeStrip(int16_t xb, int16_t y, const uint8_t *bits, uint8_t rowBytes, uint8_t rows, PlaneInk ink)
+  {
+    if (xb >= 0 && xb + rowBytes <= WIDTH / 8 && y >= top() && y + rows <= top() + ROWS)
+    {
+      const size_t offset = static_cast<size_t>(y - top()) * STRIDE + xb;
+      uint8_t *black = reinterpret_cast<uint8_t *>(_black) + offset;
+      uint8_t *red = reinterpret_cast<uint8_t *>(_red) + offset;
+      for (uint8_t r = 0; r < rows; ++r, black += STRIDE, red += STRIDE, bits += rowBytes)
+      {
+        for (uint8_t i = 0; i < rowBytes; ++i)
+        {
+          const uint8_t mask = bits[i];
+          black[i] = (black[i] & ~mask) | (ink.black & mask);
+          red[i] = (red[i] & ~mask) | (ink.red & mask);
+        }
+      }
+      return;
+    }
+    for (uint8_t r = 0; r < rows; ++r, bits += rowBytes)
+    {
+      const int16_t row = y + r;
+      if (row < 0 || row >= HEIGHT || !onPage(row)) continue;
+      uint8_t *black = reinterpret_cast<uint8_t *>(_black) + static_cast<size_t>(row - top()) * STRIDE;
+      uint8_t *red = reinterpret_cast<uint8_t *>(_red) + static_cast<size_t>(row - top()) * STRIDE;
+      for (uint8_t i = 0; i < rowBytes; ++i) mergeByte(black, red, xb + i, bits[i], ink);
+    }
+  }
+
+  void pixel(uint8_t rotation, int16_t x, int16_t y, PlaneInk ink)
+  {
+    switch (rotation & 3)
+    {
+      case 1:
+        pixelAt<1>(x, y, ink);
+        break;
+      case 2:
+        pixelAt<2>(x, y, ink);
+        break;
+      case 3:
+        pixelAt<3>(x, y, ink);
+        break;
+      default:
+        pixelAt<0>(x, y, ink);
+        break;
+    }
+  }
+
+  void fillRect(uint8_t rotation, int16_t x, int16_t y, int16_t w, int16_t h, PlaneInk ink)
+  {
+    switch (rotation & 3)
+    {
+      case 1:
+        fillRectAt<1>(x, y, w, h, ink);
+        break;
+      case 2:
+        fillRectAt<2>(x, y, w, h, ink);
+        break;
+      case 3:
+        fillRectAt<3>(x, y, w, h, ink);
+        break;
+      default:
+        fillRectAt<0>(x, y, w, h, ink);
+        break;
+    }
+  }
+
+  void blit(uint8_t rotation, int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, PlaneInk ink)
+  {
+    switch (rotation & 3)
+    {
+      case 1:
+        blitAt<1>(x, y, bitmap, w, h, ink);
+        break;
+      case 2:
+        blitAt<2>(x, y, bitmap, w, h, ink);
+        break;
+      case 3:
+        blitAt<3>(x, y, bitmap, w, h, ink);
+        break;
+      default:
+        blitAt<0>(x, y, bitmap, w, h, ink);
+        break;
+    }
+  }
+
+private:
+  // Longest physical row a blit can produce, in bytes.
+  static constexpr uint16_t BAND_ROW_MAX = PanelT::maxRowBytes + 1;
+
+  static void setBit(uint8_t *plane, int16_t x, int16_t y, uint8_t fill)
+  {
+    const size_t i = static_cast<size_t>(y) * STRIDE + (x >> 3);
+    const uint8_t bit = 0x80 >> (x & 7);
+    plane[i] = (plane[i] & ~bit) | (fill & bit);
+  }
+
+  // 8 source bits from bit position 'bit' on, MSB first; bits outside
+  // [0, w) read as clear.
+  static uint8_t sourceByte(const uint8_t *row, int32_t bit, int16_t w)
+  {
+    if (bit >= 0 && bit + 8 <= w)
+    {
+      const uint8_t shift = bit & 7;
+      const uint8_t *p = row + (bit >> 3);
+      return shift ? static_cast<uint8_t>((p[0] << shift) | (p[1] >> (8 - shift))) : p[0];
+    }
+    const int32_t first = bit >= 0 ? bit / 8 : -((7 - bit) / 8);
+    const uint8_t shift = static_cast<uint8_t>(bit - first * 8);
+    const int32_t last = (w - 1) / 8;
+    const uint8_t hi = (first >= 0 && first <= last) ? row[first] : 0;
+    const uint8_t lo = (first + 1 >= 0 && first + 1 <= last) ? row[first + 1] : 0;
+    uint8_t value = static_cast<uint8_t>(((static_cast<uint16_t>(hi) << 8 | lo) << shift) >> 8);
+    if (bit + 8 > w) value &= (w - bit <= 0) ? 0 : static_cast<uint8_t>(0xFF << (bit + 8 - w));
+    return value;
+  }
+
+  // Merges a physical row of set bits, pw pixels starting at px, into both
+  // planes; clipped to the panel and page.
+  void mergeRow(const uint8_t *bits, uint16_t rowBytes, int16_t pw, int16_t px, int16_t py, PlaneInk ink)
+  {
+    if (py < 0 || py >= HEIGHT || !onPage(py)) return;
+    uint8_t *black = reinterpret_cast<uint8_t *>(_black) + static_cast<size_t>(py - top()) * STRIDE;
+    uint8_t *red = reinterpret_cast<uint8_t *>(_red) + static_cast<size_t>(py - top()) * STRIDE;
+    const int16_t first = px >= 0 ? px / 8 : -((7 - px) / 8);
+    const uint8_t shift = static_cast<uint8_t>(px - first * 8);
+    const uint8_t tail = (pw & 7) ? static_cast<uint8_t>(0xFF << (8 - (pw & 7))) : 0xFF;
+    uint8_t carry = 0;
+    for (uint16_t i = 0; i <= rowBytes; ++i)
+    {
+      uint8_t b = 0;
+      if (i < rowBytes) b = (i + 1 == rowBytes) ? (bits[i] & tail) : bits[i];
+      const uint8_t mask = static_cast<uint8_t>((b >> shift) | carry);
+      carry = shift ? static_cast<uint8_t>(b << (8 - shift)) : 0;
+      mergeByte(black, red, first + i, mask, ink);
+    }
+  }
+
+  static void mergeByte(uint8_t *black, uint8_t *red, int16_t db, uint8_t mask, PlaneInk ink)
+  {
+    if (db < 0 || db >= PanelT::rowBytes || mask == 0) return;
+    if ((WIDTH & 7) && db == PanelT::rowBytes - 1) mask &= 0xFF << (8 - (WIDTH & 7));
+    black[db] = (black[db] & ~mask) | (ink.black & mask);
+    red[db] = (red[db] & ~mask) | (ink.red & mask);
+  }
+
+  static constexpr size_t PLANE_WORDS = PLANE_BYTES / 4;
+  static constexpr uint16_t STRIDE_WORDS = STRIDE / 4;
+
+  bool onPage(int16_t y) const
+  {
+    return !PAGED || (y >= _top && y < _top + ROWS);
+  }
+
+  // Narrows physical rows [y, y + h) to the page; false when none are on it.
+  bool clipToPage(int16_t &y, int16_t &h) const
+  {
+    if (!PAGED) return true;
+    const int16_t y0 = y > _top ? y : _top;
+    const int16_t y1 = y + h < _top + ROWS ? y + h : _top + ROWS;
+    if (y0 >= y1) return false;
+    y = y0;
+    h = y1 - y0;
+    return true;
+  }
+
+  // Clips to [0, maxW) x [0, maxH); negative sizes extend left/up as in
+  // GFXcanvas1. Returns false when nothing is left.
+  static bool clip(int16_t &x, int16_t &y, int16_t &w, int16_t &h, int16_t maxW, int16_t maxH)
+  {
+    if (w < 0)
+    {
+      w = -w;
+      x -= w - 1;
+    }
+    if (h < 0)
+    {
+      h = -h;
+      y -= h - 1;
+    }
+    int32_t x0 = x, y0 = y, x1 = static_cast<int32_t>(x) + w, y1 = static_cast<int32_t>(y) + h;
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > maxW) x1 = maxW;
+    if (y1 > maxH) y1 = maxH;
+    if (x0 >= x1 || y0 >= y1) return false;
+    x = static_cast<int16_t>(x0);
+    y = static_cast<int16_t>(y0);
+    w = static_cast<int16_t>(x1 - x0);
+    h = static_cast<int16_t>(y1 - y0);
+    return true;
+  }
+
+  // Bit masks are built MSB-first; the stored word is in memory order.
+  static uint32_t toMemoryOrder(uint32_t bigEndian)
+  {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    return __builtin_bswap32(bigEndian);
+#else
+    return bigEndian;
+#endif
+  }
+
+  static void column(uint8_t *plane, uint16_t xb, uint16_t y, uint16_t h, uint8_t mask, uint8_t fill)
+  {
+    uint8_t *p = plane + static_cast<size_t>(y) * STRIDE + xb;
+    const uint8_t keep = ~mask;
+    const uint8_t set = fill & mask;
+    for (uint16_t i = 0; i < h; ++i, p += STRIDE)
+    {
+      *p = (*p & keep) | set;
+    }
+  }
+
+  static void spans(uint32_t *plane, uint16_t x0, uint16_t x1, uint16_t y, uint16_t h, uint8_t fill)
+  {
+    const uint16_t first = x0 >> 5;
+    const uint16_t last = x1 >> 5;
+    uint32_t headMask = 0xFFFFFFFFUL >> (x0 & 31);
+    uint32_t tailMask = 0xFFFFFFFFUL << (31 - (x1 & 31));
+    if (first == last)
+    {
+      headMask &= tailMask;
+    }
+    headMask = toMemoryOrder(headMask);
+    tailMask = toMemoryOrder(tailMask);
+    const uint32_t word = fill ? 0xFFFFFFFFUL : 0;
+    uint32_t *row = plane + static_cast<size_t>(y) * STRIDE_WORDS;
+    for (uint16_t r = 0; r < h; ++r, row += STRIDE_WORDS)
+    {
+      row[first] = (row[first] & ~headMask) | (word & headMask);
+      if (first == last) continue;
+      for (uint16_t i = first + 1; i < last; ++i) row[i] = word;
+      row[last] = (row[last] & ~tailMask) | (word & tailMask);
+    }
+  }
+
+  uint32_t _black[PLANE_WORDS];
+  uint32_t _red[PLANE_WORDS];
+  int16_t _top = 0;
+};
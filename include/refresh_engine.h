@@ -0,0 +1,124 @@
+#pragma once
+
+#include <stdint.h>
+
+// Bus access needed by RefreshEngine. Implemented by GxEPD2_213c_Lab on the
+// target and by FakeBusyLine on the host.
+class RefreshPort
+{
+public:
+  virtual void sendCommand(uint8_t cmd) = 0;
+  virtual bool busyActive() = 0;
+  virtual uint32_t nowMs() = 0;
+
+protected:
+  ~RefreshPort() = default;
+};
+
+enum class RefreshPhase : uint8_t
+{
+  Idle,
+  Init,
+  PowerOn,
+  Refresh,
+  PowerOff
+};
+
+enum class RefreshEvent : uint8_t
+{
+  None,
+  Done,
+  Timeout
+};
+
+// Upper bound for BUSY in each phase, in milliseconds.
+struct RefreshDeadlines
+{
+  uint32_t initMs;
+  uint32_t powerOnMs;
+  uint32_t refreshMs;
+  uint32_t powerOffMs;
+};
+
+// UC8151/IL0373 opcodes for the three commanded phases.
+struct RefreshOpcodes
+{
+  uint8_t powerOn;
+  uint8_t refresh;
+  uint8_t powerOff;
+};
+
+// Non-blocking refresh sequence: wait for the panel to go idle, power on,
+// trigger the refresh, power off. Each phase is bounded by its deadline; a
+// phase that runs out after power-on still gets the power-off command.
+// poll() is cheap and meant to be called from loop(); a BUSY edge interrupt
+// only has to call notifyBusyEdge() so the release time is captured exactly.
+class RefreshEngine
+{
+public:
+  static constexpr RefreshOpcodes UC8151_OPCODES = {0x04, 0x12, 0x02};
+  // Room for GxEPD2_213c's 15 s full refresh in the refresh phase.
+  static constexpr RefreshDeadlines UC8151_DEADLINES = {1000, 1000, 20000, 1000};
+
+  explicit RefreshEngine(const RefreshDeadlines &deadlines, const RefreshOpcodes &opcodes = UC8151_OPCODES);
+
+  // Returns false when a refresh is already running.
+  bool start(RefreshPort &port, bool powerOn);
+  RefreshEvent poll(RefreshPort &port);
+  // Blocks in poll() until the sequence ends (used before any other bus access).
+  RefreshEvent finish(RefreshPort &port);
+
+  void notifyBusyEdge(uint32_t nowMs);
+  void setDeadlines(const RefreshDeadlines &deadlines);
+
+  bool busy() const
+  {
+    return _phase != RefreshPhase::Idle;
+  }
+
+  RefreshPhase phase() const
+  {
+    return _phase;
+  }
+
+  // Phase that ran out of time, valid after a Timeout event.
+  RefreshPhase failedPhase() const
+  {
+    return _failedPhase;
+  }
+
+  // The last sequence sent power-off, i.e. the panel is (being) powered down.
+  // False after a timeout while waiting for the panel to go idle.
+  bool poweredOff() const
+  {
+    return _powerOffSent;
+  }
+
+  // Start to end of the last completed or failed sequence.
+  uint32_t lastDurationMs() const
+  {
+    return _lastDurationMs;
+  }
+
+  static const char *phaseName(RefreshPhase phase);
+
+private:
+  static constexpr uint32_t BUSY_SETTLE_MS = 2;
+
+  void enter(RefreshPort &port, RefreshPhase phase, uint32_t nowMs);
+  RefreshPhase nextPhase(RefreshPhase phase) const;
+  uint32_t deadlineFor(RefreshPhase phase) const;
+
+  RefreshDeadlines _deadlines;
+  RefreshOpcodes _opcodes;
+  RefreshPhase _phase = RefreshPhase::Idle;
+  RefreshPhase _failedPhase = RefreshPhase::Idle;
+  bool _powerOn = true;
+  bool _busySeen = false;
+  bool _powerOffSent = false;
+  uint32_t _startMs = 0;
+  uint32_t _phaseStartMs = 0;
+  uint32_t _lastDurationMs = 0;
+  volatile bool _edgeSeen = false;
+  volatile uint32_t _edgeMs = 0;
+};
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Intervals of one refresh, in the order the panel goes through them.
+enum class RefreshSpan : uint8_t
+{
+  Init,        // first opcode to the black plane opcode
+  Black,       // black plane RAM write
+  Red,         // red plane RAM write, up to its last CS window
+  Trigger,     // end of the RAM writes to the 0x12/0x20 trigger (power-on)
+  BusyAssert,  // trigger to BUSY going active
+  Busy,        // BUSY active to released
+  PowerOff,    // release to the end of the power-off BUSY
+  Total,
+  Count
+};
+
+static constexpr size_t REFRESH_SPAN_COUNT = static_cast<size_t>(RefreshSpan::Count);
+static constexpr uint32_t REFRESH_SPAN_NONE = UINT32_MAX;
+
+struct RefreshRecord
+{
+  uint32_t startMs;
+  uint8_t trigger;
+  uint32_t spanUs[REFRESH_SPAN_COUNT];  // REFRESH_SPAN_NONE when not reached
+};
+
+struct RefreshSpanStats
+{
+  size_t count;
+  uint32_t minUs;
+  uint32_t avgUs;
+  uint32_t p95Us;
+  uint32_t maxUs;
+};
+
+// Builds refresh records from the opcode stream and BUSY edges, keeping the
+// last Depth finished ones. Both controller families are recognised at
+// once: 0x10/0x13/0x12/0x02 (UC8151) and 0x24/0x26/0x20 (SSD16xx), which is
+// what GxEPD2_213c and the raw lab commands send. A record opens at the
+// first opcode after the bus went quiet and closes at the first opcode
+// after its refresh released BUSY (power-off excepted), or in settle().
+//
+// opcode(), windowEnd() and settle() run in one context; busyEdge() may be
+// an interrupt and only touches the open record.
+template <size_t Depth>
+class RefreshTelemetry
+{
+  static_assert(Depth > 0, "Depth must be positive");
+
+public:
+  static constexpr uint32_t QUIET_GAP_US = 50000;
+
+  void opcode(uint8_t op, uint32_t nowUs, uint32_t nowMs)
+  {
+    if (_open && _mark[M_TRIGGER] != NONE && !(op == 0x02 && _mark[M_POWER_OFF] == NONE))
+    {
+      close();
+    }
+    if (_open && _mark[M_TRIGGER] == NONE && !_busy && nowUs - _lastUs > QUIET_GAP_US)
+    {
+      _open = false;
+    }
+    if (!_open) openAt(nowUs, nowMs);
+    _lastUs = nowUs;
+
+    if ((op == 0x10 || op == 0x24) && _mark[M_BLACK] == NONE)
+    {
+      _mark[M_BLACK] = nowUs;
+      _plane = PLANE_BLACK;
+    }
+    else if ((op == 0x13 || op == 0x26) && _mark[M_RED] == NONE)
+    {
+      _mark[M_RED] = nowUs;
+      _plane = PLANE_RED;
+    }
+    else if ((op == 0x12 || op == 0x20) && _mark[M_TRIGGER] == NONE)
+    {
+      _mark[M_TRIGGER] = nowUs;
+      _trigger = op;
+      _plane = PLANE_NONE;
+    }
+    else if (op == 0x02 && _mark[M_TRIGGER] != NONE)
+    {
+      _mark[M_POWER_OFF] = nowUs;
+    }
+    else
+    {
+      _plane = PLANE_NONE;
+    }
+  }
+
+  // CS released; the red plane ends with its last window.
+  void windowEnd(uint32_t nowUs)
+  {
+    if (!_open) return;
+    _lastUs = nowUs;
+    if (_plane == PLANE_RED) _mark[M_RED_END] = nowUs;
+  }
+
+  void busyEdge(bool active, uint32_t nowUs)
+  {
+    _busy = active;
+    if (!_open) return;
+    _lastUs = nowUs;
+    if (_mark[M_TRIGGER] == NONE) return;
+    if (_mark[M_POWER_OFF] != NONE)
+    {
+      if (!active) _mark[M_POWER_OFF_DONE] = nowUs;
+      return;
+    }
+    if (active && _mark[M_BUSY_ON] == NONE) _mark[M_BUSY_ON] = nowUs;
+    if (!active && _mark[M_BUSY_ON] != NONE && _mark[M_BUSY_OFF] == NONE) _mark[M_BUSY_OFF] = nowUs;
+  }
+
+  // Closes an open record whose refresh has ended, e.g. before a dump.
+  void settle()
+  {
+    if (_open && _mark[M_TRIGGER] != NONE && !_busy) close();
+  }
+
+  void reset()
+  {
+    _count = 0;
+    _next = 0;
+    _open = false;
+  }
+
+  size_t size() const
+  {
+    return _count;
+  }
+
+  // 0 is the oldest record kept.
+  const RefreshRecord &record(size_t index) const
+  {
+    return _ring[(_next + Depth - _count + index) % Depth];
+  }
+
+  RefreshSpanStats spanStats(RefreshSpan span) const
+  {
+    uint32_t values[Depth];
+    size_t n = 0;
+    uint64_t sum = 0;
+    for (size_t i = 0; i < _count; ++i)
+    {
+      const uint32_t v = record(i).spanUs[static_cast<size_t>(span)];
+      if (v == REFRESH_SPAN_NONE) continue;
+      size_t j = n++;
+      while (j > 0 && values[j - 1] > v)
+      {
+        values[j] = values[j - 1];
+        --j;
+      }
+      values[j] = v;
+      sum += v;
+    }
+    RefreshSpanStats stats = {n, 0, 0, 0, 0};
+    if (n == 0) return stats;
+    stats.minUs = values[0];
+    stats.maxUs = values[n - 1];
+    stats.avgUs = static_cast<uint32_t>(sum / n);
+    stats.p95Us = values[(n * 95 + 99) / 100 - 1];
+    return stats;
+  }
+
+  static const char *spanName(RefreshSpan span)
+  {
+    switch (span)
+    {
+      case RefreshSpan::Init:
+        return "init";
+      case RefreshSpan::Black:
+        return "black";
+      case RefreshSpan::Red:
+        return "red";
+      case RefreshSpan::Trigger:
+        return "trigger";
+      case RefreshSpan::BusyAssert:
+        return "busy_assert";
+      case RefreshSpan::Busy:
+        return "busy";
+      case RefreshSpan::PowerOff:
+        return "power_off";
+      default:
+        return "total";
+    }
+  }
+
+private:
+  enum : uint8_t
+  {
+    M_BLACK,
+    M_RED,
+    M_RED_END,
+    M_TRIGGER,
+    M_BUSY_ON,
+    M_BUSY_OFF,
+    M_POWER_OFF,
+    M_POWER_OFF_DONE,
+    M_COUNT
+  };
+
+  enum : uint8_t
+  {
+    PLANE_NONE,
+    PLANE_BLACK,
+    PLANE_RED
+  };
+
+  static constexpr uint32_t NONE = REFRESH_SPAN_NONE;
+
+  static uint32_t between(uint32_t from, uint32_t to)
+  {
+    return (from == NONE || to == NONE) ? NONE : to - from;
+  }
+
+  void openAt(uint32_t nowUs, uint32_t nowMs)
+  {
+    for (uint32_t &m : _mark) m = NONE;
+    _startUs = nowUs;
+    _startMs = nowMs;
+    _trigger = 0;
+    _plane = PLANE_NONE;
+    _open = true;
+  }
+
+  void close()
+  {
+    _open = false;
+    RefreshRecord &r = _ring[_next];
+    r.startMs = _startMs;
+    r.trigger = _trigger;
+    const uint32_t planesEnd = _mark[M_RED_END] != NONE ? _mark[M_RED_END] : _mark[M_RED];
+    r.spanUs[static_cast<size_t>(RefreshSpan::Init)] = between(_startUs, _mark[M_BLACK]);
+    r.spanUs[static_cast<size_t>(RefreshSpan::Black)] = between(_mark[M_BLACK], _mark[M_RED]);
+    r.spanUs[static_cast<size_t>(RefreshSpan::Red)] = between(_mark[M_RED], planesEnd);
+    r.spanUs[static_cast<size_t>(RefreshSpan::Trigger)] =
+        between(planesEnd != NONE ? planesEnd : _startUs, _mark[M_TRIGGER]);
+    r.spanUs[static_cast<size_t>(RefreshSpan::BusyAssert)] = between(_mark[M_TRIGGER], _mark[M_BUSY_ON]);
+    r.spanUs[static_cast<size_t>(RefreshSpan::Busy)] = between(_mark[M_BUSY_ON], _mark[M_BUSY_OFF]);
+    const uint32_t powerOffEnd = _mark[M_POWER_OFF_DONE] != NONE ? _mark[M_POWER_OFF_DONE] : _mark[M_POWER_OFF];
+    r.spanUs[static_cast<size_t>(RefreshSpan::PowerOff)] = between(_mark[M_BUSY_OFF], powerOffEnd);
+    r.spanUs[static_cast<size_t>(RefreshSpan::Total)] = _lastUs - _startUs;
+    _next = (_next + 1) % Depth;
+    if (_count < Depth) ++_count;
+  }
+
+  RefreshRecord _ring[Depth] = {};
+  size_t _count = 0;
+  size_t _next = 0;
+  uint32_t _mark[M_COUNT] = {};
+  uint32_t _startUs = 0;
+  uint32_t _startMs = 0;
+  volatile uint32_t _lastUs = 0;
+  volatile bool _busy = false;
+  bool _open = false;
+  uint8_t _trigger = 0;
+  uint8_t _plane = PLANE_NONE;
+};
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Packed plane format: PackBits plus a "same as the row above" run.
+//
+//   payload = rowBytes (u8) | tokens...
+//   0x00..0x7F  n      : n+1 literal bytes follow
+//   0x80        k      : k+1 bytes unchanged from the previous row
+//   0x81..0xFF  v      : v repeated 257-n times (2..128)
+//
+// Literal and repeat tokens stay within a row; unchanged runs may continue
+// into the following rows. The row above the first row reads as 0xFF
+// (white). Decoding needs one row of scratch and no framebuffer.
+
+static constexpr size_t ROW_CODEC_MAX_ROW = 64;
+static constexpr uint8_t ROW_CODEC_SEED = 0xFF;
+
+// Worst case is all literals: one header per 128 bytes of every row.
+constexpr size_t rowCodecBound(size_t rowBytes, size_t rows)
+{
+  return 1 + rows * (rowBytes + (rowBytes + 127) / 128);
+}
+
+// Encodes a whole plane into out (rowCodecBound bytes); returns the size.
+// Unchanged runs may span rows, so a repeated row band costs two bytes per
+// 256 bytes of plane.
+inline size_t rowCodecEncode(const uint8_t *plane, size_t rowBytes, size_t rows, uint8_t *out)
+{
+  const size_t total = rowBytes * rows;
+  auto above = [&](size_t k) -> uint8_t
+  {
+    return k >= rowBytes ? plane[k - rowBytes] : ROW_CODEC_SEED;
+  };
+  size_t o = 0;
+  out[o++] = static_cast<uint8_t>(rowBytes);
+  size_t i = 0;
+  while (i < total)
+  {
+    const size_t rowEnd = (i / rowBytes + 1) * rowBytes;
+    size_t same = 0;
+    while (i + same < total && same < 256 && plane[i + same] == above(i + same)) ++same;
+    if (same >= 2 || (same == 1 && i + 1 == rowEnd))
+    {
+      out[o++] = 0x80;
+      out[o++] = static_cast<uint8_t>(same - 1);
+      i += same;
+      continue;
+    }
+    size_t run = 1;
+    while (i + run < rowEnd && run < 128 && plane[i + run] == plane[i]) ++run;
+    if (run >= 2)
+    {
+      out[o++] = static_cast<uint8_t>(257 - run);
+      out[o++] = plane[i];
+      i += run;
+      continue;
+    }
+    // literal until a run of 3 or an unchanged pair would pay off
+    size_t lit = 1;
+    while (i + lit < rowEnd && lit < 128)
+    {
+      const size_t j = i + lit;
+      const bool repeat = j + 2 < rowEnd && plane[j] == plane[j + 1] && plane[j] == plane[j + 2];
+      const bool unchanged = j + 1 < rowEnd && plane[j] == above(j) && plane[j + 1] == above(j + 1);
+      if (repeat || unchanged) break;
+      ++lit;
+    }
+    out[o++] = static_cast<uint8_t>(lit - 1);
+    memcpy(out + o, plane + i, lit);
+    o += lit;
+    i += lit;
+  }
+  return o;
+}
+
+// Streaming decoder: input may be split anywhere; each completed row is
+// handed to sink(row, rowBytes) straight from the scratch row.
+class RowDecoder
+{
+public:
+  void begin()
+  {
+    _state = State::RowBytes;
+    _rowBytes = 0;
+    _pos = 0;
+    _rows = 0;
+    memset(_row, ROW_CODEC_SEED, sizeof(_row));
+  }
+
+  template <typename Sink>
+  bool feed(const uint8_t *input, size_t count, Sink &&sink)
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      const uint8_t b = input[i];
+      switch (_state)
+      {
+        case State::RowBytes:
+          if (b == 0 || b > ROW_CODEC_MAX_ROW) return fail();
+          _rowBytes = b;
+          _state = State::Header;
+          break;
+        case State::Header:
+          if (b < 0x80)
+          {
+            _left = static_cast<size_t>(b) + 1;
+            _state = State::Literal;
+          }
+          else if (b == 0x80)
+          {
+            _state = State::Unchanged;
+          }
+          else
+          {
+            _left = 257 - static_cast<size_t>(b);
+            _state = State::Repeat;
+          }
+          break;
+        case State::Literal:
+        {
+          // copy as much of this literal as the input holds
+          size_t n = count - i;
+          if (n > _left) n = _left;
+          if (_pos + n > _rowBytes) return fail();
+          memcpy(_row + _pos, input + i, n);
+          _pos += n;
+          _left -= n;
+          i += n - 1;
+          if (_left == 0) endToken(sink);
+          break;
+        }
+        case State::Repeat:
+          if (_pos + _left > _rowBytes) return fail();
+          memset(_row + _pos, b, _left);
+          _pos += _left;
+          endToken(sink);
+          break;
+        case State::Unchanged:
+        {
+          // the scratch row already holds the row above; rows that end
+          // inside the run go out as they are
+          size_t left = b + 1u;
+          while (_pos + left >= _rowBytes)
+          {
+            left -= _rowBytes - _pos;
+            _pos = _rowBytes;
+            endToken(sink);
+          }
+          _pos += left;
+          _state = State::Header;
+          break;
+        }
+        case State::Failed:
+          return false;
+      }
+    }
+    return _state != State::Failed;
+  }
+
+  // True when the input ended on a row boundary without errors.
+  bool finished() const
+  {
+    return (_state == State::Header && _pos == 0) || (_state == State::RowBytes);
+  }
+
+  uint32_t rows() const
+  {
+    return _rows;
+  }
+
+private:
+  enum class State : uint8_t
+  {
+    RowBytes,
+    Header,
+    Literal,
+    Repeat,
+    Unchanged,
+    Failed
+  };
+
+  bool fail()
+  {
+    _state = State::Failed;
+    return false;
+  }
+
+  template <typename Sink>
+  void endToken(Sink &sink)
+  {
+    _state = State::Header;
+    if (_pos < _rowBytes) return;
+    sink(static_cast<const uint8_t *>(_row), static_cast<size_t>(_rowBytes));
+    _pos = 0;
+    ++_rows;
+  }
+
+  State _state = State::RowBytes;
+  uint8_t _rowBytes = 0;
+  size_t _pos = 0;
+  size_t _left = 0;
+  uint32_t _rows = 0;
+  uint8_t _row[ROW_CODEC_MAX_ROW];
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Lock-free ring for exactly one producer and one consumer, e.g. core0
+// handing render jobs to core1. Only plain atomic loads and stores are used,
+// so it stays lock-free on Cortex-M0+, which has no exclusive access
+// instructions. Depth must be a power of two; indices run free and wrap.
+template <typename T, size_t Depth>
+class SpscRing
+{
+  static_assert(Depth > 0 && (Depth & (Depth - 1)) == 0, "Depth must be a power of two");
+
+public:
+  SpscRing() = default;
+
+  // Indices start at 'first' instead of 0, so a test can reach the point
+  // where they wrap past 2^32 without 4 billion pushes.
+  explicit SpscRing(uint32_t first) : _head(first), _tail(first)
+  {
+  }
+
+  // Producer side. Returns false when the ring is full.
+  bool push(const T &item)
+  {
+    const uint32_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail - _head.load(std::memory_order_acquire) == Depth) return false;
+    _slots[tail & (Depth - 1)] = item;
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side. Returns false when the ring is empty.
+  bool pop(T &out)
+  {
+    const uint32_t head = _head.load(std::memory_order_relaxed);
+    if (_tail.load(std::memory_order_acquire) == head) return false;
+    out = _slots[head & (Depth - 1)];
+    _head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Either side; the answer may already be stale for the other one.
+  size_t size() const
+  {
+    // head first: tail never falls behind a head that was already read
+    const uint32_t head = _head.load(std::memory_order_acquire);
+    return _tail.load(std::memory_order_acquire) - head;
+  }
+
+  size_t space() const
+  {
+    return Depth - size();
+  }
+
+  bool empty() const
+  {
+    return size() == 0;
+  }
+
+  bool full() const
+  {
+    return size() == Depth;
+  }
+
+private:
+  T _slots[Depth] = {};
+  std::atomic<uint32_t> _head{0};
+  std::atomic<uint32_t> _tail{0};
+};
@@ -0,0 +1,183 @@
+// --------------------------------------------------------------------------
+// Sterownik panelu 2.15" (GDEW0215T11 / UC8151D) — komendy wysokiego poziomu
+// --------------------------------------------------------------------------
+
+#include <stddef.h>
+#include <stdio.h>
+#include "epd.h"
+#include "epd_hal.h"
+
+// ====== Niskopoziomowe I/O (backend wybiera epd_hal.h) ======
+static inline void epd_cs(bool level){  epd_hal_cs(level); }
+static inline void epd_dc(bool level){  epd_hal_dc(level); }
+static inline void epd_rst(bool level){ epd_hal_rst(level); }
+
+static inline void epd_write_bytes(const uint8_t *buf, size_t len){
+    epd_hal_write(buf, len);
+}
+void epd_write_cmd(uint8_t c){
+    epd_cs(false);
+    epd_dc(false);
+    epd_write_bytes(&c, 1);
+    epd_cs(true);
+}
+void epd_write_data(uint8_t d){
+    epd_cs(false);
+    epd_dc(true);
+    epd_write_bytes(&d, 1);
+    epd_cs(true);
+}
+
+// ====== Powiadomienia o fazach (epd_on_phase) ======
+static epd_phase_fn phase_fn;
+static void *phase_user;
+
+void epd_on_phase(epd_phase_fn fn, void *user){
+    phase_fn = fn;
+    phase_user = user;
+}
+
+static inline void epd_phase(epd_phase_t phase, uint8_t progress){
+    epd_phase_fn fn = phase_fn;
+    if (fn) fn(phase, progress, phase_user);
+}
+
+// Limity czasu BUSY dla poszczególnych faz (ms)
+#define EPD_DEADLINE_INIT_MS       1000
+#define EPD_DEADLINE_POWER_ON_MS   1000
+#define EPD_DEADLINE_REFRESH_MS   20000
+#define EPD_DEADLINE_POWER_OFF_MS  1000
+
+// Czekaj aż BUSY=1 (gotowy) — jak w Twojej wersji Arduino_UNO, ale z limitem,
+// żeby nie zawiesić się na wieki. Rdzeń śpi, budzi go zbocze BUSY.
+bool epd_wait_ready(uint32_t timeout_ms){
+    epd_phase(EPD_PHASE_BUSY, 0);
+    const bool ok = epd_hal_wait_idle(timeout_ms);
+    epd_phase(EPD_PHASE_IDLE, 0);
+    if (ok) return true;
+    printf("[EPD] BUSY timeout po %lu ms\n", (unsigned long)timeout_ms);
+    return false;
+}
+
+// ====== Komendy wysokiego poziomu (z Twojego .cpp) ======
+// Pełna inicjalizacja (wersja z EPD_Init)
+bool epd_init_full(void){
+    // reset x3 (jak w źródle)
+    for(int i=0;i<3;i++){
+        epd_rst(false); epd_hal_delay_ms(10);
+        epd_rst(true);  epd_hal_delay_ms(10);
+    }
+    if (!epd_wait_ready(EPD_DEADLINE_INIT_MS)) return false;
+
+    // POWER SETTING
+    epd_write_cmd(0x01);
+    epd_write_data(0x03);
+    epd_write_data(0x00);
+    epd_write_data(0x2b);
+    epd_write_data(0x2b);
+    epd_write_data(0x13);
+
+    //BOOSTER SOFT
+/*     epd_write_cmd(0x06);
+    epd_write_data(0x17);
+    epd_write_data(0x17);
+    epd_write_data(0x17); */
+
+    // 0x00 panel setting: 0x1F, 0x0D
+    epd_write_cmd(0x00);
+    epd_write_data(0x1F);  // LUT from OTP (BW OTP)
+    epd_write_data(0x0D);
+
+    // 0x61 resolution: width, height high, height low
+    epd_write_cmd(0x61);
+    epd_write_data(EPD_WIDTH);
+    epd_write_data(EPD_HEIGHT >> 8);
+    epd_write_data(EPD_HEIGHT & 0xFF);
+
+    // 0x04 POWER ON
+    epd_write_cmd(0x04);
+    if (!epd_wait_ready(EPD_DEADLINE_POWER_ON_MS)) return false;
+
+    // 0x50 VCOM & data interval
+    epd_write_cmd(0x50);
+    epd_write_data(0x57);
+    return true;
+}
+
+// ====== Wysyłka ramki: jedna transakcja CS na płaszczyznę ======
+static struct {
+    const uint8_t *newbuf;
+    volatile uint8_t stage;   // 0 = 0x10, 1 = 0x13, 2 = gotowe
+    epd_done_fn done;
+    void *user;
+} push = { .stage = 2 };
+
+// CS w dół, bajt komendy przy DC=0, potem DC=1 i CS zostaje aktywny na dane
+static void epd_plane_begin(uint8_t cmd){
+    epd_cs(false);
+    epd_dc(false);
+    epd_write_bytes(&cmd, 1);
+    epd_dc(true);
+}
+
+static void epd_plane_done(void *user){
+    (void)user;
+    epd_cs(true);
+    if (push.stage == 0){
+        push.stage = 1;
+        epd_phase(EPD_PHASE_SPI, 50);
+        epd_plane_begin(0x13);
+        epd_hal_dma_start(push.newbuf, 0xFF, EPD_ARRAY, epd_plane_done, NULL);
+        return;
+    }
+    push.stage = 2;
+    epd_phase(EPD_PHASE_IDLE, 0);
+    if (push.done) push.done(push.user);
+}
+
+// Wyślij pełną ramkę: najpierw "stare" (0x10) = biel, potem "nowe" (0x13) = bufor
+void epd_frame_push_async(const uint8_t *newbuf, epd_done_fn done, void *user){
+    epd_frame_wait();
+    push.newbuf = newbuf;
+    push.done = done;
+    push.user = user;
+    push.stage = 0;
+    epd_phase(EPD_PHASE_SPI, 0);
+    epd_plane_begin(0x10);
+    epd_hal_dma_start(NULL, 0x00, EPD_ARRAY, epd_plane_done, NULL); // białe tło
+}
+
+bool epd_frame_busy(void){
+    return push.stage < 2;
+}
+
+void epd_frame_wait(void){
+    while (epd_frame_busy()){
+    }
+}
+
+void epd_frame_push(const uint8_t *newbuf){
+    epd_frame_push_async(newbuf, NULL, NULL);
+    epd_frame_wait();
+}
+
+// Wyzwól odświeżenie (0x12) i poczekaj
+bool epd_update(void){
+    epd_frame_wait();
+    epd_write_cmd(0x12);
+    epd_hal_delay_ms(1);
+    return epd_wait_ready(EPD_DEADLINE_REFRESH_MS);
+}
+
+// Usypianie jak w Twoim .cpp
+bool epd_deep_sleep(void){
+    epd_write_cmd(0x50);
+    epd_write_data(0xF7);
+    epd_write_cmd(0x02);      // power off
+    const bool ok = epd_wait_ready(EPD_DEADLINE_POWER_OFF_MS);
+    epd_hal_delay_ms(200);//!!!The delay here is necessary,100mS at least!!!
+    epd_write_cmd(0x07);      // deep sleep
+    epd_write_data(0xA5);
+    epd_phase(EPD_PHASE_SLEEP, 0);
+    return ok;
+}
@@ -0,0 +1,56 @@
+// --------------------------------------------------------------------------
+// Sterownik panelu 2.15" (GDEW0215T11 / UC8151D) na warstwie epd_spi.h
+// --------------------------------------------------------------------------
+
+#ifndef EPD_H
+#define EPD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ====== Parametry panelu 2.15" (GDEW0215T11 / UC8151D) ======
+#define EPD_WIDTH   112
+#define EPD_HEIGHT  208
+#define EPD_ARRAY   (EPD_WIDTH * EPD_HEIGHT / 8)
+
+// Koniec wysyłki ramki (na Pico: kontekst IRQ DMA)
+typedef void (*epd_done_fn)(void *user);
+
+// Fazy pracy sterownika, np. dla diody statusu (status_led.h)
+typedef enum {
+    EPD_PHASE_IDLE,
+    EPD_PHASE_SPI,     // wysyłka płaszczyzn, progress 0..100
+    EPD_PHASE_BUSY,    // czekanie na BUSY
+    EPD_PHASE_SLEEP    // deep sleep
+} epd_phase_t;
+
+// Wołane także z IRQ DMA: tylko krótki zapis, bez czekania
+typedef void (*epd_phase_fn)(epd_phase_t phase, uint8_t progress, void *user);
+void epd_on_phase(epd_phase_fn fn, void *user);
+
+void epd_write_cmd(uint8_t c);
+void epd_write_data(uint8_t d);
+// false = BUSY nie zwolnił się w timeout_ms
+bool epd_wait_ready(uint32_t timeout_ms);
+
+bool epd_init_full(void);
+
+// Ramka: 0x10 ("stare") = 0x00, 0x13 ("nowe") = newbuf (NULL -> 0xFF).
+// Każda płaszczyzna to jedna transakcja CS, dane idą przez DMA.
+void epd_frame_push(const uint8_t *newbuf);
+void epd_frame_push_async(const uint8_t *newbuf, epd_done_fn done, void *user);
+bool epd_frame_busy(void);
+void epd_frame_wait(void);
+
+bool epd_update(void);
+bool epd_deep_sleep(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
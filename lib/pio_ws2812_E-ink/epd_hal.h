@@ -0,0 +1,109 @@
+// --------------------------------------------------------------------------
+// HAL sterownika EPD: wybór backendu w czasie kompilacji, bez wskaźników
+// na funkcje. epd.c woła wyłącznie epd_hal_*.
+//
+//  (domyślnie)      -> funkcje z epd_spi.h (epd_spi.c na Pico,
+//                      epd_spi_host.c z EPD_HOST_BUILD)
+//  EPD_HAL_RELEASE  -> CS/DC/RST i zapis jako gpio_put / spi_write_blocking
+//                      wprost w miejscu wywołania, jak dawne helpery inline
+//                      z ws2812.c; init, BUSY i DMA nadal z epd_spi.c
+//  EPD_HAL_RECORD   -> host: epd_spi_host.c + dziennik CSV każdej transakcji
+//                      (epd_hal_record.c)
+// --------------------------------------------------------------------------
+
+#ifndef EPD_HAL_H
+#define EPD_HAL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "epd_spi.h"
+
+#if defined(EPD_HAL_RELEASE) && defined(EPD_HAL_RECORD)
+#error EPD_HAL_RELEASE i EPD_HAL_RECORD wykluczają się
+#endif
+#if defined(EPD_HAL_RECORD) && !defined(EPD_HOST_BUILD)
+#error EPD_HAL_RECORD wymaga EPD_HOST_BUILD
+#endif
+
+#ifdef EPD_HAL_RECORD
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Dziennik: jedna linia CSV na transakcję (CS w dół .. CS w górę) i na
+// czekanie na BUSY. t_us = zegar hosta od startu, vt_ms = zegar wirtualny
+// epd_spi_host.c (liczy opóźnienia i BUSY).
+void epd_hal_record_start(FILE *out);
+void epd_hal_record_stop(void);
+
+void epd_hal_record_cs(bool level);
+void epd_hal_record_dc(bool level);
+// buf == NULL -> len bajtów wypełnienia (DMA z fill)
+void epd_hal_record_write(const uint8_t *buf, size_t len);
+void epd_hal_record_wait(uint32_t waited_ms, bool ok);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+#ifdef EPD_HAL_RELEASE
+#include "hardware/gpio.h"
+#include "hardware/spi.h"
+#include "epd_pins.h"
+
+static inline void epd_hal_cs(bool level){  gpio_put(PIN_CS,  level); }
+static inline void epd_hal_dc(bool level){  gpio_put(PIN_DC,  level); }
+static inline void epd_hal_rst(bool level){ gpio_put(PIN_RST, level); }
+static inline void epd_hal_write(const uint8_t *buf, size_t len){
+    spi_write_blocking(EPD_SPI, buf, len);
+}
+#elif defined(EPD_HAL_RECORD)
+static inline void epd_hal_cs(bool level){
+    epd_spi_cs(level);
+    epd_hal_record_cs(level);
+}
+static inline void epd_hal_dc(bool level){
+    epd_spi_dc(level);
+    epd_hal_record_dc(level);
+}
+static inline void epd_hal_rst(bool level){ epd_spi_rst(level); }
+static inline void epd_hal_write(const uint8_t *buf, size_t len){
+    epd_hal_record_write(buf, len);
+    epd_spi_write(buf, len);
+}
+#else
+static inline void epd_hal_cs(bool level){  epd_spi_cs(level); }
+static inline void epd_hal_dc(bool level){  epd_spi_dc(level); }
+static inline void epd_hal_rst(bool level){ epd_spi_rst(level); }
+static inline void epd_hal_write(const uint8_t *buf, size_t len){
+    epd_spi_write(buf, len);
+}
+#endif
+
+static inline void epd_hal_delay_ms(uint32_t ms){ epd_spi_delay_ms(ms); }
+
+static inline bool epd_hal_wait_idle(uint32_t timeout_ms){
+#ifdef EPD_HAL_RECORD
+    const uint32_t start = epd_spi_now_ms();
+    const bool ok = epd_spi_wait_idle(timeout_ms);
+    epd_hal_record_wait(epd_spi_now_ms() - start, ok);
+    return ok;
+#else
+    return epd_spi_wait_idle(timeout_ms);
+#endif
+}
+
+// Dane DMA liczą się do bieżącej transakcji jak zwykły zapis
+static inline void epd_hal_dma_start(const uint8_t *src, uint8_t fill, size_t len,
+                                     epd_spi_done_fn done, void *user){
+#ifdef EPD_HAL_RECORD
+    epd_hal_record_write(src, len);
+#endif
+    epd_spi_dma_start(src, fill, len, done, user);
+}
+
+#endif
@@ -0,0 +1,55 @@
+# Porównanie disasemblacji: epd.c z EPD_HAL_RELEASE kontra epd_hal_ref.c
+# (dawne helpery inline). Wywołanie:
+#   cmake -DOBJDUMP=<objdump> -DRELEASE_OBJ=<epd.c.obj> -DREF_OBJ=<epd_hal_ref.c.obj>
+#         [-DFUNCTIONS=epd_write_cmd;epd_write_data] -P epd_hal_check.cmake
+# Adresy są pomijane; rozkazy, ich kodowanie, relokacje i literały muszą się
+# zgadzać co do bajtu.
+
+if (NOT FUNCTIONS)
+    set(FUNCTIONS epd_write_cmd epd_write_data)
+endif()
+
+# Treść funkcji 'name' z wyjścia objdump -d -r, bez kolumny adresów
+function(epd_disassembly obj name out)
+    execute_process(COMMAND ${OBJDUMP} -d -r ${obj}
+            OUTPUT_VARIABLE dump RESULT_VARIABLE rc ERROR_VARIABLE err)
+    if (NOT rc EQUAL 0)
+        message(FATAL_ERROR "${OBJDUMP} ${obj}: ${err}")
+    endif()
+    string(REPLACE ";" "\\;" dump "${dump}")
+    string(REPLACE "\n" ";" lines "${dump}")
+    set(body "")
+    set(inside FALSE)
+    foreach(line IN LISTS lines)
+        if (line MATCHES "^[0-9a-f]+ <${name}>:$")
+            set(inside TRUE)
+        elseif (inside)
+            if (line STREQUAL "")
+                break()
+            endif()
+            string(REGEX REPLACE "^[ \t]*[0-9a-f]+:[ \t]*" "" line "${line}")
+            string(APPEND body "${line}\n")
+        endif()
+    endforeach()
+    if (body STREQUAL "")
+        message(FATAL_ERROR "Brak funkcji ${name} w ${obj}")
+    endif()
+    set(${out} "${body}" PARENT_SCOPE)
+endfunction()
+
+set(failed FALSE)
+foreach(fn IN LISTS FUNCTIONS)
+    epd_disassembly(${RELEASE_OBJ} ${fn} release)
+    epd_disassembly(${REF_OBJ} ${fn} ref)
+    if (release STREQUAL ref)
+        message(STATUS "EPD_HAL_RELEASE: ${fn} identyczna z dawnym helperem")
+    else()
+        message("EPD_HAL_RELEASE: ${fn} różni się od dawnego helpera\n"
+                "--- epd.c (EPD_HAL_RELEASE)\n${release}"
+                "--- epd_hal_ref.c\n${ref}")
+        set(failed TRUE)
+    endif()
+endforeach()
+if (failed)
+    message(FATAL_ERROR "EPD_HAL_RELEASE nie daje tych samych instrukcji co dawne helpery inline")
+endif()
@@ -0,0 +1,86 @@
+// --------------------------------------------------------------------------
+// Backend nagrywający HAL (host, EPD_HAL_RECORD): dziennik CSV transakcji.
+//
+// seq,t_us,vt_ms,kind,opcode,cmd_bytes,data_bytes,wait_ms
+//   kind = tx   -> jedna transakcja CS; opcode = pierwszy bajt przy DC=0
+//   kind = busy -> czekanie na BUSY; opcode = 1 gdy zdążył, 0 gdy timeout
+//
+// Budowanie: cc -DEPD_HOST_BUILD -DEPD_HAL_RECORD -I. epd.c epd_spi_host.c
+//            epd_hal_record.c <program>.c
+// --------------------------------------------------------------------------
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <time.h>
+#include "epd_hal.h"
+
+static FILE *out;
+static uint64_t t0_ns;
+static uint32_t seq;
+static bool dc_level = true;
+static bool in_tx;
+static uint64_t tx_ns;
+static int opcode = -1;
+static uint32_t cmd_bytes;
+static uint32_t data_bytes;
+
+static uint64_t now_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static double since_start_us(uint64_t ns){
+    return (double)(ns - t0_ns) / 1000.0;
+}
+
+void epd_hal_record_start(FILE *f){
+    out = f;
+    t0_ns = now_ns();
+    seq = 0;
+    in_tx = false;
+    if (out) fprintf(out, "seq,t_us,vt_ms,kind,opcode,cmd_bytes,data_bytes,wait_ms\n");
+}
+
+void epd_hal_record_stop(void){
+    if (out) fflush(out);
+    out = NULL;
+}
+
+void epd_hal_record_cs(bool level){
+    if (!out) return;
+    if (!level && !in_tx){
+        in_tx = true;
+        tx_ns = now_ns();
+        opcode = -1;
+        cmd_bytes = 0;
+        data_bytes = 0;
+        return;
+    }
+    if (level && in_tx){
+        in_tx = false;
+        fprintf(out, "%u,%.1f,%u,tx,", (unsigned)seq++, since_start_us(tx_ns), (unsigned)epd_spi_now_ms());
+        if (opcode >= 0) fprintf(out, "0x%02X", (unsigned)opcode);
+        fprintf(out, ",%u,%u,\n", (unsigned)cmd_bytes, (unsigned)data_bytes);
+    }
+}
+
+void epd_hal_record_dc(bool level){
+    dc_level = level;
+}
+
+void epd_hal_record_write(const uint8_t *buf, size_t len){
+    if (!out || len == 0) return;
+    if (dc_level){
+        data_bytes += (uint32_t)len;
+        return;
+    }
+    if (opcode < 0 && buf) opcode = buf[0];
+    cmd_bytes += (uint32_t)len;
+}
+
+void epd_hal_record_wait(uint32_t waited_ms, bool ok){
+    if (!out) return;
+    fprintf(out, "%u,%.1f,%u,busy,%d,,,%u\n", (unsigned)seq++, since_start_us(now_ns()),
+            (unsigned)epd_spi_now_ms(), ok ? 1 : 0, (unsigned)waited_ms);
+}
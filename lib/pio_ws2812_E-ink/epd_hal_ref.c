@@ -0,0 +1,36 @@
+// --------------------------------------------------------------------------
+// Wzorzec dla EPD_HAL_RELEASE: dawne helpery inline z ws2812.c, słowo w
+// słowo. Nie trafia do programu; CMake (epd_hal_check) kompiluje go obok
+// epd.c z EPD_HAL_RELEASE i porównuje disasemblację epd_write_cmd /
+// epd_write_data z obu plików (epd_hal_check.cmake).
+// --------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "hardware/gpio.h"
+#include "hardware/spi.h"
+#include "epd_pins.h"
+
+void epd_write_cmd(uint8_t c);
+void epd_write_data(uint8_t d);
+
+// ====== Niskopoziomowe I/O ======
+static inline void epd_cs(bool level){  gpio_put(PIN_CS,  level); }
+static inline void epd_dc(bool level){  gpio_put(PIN_DC,  level); }
+
+static inline void epd_write_bytes(const uint8_t *buf, size_t len){
+    spi_write_blocking(spi0, buf, len);
+}
+void epd_write_cmd(uint8_t c){
+    epd_cs(false);
+    epd_dc(false);
+    epd_write_bytes(&c, 1);
+    epd_cs(true);
+}
+void epd_write_data(uint8_t d){
+    epd_cs(false);
+    epd_dc(true);
+    epd_write_bytes(&d, 1);
+    epd_cs(true);
+}
@@ -0,0 +1,19 @@
+// --------------------------------------------------------------------------
+// Piny i port SPI panelu EPD (Opcja A) — wspólne dla epd_spi.c i epd_hal.h
+// --------------------------------------------------------------------------
+
+#ifndef EPD_PINS_H
+#define EPD_PINS_H
+
+#define EPD_SPI         spi0
+#define PIN_SCK         2   // GP2  -> SCK
+#define PIN_MOSI        3   // GP3  -> MOSI
+#define PIN_MISO        4   // GP4  -> MISO (opcjonalnie, dla e-paper zwykle niepotrzebne)
+#define PIN_CS          1   // GP1  -> CS#
+#define PIN_DC          6   // GP6  -> D/C
+#define PIN_RST         7   // GP7  -> RST#
+#define PIN_BUSY        8   // GP8  -> BUSY
+
+#define SPI_BAUD  (2*1000*1000)
+
+#endif
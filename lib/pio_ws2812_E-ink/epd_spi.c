@@ -0,0 +1,107 @@
+// --------------------------------------------------------------------------
+// Backend Pico SDK dla epd_spi.h: GPIO + spi0, dane płaszczyzn przez DMA
+// --------------------------------------------------------------------------
+
+#include "pico/stdlib.h"
+#include "hardware/spi.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "epd_spi.h"
+#include "epd_pins.h"
+
+static int dma_chan = -1;
+static volatile bool dma_active;
+static epd_spi_done_fn dma_done;
+static void *dma_user;
+static uint8_t dma_fill;
+
+// DMA tylko nadaje, więc RX FIFO się przepełnia — sprzątamy jak spi_write_blocking
+static void epd_spi_drain_rx(void){
+    while (spi_is_busy(EPD_SPI)) tight_loop_contents();
+    while (spi_is_readable(EPD_SPI)) (void)spi_get_hw(EPD_SPI)->dr;
+    spi_get_hw(EPD_SPI)->icr = SPI_SSPICR_RORIC_BITS;
+}
+
+static void epd_spi_dma_irq(void){
+    if (dma_chan < 0 || !dma_channel_get_irq0_status((uint)dma_chan)) return;
+    dma_channel_acknowledge_irq0((uint)dma_chan);
+    // DMA skończyło karmić FIFO, ostatnie bajty jeszcze wychodzą na linię
+    epd_spi_drain_rx();
+    dma_active = false;
+    epd_spi_done_fn done = dma_done;
+    dma_done = NULL;
+    if (done) done(dma_user);
+}
+
+// Przerwanie od zbocza BUSY nic nie robi — samo wyjście z IRQ budzi WFE
+static void epd_spi_busy_irq(uint gpio, uint32_t events){
+    (void)gpio;
+    (void)events;
+}
+
+void epd_spi_init(void){
+    gpio_init(PIN_CS);  gpio_set_dir(PIN_CS, GPIO_OUT);  gpio_put(PIN_CS,  true);
+    gpio_init(PIN_DC);  gpio_set_dir(PIN_DC, GPIO_OUT);  gpio_put(PIN_DC, true);
+    gpio_init(PIN_RST); gpio_set_dir(PIN_RST, GPIO_OUT); gpio_put(PIN_RST, true);
+    gpio_init(PIN_BUSY);gpio_set_dir(PIN_BUSY, GPIO_IN);
+    gpio_set_irq_enabled_with_callback(PIN_BUSY, GPIO_IRQ_EDGE_RISE, true, epd_spi_busy_irq);
+
+    spi_init(EPD_SPI, SPI_BAUD);
+    gpio_set_function(PIN_SCK,  GPIO_FUNC_SPI);
+    gpio_set_function(PIN_MOSI, GPIO_FUNC_SPI);
+    // MISO opcjonalnie
+    gpio_set_function(PIN_MISO, GPIO_FUNC_SPI);
+
+    dma_chan = dma_claim_unused_channel(true);
+    dma_channel_set_irq0_enabled((uint)dma_chan, true);
+    irq_add_shared_handler(DMA_IRQ_0, epd_spi_dma_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+}
+
+void epd_spi_cs(bool level){  gpio_put(PIN_CS,  level); }
+void epd_spi_dc(bool level){  gpio_put(PIN_DC,  level); }
+void epd_spi_rst(bool level){ gpio_put(PIN_RST, level); }
+bool epd_spi_busy_pin(void){  return gpio_get(PIN_BUSY); }
+void epd_spi_delay_ms(uint32_t ms){ sleep_ms(ms); }
+uint32_t epd_spi_now_ms(void){ return to_ms_since_boot(get_absolute_time()); }
+
+bool epd_spi_wait_idle(uint32_t timeout_ms){
+    const absolute_time_t deadline = make_timeout_time_ms(timeout_ms);
+    while (gpio_get(PIN_BUSY) == 0){
+        if (best_effort_wfe_or_timeout(deadline)) return gpio_get(PIN_BUSY) != 0;
+    }
+    return true;
+}
+
+void epd_spi_write(const uint8_t *buf, size_t len){
+    spi_write_blocking(EPD_SPI, buf, len);
+}
+
+void epd_spi_dma_start(const uint8_t *src, uint8_t fill, size_t len,
+                       epd_spi_done_fn done, void *user){
+    while (dma_active) tight_loop_contents();
+    if (len == 0){
+        if (done) done(user);
+        return;
+    }
+    dma_fill = fill;
+    dma_done = done;
+    dma_user = user;
+    dma_active = true;
+
+    dma_channel_config c = dma_channel_get_default_config((uint)dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_dreq(&c, spi_get_dreq(EPD_SPI, true));
+    channel_config_set_read_increment(&c, src != NULL);
+    channel_config_set_write_increment(&c, false);
+    dma_channel_configure((uint)dma_chan, &c,
+                          &spi_get_hw(EPD_SPI)->dr,
+                          src ? src : &dma_fill,
+                          (uint)len,
+                          true);
+}
+
+bool epd_spi_dma_busy(void){
+    return dma_active;
+}
@@ -0,0 +1,69 @@
+// --------------------------------------------------------------------------
+// Warstwa SPI/GPIO dla panelu EPD (UC8151D)
+//
+// Dwa backendy z tym samym API:
+//  - epd_spi.c       -> Pico SDK (spi0 + kanał DMA na TX)
+//  - epd_spi_host.c  -> Linux, zlicza transakcje i bajty (EPD_HOST_BUILD)
+// epd.c nie woła ich wprost, tylko przez epd_hal.h
+// --------------------------------------------------------------------------
+
+#ifndef EPD_SPI_H
+#define EPD_SPI_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Wywoływane po wypchnięciu ostatniego bajtu transferu (na Pico: z IRQ DMA)
+typedef void (*epd_spi_done_fn)(void *user);
+
+void epd_spi_init(void);
+
+void epd_spi_cs(bool level);
+void epd_spi_dc(bool level);
+void epd_spi_rst(bool level);
+bool epd_spi_busy_pin(void);
+void epd_spi_delay_ms(uint32_t ms);
+uint32_t epd_spi_now_ms(void);
+
+// Czekaj aż BUSY=1 (gotowy), najdłużej timeout_ms. Na Pico rdzeń śpi w WFE
+// i budzi go przerwanie od zbocza BUSY. false = przekroczony czas.
+bool epd_spi_wait_idle(uint32_t timeout_ms);
+
+// Blokujący zapis, CS/DC ustawia wywołujący
+void epd_spi_write(const uint8_t *buf, size_t len);
+
+// Transfer DMA bez blokowania CPU. src == NULL -> len razy bajt fill.
+// CS/DC ustawia wywołujący; done() dostaje sterowanie, gdy linia jest już pusta.
+void epd_spi_dma_start(const uint8_t *src, uint8_t fill, size_t len,
+                       epd_spi_done_fn done, void *user);
+bool epd_spi_dma_busy(void);
+
+#ifdef EPD_HOST_BUILD
+// Liczniki backendu hosta: transakcja = jedno opadające zbocze CS
+typedef struct {
+    uint32_t transactions;
+    uint32_t cmd_bytes;
+    uint32_t data_bytes;
+} epd_spi_stats_t;
+
+void epd_spi_stats_get(epd_spi_stats_t *out);
+void epd_spi_stats_reset(void);
+void epd_spi_host_set_busy(bool level);
+// Fałszywa linia BUSY: po komendzie cmd panel jest zajęty przez ms (zegar wirtualny)
+void epd_spi_host_set_busy_ms(uint8_t cmd, uint32_t ms);
+// Podgląd strumienia: każdy zapis (także DMA) trafia do fn z poziomem DC,
+// np. do symulatora kontrolera z tools/epd_sim.c
+typedef void (*epd_spi_host_sink_fn)(bool dc, const uint8_t *buf, size_t len, void *user);
+void epd_spi_host_set_sink(epd_spi_host_sink_fn fn, void *user);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,96 @@
+// --------------------------------------------------------------------------
+// Backend hosta (Linux) dla epd_spi.h — bez sprzętu: liczniki i podgląd strumienia.
+// Transfery "DMA" wykonują się od razu, callback wołany synchronicznie.
+//
+// Budowanie: cc -DEPD_HOST_BUILD -I. epd.c epd_spi_host.c <program>.c
+// --------------------------------------------------------------------------
+
+#include <string.h>
+#include "epd_spi.h"
+
+static epd_spi_stats_t stats;
+static bool cs_level = true;
+static bool dc_level = true;
+static bool busy_level = true;   // 1 = gotowy, jak na płytce
+static uint32_t busy_ms[256];
+static uint32_t now_ms;
+static uint32_t busy_until;
+static epd_spi_host_sink_fn sink;
+static void *sink_user;
+
+void epd_spi_init(void){
+    cs_level = true;
+    dc_level = true;
+}
+
+void epd_spi_cs(bool level){
+    if (cs_level && !level) stats.transactions++;
+    cs_level = level;
+}
+void epd_spi_dc(bool level){  dc_level = level; }
+void epd_spi_rst(bool level){ (void)level; }
+bool epd_spi_busy_pin(void){  return busy_level && now_ms >= busy_until; }
+void epd_spi_delay_ms(uint32_t ms){ now_ms += ms; }
+uint32_t epd_spi_now_ms(void){ return now_ms; }
+
+bool epd_spi_wait_idle(uint32_t timeout_ms){
+    if (epd_spi_busy_pin()) return true;
+    if (!busy_level || busy_until - now_ms > timeout_ms){
+        now_ms += timeout_ms;
+        return false;
+    }
+    now_ms = busy_until;
+    return true;
+}
+
+static void count_bytes(size_t len){
+    if (dc_level) stats.data_bytes += (uint32_t)len;
+    else          stats.cmd_bytes  += (uint32_t)len;
+}
+
+void epd_spi_write(const uint8_t *buf, size_t len){
+    count_bytes(len);
+    if (sink) sink(dc_level, buf, len, sink_user);
+    if (!dc_level && len == 1) busy_until = now_ms + busy_ms[buf[0]];
+}
+
+void epd_spi_dma_start(const uint8_t *src, uint8_t fill, size_t len,
+                       epd_spi_done_fn done, void *user){
+    count_bytes(len);
+    if (sink && src){
+        sink(dc_level, src, len, sink_user);
+    } else if (sink){
+        uint8_t chunk[64];
+        memset(chunk, fill, sizeof(chunk));
+        for (size_t off = 0; off < len; off += sizeof(chunk)){
+            const size_t n = len - off < sizeof(chunk) ? len - off : sizeof(chunk);
+            sink(dc_level, chunk, n, sink_user);
+        }
+    }
+    if (done) done(user);
+}
+
+bool epd_spi_dma_busy(void){
+    return false;
+}
+
+void epd_spi_stats_get(epd_spi_stats_t *out){
+    *out = stats;
+}
+
+void epd_spi_stats_reset(void){
+    memset(&stats, 0, sizeof(stats));
+}
+
+void epd_spi_host_set_busy(bool level){
+    busy_level = level;
+}
+
+void epd_spi_host_set_busy_ms(uint8_t cmd, uint32_t ms){
+    busy_ms[cmd] = ms;
+}
+
+void epd_spi_host_set_sink(epd_spi_host_sink_fn fn, void *user){
+    sink = fn;
+    sink_user = user;
+}
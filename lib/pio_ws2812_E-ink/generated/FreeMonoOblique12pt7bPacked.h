@@ -0,0 +1,222 @@
+// FreeMonoOblique12pt7b.h packed by tools/epd_fontpack.cpp (include/glyph_codec.h); regenerate, don't edit.
+// 1707 bitmap bytes as 1279 bytes of runs and 58 of codes.
+
+#pragma once
+
+#include "glyph_codec.h"
+
+const uint8_t FreeMonoOblique12pt7bPackedBitmaps[] = {
+  0x80, 0x22, 0x22, 0x20, 0x22, 0x22, 0xFD, 0x93, 0x90, 0x8C, 0x1E, 0x0E,
+  0x34, 0xC6, 0x98, 0xD2, 0x40, 0x48, 0x60, 0x62, 0x60, 0xB0, 0x58, 0x17,
+  0xA8, 0x16, 0x06, 0x23, 0xF8, 0x81, 0x60, 0x60, 0xB0, 0x58, 0x18, 0xA0,
+  0x6C, 0x66, 0xC8, 0x4A, 0x99, 0xA5, 0xAF, 0x5E, 0xDD, 0xB5, 0x2B, 0x49,
+  0x84, 0xA3, 0xCD, 0xAD, 0x40, 0x59, 0x62, 0xA2, 0x51, 0x28, 0x57, 0x9F,
+  0xB2, 0xB2, 0xB2, 0xC7, 0x2C, 0x54, 0x4A, 0x25, 0x0A, 0xF2, 0x00, 0xAD,
+  0x4B, 0x63, 0x19, 0x55, 0x22, 0x91, 0x4A, 0x49, 0x29, 0x28, 0x46, 0x3B,
+  0x34, 0x00, 0x8F, 0xB3, 0x4D, 0x20, 0x80, 0xD1, 0x12, 0x12, 0x21, 0x22,
+  0x22, 0x22, 0x25, 0x12, 0x00, 0xC2, 0x51, 0x11, 0x11, 0x10, 0xC4, 0x84,
+  0x84, 0x85, 0x00, 0xA6, 0x2C, 0xB2, 0x44, 0x3C, 0xA5, 0xA5, 0x40, 0x42,
+  0x80, 0x6F, 0x3C, 0xD7, 0x95, 0xFB, 0x4F, 0x35, 0xE7, 0x90, 0x38, 0x30,
+  0xC6, 0x51, 0x92, 0x00, 0x8F, 0xD0, 0x9F, 0x90, 0xF9, 0xCF, 0x9C, 0xE7,
+  0x5C, 0xE7, 0x5C, 0xE7, 0x5C, 0xE7, 0x3E, 0x73, 0x90, 0xAC, 0xA8, 0x8D,
+  0x40, 0x69, 0x5A, 0x56, 0x95, 0xD6, 0x95, 0xA5, 0x69, 0x5A, 0x4C, 0x15,
+  0x11, 0xAB, 0x20, 0x73, 0xCA, 0xCA, 0xA4, 0xA0, 0xC6, 0x2D, 0x8C, 0x62,
+  0xD8, 0xC2, 0xF4, 0xBC, 0xB8, 0xAA, 0xA2, 0x37, 0x3C, 0xF5, 0xB6, 0xBC,
+  0xDB, 0x6D, 0x79, 0x61, 0xF9, 0x00, 0xAE, 0x52, 0xBC, 0xF3, 0x6C, 0x9E,
+  0x7A, 0xE7, 0x9E, 0x79, 0xA1, 0x2A, 0xB6, 0x00, 0xCA, 0xD2, 0x60, 0xA0,
+  0x30, 0x50, 0x91, 0x0A, 0x84, 0x85, 0x41, 0xEE, 0x35, 0x8B, 0xE8, 0x5F,
+  0x0B, 0xCF, 0x3C, 0xD0, 0xCA, 0xC2, 0xE7, 0x9E, 0x79, 0xAD, 0x82, 0xA5,
+  0xD0, 0xBD, 0xAA, 0xEC, 0xB5, 0xAF, 0x06, 0x94, 0xC4, 0x72, 0x82, 0x60,
+  0xB0, 0x58, 0x19, 0x11, 0xEC, 0x00, 0x8F, 0x65, 0x6D, 0x63, 0x58, 0xD6,
+  0x35, 0x8D, 0x63, 0x58, 0xD4, 0x00, 0xAD, 0x64, 0x46, 0x0B, 0x05, 0x81,
+  0x91, 0x1E, 0xD4, 0x85, 0x69, 0x62, 0x58, 0x95, 0x8A, 0x95, 0xD0, 0xAD,
+  0x64, 0x46, 0x0B, 0x05, 0x81, 0xC1, 0x58, 0x23, 0x48, 0xE8, 0x79, 0xAD,
+  0xB2, 0xBA, 0xBA, 0x00, 0x30, 0xC1, 0x7F, 0xDC, 0x30, 0x50, 0xA9, 0x62,
+  0xBF, 0xFF, 0xE7, 0x14, 0xB1, 0x4A, 0xA4, 0x00, 0xF5, 0x96, 0x59, 0x65,
+  0xB7, 0x5F, 0x5D, 0x7D, 0x75, 0x00, 0x9F, 0xEF, 0xFE, 0xFE, 0x80, 0x37,
+  0x5F, 0x5D, 0x7D, 0x75, 0x96, 0x59, 0x65, 0x94, 0x00, 0x1D, 0x32, 0xC6,
+  0xB3, 0xAA, 0x55, 0x2D, 0xFF, 0xFD, 0x95, 0x90, 0xAD, 0xA1, 0x8A, 0x80,
+  0xC0, 0xC0, 0xB2, 0x46, 0x09, 0x02, 0x48, 0x08, 0x00, 0xA4, 0xB6, 0x5A,
+  0xD7, 0x9E, 0xE8, 0xAF, 0x39, 0x2E, 0x4B, 0xC0, 0xF0, 0x34, 0x96, 0xA5,
+  0xA8, 0xFE, 0xB3, 0x52, 0xD4, 0xC1, 0x6A, 0x79, 0x70, 0x3E, 0xD1, 0xC9,
+  0x64, 0xB2, 0x39, 0x2A, 0x5F, 0x69, 0x64, 0xC1, 0x60, 0xB0, 0x2B, 0x15,
+  0xD3, 0xF9, 0x00, 0xAD, 0x03, 0x2C, 0x0B, 0xA5, 0x80, 0xF3, 0x9C, 0xE7,
+  0x39, 0xF2, 0xC6, 0x53, 0xD8, 0x3F, 0x5A, 0xAA, 0x39, 0x2C, 0x58, 0x2C,
+  0x16, 0x0B, 0x05, 0x62, 0xC1, 0x59, 0x1C, 0x95, 0x1F, 0xB0, 0x3F, 0xA9,
+  0x84, 0xB5, 0x3F, 0x3F, 0x0B, 0x3C, 0xC2, 0x63, 0xF3, 0xF2, 0xCA, 0xB2,
+  0x60, 0x7F, 0x40, 0x3F, 0xA9, 0x84, 0xC2, 0x61, 0x3F, 0x0B, 0x3C, 0xC2,
+  0x63, 0xF3, 0xF3, 0xEB, 0xE7, 0x7C, 0x80, 0xAE, 0x92, 0x54, 0x2B, 0x07,
+  0x9C, 0xF3, 0x9C, 0xAE, 0x96, 0x03, 0x02, 0xB1, 0x9A, 0xBC, 0x80, 0x5A,
+  0x35, 0x99, 0xAC, 0xD6, 0x66, 0xB3, 0x5F, 0xD6, 0xB3, 0x59, 0x9A, 0xCD,
+  0x66, 0x6B, 0x2E, 0x3B, 0x00, 0x1E, 0xB7, 0x9E, 0x79, 0xAF, 0x3C, 0xF3,
+  0xCD, 0x79, 0xE3, 0xF6, 0x00, 0x7E, 0xF3, 0xF3, 0xF9, 0xFC, 0xFE, 0x7F,
+  0x3F, 0x1A, 0xCD, 0x66, 0xB3, 0x35, 0xC9, 0xBD, 0x00, 0x3C, 0x75, 0x2C,
+  0xD5, 0x59, 0x58, 0x2F, 0x03, 0xDD, 0xE8, 0xB5, 0x4C, 0x53, 0x14, 0xB9,
+  0x9A, 0xCB, 0xC5, 0x90, 0x1F, 0x31, 0xCE, 0x79, 0xCE, 0x73, 0x9E, 0x58,
+  0xAC, 0x4C, 0x8D, 0x3F, 0xB0, 0x39, 0x98, 0x92, 0x73, 0x4A, 0x92, 0x69,
+  0x52, 0x4D, 0x24, 0x0A, 0x10, 0x0A, 0x84, 0x00, 0xC5, 0x22, 0x62, 0x91,
+  0x32, 0x25, 0x36, 0xA6, 0x9B, 0x4B, 0x97, 0x40, 0x1A, 0xB9, 0x56, 0xAC,
+  0xA3, 0x4A, 0x94, 0x0A, 0x50, 0x49, 0x42, 0x4A, 0x11, 0x32, 0x05, 0x28,
+  0x14, 0xAA, 0x54, 0x69, 0x51, 0xCB, 0xA9, 0x00, 0x7B, 0x72, 0x92, 0xC5,
+  0xA9, 0x79, 0x2F, 0x5D, 0x75, 0xE4, 0xBC, 0x96, 0x8A, 0xCA, 0x55, 0xEC,
+  0x00, 0x3F, 0x59, 0xA9, 0x64, 0xB2, 0x59, 0x19, 0x1A, 0xBE, 0x37, 0xCF,
+  0x9D, 0x73, 0xDF, 0x20, 0x7B, 0x72, 0x92, 0xC5, 0xA9, 0x79, 0x2F, 0x5D,
+  0x75, 0xE4, 0xBC, 0x96, 0x8A, 0xCA, 0x53, 0xED, 0x7B, 0xC2, 0x2A, 0xC8,
+  0x3F, 0x59, 0xA9, 0x64, 0xB2, 0x59, 0x19, 0x54, 0xAF, 0x8C, 0xA6, 0xA3,
+  0x32, 0x59, 0x2E, 0x9F, 0x2A, 0xAD, 0x91, 0x94, 0x4C, 0x16, 0x0F, 0x3A,
+  0xED, 0xE7, 0x92, 0xC4, 0xAC, 0x2A, 0x14, 0xF4, 0x00, 0x8F, 0xD9, 0x22,
+  0x49, 0x11, 0xB9, 0xE7, 0x39, 0xCE, 0x79, 0xCE, 0x67, 0xC8, 0x8E, 0x3C,
+  0x18, 0x2B, 0x16, 0x0B, 0x05, 0x82, 0xB2, 0x58, 0xB0, 0x58, 0x2B, 0x8A,
+  0xD4, 0x55, 0xEC, 0x00, 0x8E, 0x5D, 0x2D, 0x26, 0x12, 0xD4, 0x66, 0x66,
+  0xA5, 0xA9, 0x82, 0xD0, 0x78, 0x1E, 0x4B, 0x92, 0xEA, 0x00, 0x8E, 0x5D,
+  0x2D, 0x16, 0x88, 0xC8, 0x46, 0x24, 0x31, 0x20, 0x48, 0x90, 0x24, 0x08,
+  0x05, 0x24, 0x02, 0x92, 0x49, 0x24, 0x92, 0x55, 0x55, 0x55, 0x54, 0x00,
+  0x3A, 0xB5, 0x2D, 0x6A, 0x61, 0x3C, 0x0E, 0xDF, 0xAF, 0xB3, 0xA9, 0x70,
+  0x5A, 0x4C, 0x33, 0x59, 0x6A, 0xE8, 0x8D, 0x5B, 0x2B, 0x25, 0x28, 0xA6,
+  0x2B, 0x06, 0x67, 0x9C, 0xE7, 0x9C, 0xE6, 0x7C, 0x80, 0x5F, 0x4A, 0xC4,
+  0xC9, 0x4F, 0x3C, 0xF3, 0xCF, 0x5B, 0x51, 0x18, 0x98, 0xAC, 0x7D, 0x80,
+  0x58, 0x4C, 0xCC, 0xD4, 0x66, 0x66, 0xA3, 0x33, 0x35, 0x1E, 0xC0, 0x82,
+  0x25, 0x11, 0x28, 0x88, 0x94, 0x44, 0x4A, 0x22, 0x20, 0x3A, 0xCD, 0x46,
+  0x66, 0x66, 0xA3, 0x33, 0x33, 0x51, 0x8E, 0xC0, 0xA5, 0xCC, 0x08, 0x45,
+  0x49, 0x38, 0x8F, 0xF7, 0xFC, 0x80, 0x84, 0x00, 0x3F, 0x3A, 0xE7, 0x17,
+  0xD1, 0x30, 0xAC, 0x18, 0x07, 0x87, 0xC9, 0xD0, 0x37, 0xCF, 0x9F, 0x3E,
+  0x70, 0x75, 0x24, 0xA5, 0x38, 0xB0, 0x58, 0x0D, 0x06, 0x0C, 0xE3, 0x8A,
+  0x19, 0x3D, 0x00, 0x5E, 0x48, 0x55, 0x93, 0x58, 0x31, 0x2E, 0x73, 0x99,
+  0x05, 0x62, 0xF2, 0x00, 0xF6, 0x7C, 0xF9, 0xCF, 0x95, 0xC0, 0x8A, 0x91,
+  0x3C, 0x0C, 0x06, 0x83, 0x41, 0x90, 0x5E, 0x15, 0x65, 0x70, 0xC8, 0x5C,
+  0xAA, 0x06, 0x25, 0x9F, 0xFF, 0x9E, 0xBD, 0x54, 0x7C, 0x80, 0xBF, 0x1B,
+  0x9F, 0x3E, 0x6F, 0xAD, 0xF3, 0xE7, 0xCE, 0x7C, 0xF9, 0xF3, 0x7D, 0x80,
+  0x5A, 0x23, 0x29, 0x2C, 0x96, 0x2C, 0x16, 0x0A, 0xC9, 0x6A, 0x2C, 0x7A,
+  0x1C, 0xF9, 0xCB, 0xE8, 0x39, 0xF3, 0xAE, 0x7C, 0xF9, 0x3C, 0xE5, 0x29,
+  0x92, 0xC9, 0x64, 0x72, 0x38, 0xCC, 0x96, 0x1C, 0x78, 0xBB, 0x1A, 0xFF,
+  0xF7, 0x63, 0x5A, 0xD6, 0xB1, 0xAD, 0x2F, 0xC0, 0xD6, 0xB2, 0xFF, 0xCF,
+  0x9A, 0xD6, 0xB1, 0xAD, 0x6B, 0x58, 0xD6, 0xB0, 0x7C, 0x80, 0x37, 0x39,
+  0xCE, 0x78, 0x78, 0x91, 0x85, 0x69, 0x6E, 0x60, 0x56, 0x2B, 0x23, 0x50,
+  0xE2, 0xD8, 0x5D, 0x8D, 0x6B, 0x5A, 0xC6, 0xB5, 0xAD, 0x63, 0x5A, 0x5F,
+  0x80, 0x19, 0x39, 0x39, 0x50, 0xC0, 0x24, 0x42, 0x44, 0x24, 0x42, 0x44,
+  0x04, 0xA0, 0x22, 0x12, 0x24, 0xE9, 0x8C, 0x30, 0xDA, 0xC3, 0x23, 0x15,
+  0x8A, 0xC4, 0xC8, 0xC8, 0xC5, 0x69, 0xE5, 0x80, 0x5C, 0xA5, 0x0A, 0xD2,
+  0xCB, 0x6D, 0xB1, 0x2B, 0x84, 0xA5, 0xD0, 0x30, 0xE6, 0x95, 0x2A, 0xB2,
+  0x60, 0xB4, 0x5A, 0x2C, 0x29, 0xC9, 0x25, 0x28, 0x6B, 0x7E, 0x7E, 0x77,
+  0x90, 0x5A, 0x30, 0x49, 0x23, 0x38, 0xAC, 0x58, 0x2C, 0x16, 0x0C, 0xE5,
+  0x1C, 0x7A, 0x1F, 0x3E, 0x73, 0x7C, 0x80, 0x38, 0x76, 0x93, 0x6D, 0xEB,
+  0x9F, 0x3E, 0x73, 0xE6, 0xFB, 0x00, 0x5B, 0x22, 0x50, 0x30, 0x7B, 0x7D,
+  0x6A, 0x56, 0x9A, 0x81, 0x3D, 0x00, 0x2C, 0x63, 0x15, 0xE8, 0x63, 0x18,
+  0xB6, 0x31, 0x8A, 0x87, 0x40, 0x8C, 0xAD, 0x0B, 0x06, 0x03, 0x01, 0x80,
+  0xB8, 0x2C, 0x56, 0x2A, 0xC5, 0xC2, 0x80, 0x8E, 0x3D, 0x2C, 0x23, 0x52,
+  0x8D, 0x46, 0x4C, 0x06, 0x83, 0x52, 0xF5, 0x00, 0x8C, 0x7B, 0x2C, 0x16,
+  0x08, 0xC0, 0x81, 0x20, 0x40, 0x90, 0x24, 0x82, 0x54, 0x90, 0x4A, 0xA3,
+  0x32, 0xA0, 0x3A, 0x75, 0x1A, 0xC6, 0xD4, 0xDE, 0xBE, 0xCD, 0x83, 0x24,
+  0x6B, 0x1E, 0x3B, 0x00, 0x1A, 0xB4, 0xB1, 0x46, 0x6A, 0x5A, 0x97, 0x16,
+  0x83, 0xC9, 0x72, 0x5F, 0x3E, 0x7C, 0xFC, 0xDF, 0x20, 0x1F, 0x4A, 0xAC,
+  0xB2, 0xCB, 0x1A, 0xD6, 0x98, 0x7B, 0x00, 0xA9, 0x19, 0xA8, 0xCC, 0xD4,
+  0x55, 0x99, 0xA8, 0xCC, 0xCE, 0x80, 0xB1, 0x11, 0x01, 0x11, 0x01, 0x11,
+  0x10, 0x11, 0x40, 0x53, 0x33, 0x33, 0x51, 0x9A, 0xE4, 0xA3, 0x33, 0x35,
+  0x15, 0x00, 0x19, 0x49, 0x11, 0x5E, 0x40 };
+
+const PackedGlyph FreeMonoOblique12pt7bPackedGlyphs[] = {
+  {     0,   0,   0,  14,    0,    1 },    // 0x20 ' '
+  {     1,   4,  15,  14,    6,  -14 },    // 0x21 '!'
+  {     9,   8,   7,  14,    5,  -14 },    // 0x22 '"'
+  {    18,  11,  16,  14,    3,  -14 },    // 0x23 '#'
+  {    36,  10,  18,  14,    4,  -15 },    // 0x24 '$'
+  {    53,  11,  15,  14,    3,  -14 },    // 0x25 '%'
+  {    71,   9,  12,  14,    3,  -11 },    // 0x26 '&'
+  {    86,   3,   7,  14,    8,  -14 },    // 0x27 '''
+  {    91,   5,  18,  14,    8,  -14 },    // 0x28 '('
+  {   101,   5,  18,  14,    4,  -14 },    // 0x29 ')'
+  {   111,   9,   9,  14,    5,  -14 },    // 0x2A '*'
+  {   121,  11,  11,  14,    3,  -11 },    // 0x2B '+'
+  {   130,   6,   7,  14,    3,   -3 },    // 0x2C ','
+  {   136,  11,   1,  14,    3,   -6 },    // 0x2D '-'
+  {   138,   3,   3,  14,    6,   -2 },    // 0x2E '.'
+  {   140,  13,  18,  14,    2,  -15 },    // 0x2F '/'
+  {   153,  10,  15,  14,    4,  -14 },    // 0x30 '0'
+  {   171,   9,  15,  14,    3,  -14 },    // 0x31 '1'
+  {   183,  12,  15,  14,    2,  -14 },    // 0x32 '2'
+  {   198,  11,  15,  14,    3,  -14 },    // 0x33 '3'
+  {   212,  10,  15,  14,    3,  -14 },    // 0x34 '4'
+  {   227,  11,  15,  14,    3,  -14 },    // 0x35 '5'
+  {   241,  11,  15,  14,    4,  -14 },    // 0x36 '6'
+  {   258,  10,  15,  14,    5,  -14 },    // 0x37 '7'
+  {   270,  11,  15,  14,    3,  -14 },    // 0x38 '8'
+  {   287,  11,  15,  14,    3,  -14 },    // 0x39 '9'
+  {   304,   5,  10,  14,    5,   -9 },    // 0x3A ':'
+  {   310,   7,  13,  14,    3,   -9 },    // 0x3B ';'
+  {   320,  12,  11,  14,    3,  -11 },    // 0x3C '<'
+  {   330,  13,   4,  14,    2,   -8 },    // 0x3D '='
+  {   335,  12,  11,  14,    2,  -11 },    // 0x3E '>'
+  {   345,   8,  14,  14,    6,  -13 },    // 0x3F '?'
+  {   356,  10,  16,  14,    3,  -14 },    // 0x40 '@'
+  {   375,  14,  14,  14,    0,  -13 },    // 0x41 'A'
+  {   393,  13,  14,  14,    1,  -13 },    // 0x42 'B'
+  {   411,  12,  14,  14,    3,  -13 },    // 0x43 'C'
+  {   425,  13,  14,  14,    1,  -13 },    // 0x44 'D'
+  {   442,  14,  14,  14,    1,  -13 },    // 0x45 'E'
+  {   459,  14,  14,  14,    1,  -13 },    // 0x46 'F'
+  {   475,  12,  14,  14,    3,  -13 },    // 0x47 'G'
+  {   491,  15,  14,  14,    1,  -13 },    // 0x48 'H'
+  {   509,  11,  14,  14,    3,  -13 },    // 0x49 'I'
+  {   521,  15,  14,  14,    2,  -13 },    // 0x4A 'J'
+  {   537,  15,  14,  14,    1,  -13 },    // 0x4B 'K'
+  {   556,  12,  14,  14,    2,  -13 },    // 0x4C 'L'
+  {   569,  17,  14,  14,    0,  -13 },    // 0x4D 'M'
+  {   596,  15,  14,  14,    1,  -13 },    // 0x4E 'N'
+  {   620,  13,  14,  14,    2,  -13 },    // 0x4F 'O'
+  {   637,  13,  14,  14,    1,  -13 },    // 0x50 'P'
+  {   652,  13,  17,  14,    2,  -13 },    // 0x51 'Q'
+  {   672,  13,  14,  14,    1,  -13 },    // 0x52 'R'
+  {   689,  11,  14,  14,    3,  -13 },    // 0x53 'S'
+  {   705,  12,  14,  14,    4,  -13 },    // 0x54 'T'
+  {   718,  13,  14,  14,    3,  -13 },    // 0x55 'U'
+  {   736,  14,  14,  14,    3,  -13 },    // 0x56 'V'
+  {   754,  14,  14,  14,    3,  -13 },    // 0x57 'W'
+  {   780,  15,  14,  14,    1,  -13 },    // 0x58 'X'
+  {   798,  12,  14,  14,    4,  -13 },    // 0x59 'Y'
+  {   813,  12,  14,  14,    2,  -13 },    // 0x5A 'Z'
+  {   828,   7,  18,  14,    6,  -14 },    // 0x5B '['
+  {   839,   5,  18,  14,    6,  -15 },    // 0x5C '\'
+  {   849,   7,  18,  14,    3,  -14 },    // 0x5D ']'
+  {   860,   9,   6,  14,    5,  -14 },    // 0x5E '^'
+  {   866,  15,   1,  14,   -1,    3 },    // 0x5F '_'
+  {   869,   3,   4,  14,    6,  -15 },    // 0x60 '`'
+  {   872,  12,  10,  14,    2,   -9 },    // 0x61 'a'
+  {   884,  13,  15,  14,    1,  -14 },    // 0x62 'b'
+  {   903,  12,  10,  14,    3,   -9 },    // 0x63 'c'
+  {   916,  13,  15,  14,    2,  -14 },    // 0x64 'd'
+  {   935,  11,  10,  14,    3,   -9 },    // 0x65 'e'
+  {   946,  13,  15,  14,    3,  -14 },    // 0x66 'f'
+  {   960,  13,  14,  14,    3,   -9 },    // 0x67 'g'
+  {   976,  13,  15,  14,    1,  -14 },    // 0x68 'h'
+  {   993,  10,  15,  14,    2,  -14 },    // 0x69 'i'
+  {  1004,  10,  19,  14,    2,  -14 },    // 0x6A 'j'
+  {  1018,  12,  15,  14,    2,  -14 },    // 0x6B 'k'
+  {  1034,  10,  15,  14,    2,  -14 },    // 0x6C 'l'
+  {  1045,  14,  10,  14,    0,   -9 },    // 0x6D 'm'
+  {  1063,  12,  10,  14,    1,   -9 },    // 0x6E 'n'
+  {  1076,  11,  10,  14,    3,   -9 },    // 0x6F 'o'
+  {  1087,  14,  14,  14,    0,   -9 },    // 0x70 'p'
+  {  1105,  13,  14,  14,    3,   -9 },    // 0x71 'q'
+  {  1123,  13,  10,  14,    2,   -9 },    // 0x72 'r'
+  {  1134,  10,  10,  14,    3,   -9 },    // 0x73 's'
+  {  1146,   9,  14,  14,    3,  -13 },    // 0x74 't'
+  {  1157,  12,  10,  14,    2,   -9 },    // 0x75 'u'
+  {  1171,  13,  10,  14,    3,   -9 },    // 0x76 'v'
+  {  1184,  13,  10,  14,    3,   -9 },    // 0x77 'w'
+  {  1202,  14,  10,  14,    1,   -9 },    // 0x78 'x'
+  {  1216,  14,  14,  14,    1,   -9 },    // 0x79 'y'
+  {  1233,  11,  10,  14,    3,   -9 },    // 0x7A 'z'
+  {  1243,   7,  18,  14,    5,  -14 },    // 0x7B '{'
+  {  1254,   4,  17,  14,    6,  -13 },    // 0x7C '|'
+  {  1263,   7,  18,  14,    4,  -14 },    // 0x7D '}'
+  {  1274,  11,   3,  14,    3,   -7 } };   // 0x7E '~'
+
+const PackedFont FreeMonoOblique12pt7bPacked = {
+  FreeMonoOblique12pt7bPackedBitmaps,
+  FreeMonoOblique12pt7bPackedGlyphs,
+  0x20, 0x7E, 24,
+  nullptr,
+  { { 0, 0, 0, 4, 7, 1, 1, 1, 2, 0, 0, 0, 0 },
+    { 2, 3, 4, 6, 0, 1, 5, 7, 8, 9, 11, 10, 12, 13, 14, 15 } },
+  { { 0, 1, 1, 0, 3, 0, 2, 2, 3, 1, 2, 0, 0 },
+    { 1, 2, 3, 4, 5, 6, 9, 7, 8, 10, 11, 12, 15, 0, 13, 0 } } };
@@ -1,61 +1,68 @@
+#define FreeMonoOblique12pt_subChars " 0123456789.+-/%ChPa"
+
 const uint8_t FreeMonoOblique12pt_subBitmaps[] PROGMEM = {
-  0x00, 0x07, 0x06, 0x23, 0x04, 0x81, 0x40, 0x50, 0x14, 0x06, 0x02, 0x80,
-  0xA0, 0x28, 0x0A, 0x04, 0x83, 0x11, 0x83, 0xC0, 0x03, 0x03, 0x83, 0x83,
-  0x43, 0x20, 0x10, 0x08, 0x08, 0x04, 0x02, 0x01, 0x01, 0x00, 0x80, 0x43,
-  0xFE, 0x01, 0xC0, 0x62, 0x04, 0x10, 0x81, 0x00, 0x10, 0x02, 0x00, 0x60,
-  0x0C, 0x01, 0x00, 0x20, 0x0C, 0x01, 0x80, 0x20, 0x04, 0x04, 0xFF, 0xC0,
-  0x07, 0xC3, 0x0C, 0x00, 0x80, 0x10, 0x02, 0x01, 0x81, 0xC0, 0x0C, 0x00,
-  0x40, 0x08, 0x01, 0x00, 0x20, 0x09, 0x86, 0x0F, 0x00, 0x00, 0xC0, 0x50,
-  0x24, 0x12, 0x04, 0x82, 0x21, 0x08, 0x82, 0x21, 0x10, 0x4F, 0xF8, 0x04,
-  0x01, 0x00, 0x80, 0xF8, 0x0F, 0xE2, 0x00, 0x40, 0x08, 0x01, 0x00, 0x4E,
-  0x0E, 0x20, 0x02, 0x00, 0x40, 0x08, 0x01, 0x00, 0x40, 0x19, 0x06, 0x1F,
-  0x00, 0x01, 0xE0, 0xC0, 0x60, 0x18, 0x02, 0x00, 0x80, 0x13, 0xC5, 0x8C,
-  0xE0, 0x98, 0x12, 0x02, 0x40, 0x48, 0x10, 0x84, 0x0F, 0x00, 0xFF, 0xA0,
-  0x20, 0x08, 0x04, 0x01, 0x00, 0x80, 0x20, 0x10, 0x04, 0x02, 0x00, 0x80,
-  0x40, 0x10, 0x08, 0x02, 0x00, 0x07, 0x81, 0x08, 0x40, 0x90, 0x12, 0x02,
-  0x40, 0x84, 0x20, 0x78, 0x30, 0x88, 0x0A, 0x01, 0x40, 0x28, 0x08, 0x82,
-  0x0F, 0x00, 0x07, 0x81, 0x08, 0x40, 0x90, 0x12, 0x02, 0x40, 0xC8, 0x39,
-  0x8D, 0x1E, 0x40, 0x08, 0x02, 0x00, 0xC0, 0x30, 0x18, 0x3C, 0x00, 0x7F,
-  0x00, 0x02, 0x00, 0x40, 0x08, 0x03, 0x00, 0x41, 0xFF, 0xC1, 0x00, 0x20,
-  0x08, 0x01, 0x00, 0x20, 0x00, 0xFF, 0xE0, 0x00, 0x08, 0x00, 0x80, 0x04,
-  0x00, 0x40, 0x04, 0x00, 0x60, 0x02, 0x00, 0x20, 0x03, 0x00, 0x10, 0x01,
-  0x00, 0x18, 0x00, 0x80, 0x08, 0x00, 0x80, 0x04, 0x00, 0x40, 0x04, 0x00,
-  0x00, 0x0E, 0x02, 0x20, 0x84, 0x10, 0x82, 0x20, 0x38, 0x00, 0x38, 0x38,
-  0x38, 0x08, 0xE0, 0x22, 0x08, 0x41, 0x08, 0x22, 0x03, 0x80, 0x07, 0x91,
-  0x87, 0x20, 0x34, 0x02, 0x40, 0x08, 0x00, 0x80, 0x08, 0x00, 0x80, 0x08,
-  0x00, 0x80, 0x04, 0x04, 0x61, 0x81, 0xE0, 0x1C, 0x00, 0x20, 0x03, 0x00,
-  0x10, 0x00, 0x80, 0x05, 0xF0, 0x30, 0xC3, 0x02, 0x10, 0x10, 0x80, 0x84,
-  0x0C, 0x20, 0x63, 0x02, 0x10, 0x13, 0xE3, 0xE0, 0x1F, 0xE0, 0x60, 0xC2,
-  0x02, 0x10, 0x10, 0x80, 0x84, 0x08, 0x60, 0x83, 0xF8, 0x10, 0x00, 0x80,
-  0x04, 0x00, 0x60, 0x02, 0x00, 0x7F, 0x00, 0x1F, 0xC0, 0x06, 0x00, 0x20,
-  0x02, 0x1F, 0xE6, 0x04, 0xC0, 0x48, 0x04, 0x81, 0xC7, 0xEF };
+  0x07, 0x06, 0x23, 0x04, 0x81, 0x40, 0x50, 0x14, 0x06, 0x02, 0x80, 0xA0,
+  0x28, 0x0A, 0x04, 0x83, 0x11, 0x83, 0x80, 0x03, 0x03, 0x83, 0x83, 0x43,
+  0x20, 0x10, 0x08, 0x08, 0x04, 0x02, 0x01, 0x01, 0x00, 0x80, 0x43, 0xFE,
+  0x01, 0xC0, 0x62, 0x0C, 0x10, 0x81, 0x00, 0x10, 0x02, 0x00, 0x60, 0x0C,
+  0x01, 0x00, 0x20, 0x0C, 0x01, 0x80, 0x20, 0x04, 0x04, 0xFF, 0xC0, 0x07,
+  0xC3, 0x0C, 0x00, 0x80, 0x10, 0x06, 0x01, 0x81, 0xC0, 0x0C, 0x00, 0x40,
+  0x08, 0x01, 0x00, 0x20, 0x09, 0x86, 0x0F, 0x00, 0x00, 0xC0, 0x50, 0x24,
+  0x12, 0x04, 0x82, 0x21, 0x08, 0x82, 0x21, 0x10, 0x4F, 0xF8, 0x04, 0x01,
+  0x00, 0x80, 0xF8, 0x0F, 0xE2, 0x00, 0x40, 0x08, 0x01, 0x00, 0x4E, 0x0E,
+  0x20, 0x02, 0x00, 0x40, 0x08, 0x01, 0x00, 0x40, 0x19, 0x06, 0x1F, 0x00,
+  0x01, 0xE0, 0xC0, 0x60, 0x18, 0x02, 0x00, 0x80, 0x13, 0xC5, 0x88, 0xE0,
+  0x98, 0x12, 0x02, 0x40, 0x48, 0x10, 0x84, 0x0F, 0x00, 0xFF, 0xA0, 0x20,
+  0x08, 0x04, 0x01, 0x00, 0x80, 0x20, 0x10, 0x04, 0x02, 0x00, 0x80, 0x40,
+  0x10, 0x08, 0x02, 0x00, 0x07, 0x81, 0x08, 0x40, 0x90, 0x12, 0x02, 0x40,
+  0x84, 0x20, 0x78, 0x30, 0x88, 0x0A, 0x01, 0x40, 0x28, 0x08, 0x82, 0x0F,
+  0x80, 0x07, 0x81, 0x08, 0x40, 0x90, 0x12, 0x02, 0x40, 0xC8, 0x39, 0x8D,
+  0x1E, 0x40, 0x08, 0x02, 0x00, 0xC0, 0x30, 0x18, 0x3E, 0x00, 0x7F, 0x00,
+  0x02, 0x00, 0x40, 0x08, 0x02, 0x00, 0x41, 0xFF, 0xC1, 0x00, 0x20, 0x08,
+  0x01, 0x00, 0x20, 0x00, 0xFF, 0xE0, 0x00, 0x08, 0x00, 0x80, 0x04, 0x00,
+  0x40, 0x04, 0x00, 0x60, 0x02, 0x00, 0x20, 0x03, 0x00, 0x10, 0x01, 0x00,
+  0x18, 0x00, 0x80, 0x08, 0x00, 0x80, 0x04, 0x00, 0x40, 0x04, 0x00, 0x00,
+  0x0E, 0x02, 0x20, 0x84, 0x10, 0x82, 0x20, 0x38, 0x00, 0x38, 0x38, 0x38,
+  0x08, 0xE0, 0x22, 0x08, 0x41, 0x08, 0x22, 0x03, 0x80, 0x07, 0x91, 0x87,
+  0x20, 0x34, 0x02, 0x40, 0x08, 0x00, 0x80, 0x08, 0x00, 0x80, 0x08, 0x00,
+  0x80, 0x04, 0x04, 0x61, 0x81, 0xE0, 0x1C, 0x00, 0x20, 0x03, 0x00, 0x10,
+  0x00, 0x80, 0x05, 0xF0, 0x30, 0xC3, 0x02, 0x10, 0x10, 0x80, 0x84, 0x0C,
+  0x20, 0x63, 0x02, 0x10, 0x13, 0xE3, 0xE0, 0x1F, 0xE0, 0x40, 0x82, 0x02,
+  0x10, 0x10, 0x80, 0x84, 0x08, 0x40, 0x83, 0xF8, 0x10, 0x00, 0x80, 0x04,
+  0x00, 0x60, 0x02, 0x00, 0x7F, 0x00, 0x1F, 0xC0, 0x06, 0x00, 0x20, 0x02,
+  0x1F, 0xE6, 0x04, 0xC0, 0x48, 0x04, 0x81, 0xC7, 0xEF };
 
 const GFXglyph FreeMonoOblique12pt_subGlyphs[] PROGMEM = {
-  {     0,   1,   1,  14,    0,    0 },   // 0x20 ' '
-  {     1,  10,  15,  14,    4,  -14 },   // 0x30 '0'
-  {    20,   9,  15,  14,    3,  -14 },   // 0x31 '1'
-  {    37,  12,  15,  14,    2,  -14 },   // 0x32 '2'
-  {    60,  11,  15,  14,    3,  -14 },   // 0x33 '3'
-  {    81,  10,  15,  14,    3,  -14 },   // 0x34 '4'
-  {   100,  11,  15,  14,    3,  -14 },   // 0x35 '5'
-  {   121,  11,  15,  14,    4,  -14 },   // 0x36 '6'
-  {   142,  10,  15,  14,    5,  -14 },   // 0x37 '7'
-  {   161,  11,  15,  14,    3,  -14 },   // 0x38 '8'
-  {   182,  11,  15,  14,    3,  -14 },   // 0x39 '9'
-  {   203,   3,   3,  14,    6,   -2 },   // 0x2E '.'
-  {   205,  11,  11,  14,    3,  -11 },   // 0x2B '+'
-  {   221,  11,   1,  14,    3,   -6 },   // 0x2D '-'
-  {   223,  13,  18,  14,    2,  -15 },   // 0x2F '/'
-  {   253,  11,  15,  14,    3,  -14 },   // 0x25 '%'
-  {   274,  12,  14,  14,    3,  -13 },   // 0x43 'C'
-  {   295,  13,  15,  14,    1,  -14 },   // 0x68 'h'
-  {   320,  13,  14,  14,    1,  -13 },   // 0x50 'P'
-  {   343,  12,  10,  14,    2,   -9 } }; // 0x61 'a'
+  {     0,   0,   0,  14,    0,    1 },   // 0x20 ' '
+  {     0,  10,  15,  14,    4,  -14 },   // 0x30 '0'
+  {    19,   9,  15,  14,    3,  -14 },   // 0x31 '1'
+  {    36,  12,  15,  14,    2,  -14 },   // 0x32 '2'
+  {    59,  11,  15,  14,    3,  -14 },   // 0x33 '3'
+  {    80,  10,  15,  14,    3,  -14 },   // 0x34 '4'
+  {    99,  11,  15,  14,    3,  -14 },   // 0x35 '5'
+  {   120,  11,  15,  14,    4,  -14 },   // 0x36 '6'
+  {   141,  10,  15,  14,    5,  -14 },   // 0x37 '7'
+  {   160,  11,  15,  14,    3,  -14 },   // 0x38 '8'
+  {   181,  11,  15,  14,    3,  -14 },   // 0x39 '9'
+  {   202,   3,   3,  14,    6,   -2 },   // 0x2E '.'
+  {   204,  11,  11,  14,    3,  -11 },   // 0x2B '+'
+  {   220,  11,   1,  14,    3,   -6 },   // 0x2D '-'
+  {   222,  13,  18,  14,    2,  -15 },   // 0x2F '/'
+  {   252,  11,  15,  14,    3,  -14 },   // 0x25 '%'
+  {   273,  12,  14,  14,    3,  -13 },   // 0x43 'C'
+  {   294,  13,  15,  14,    1,  -14 },   // 0x68 'h'
+  {   319,  13,  14,  14,    1,  -13 },   // 0x50 'P'
+  {   342,  12,  10,  14,    2,   -9 } }; // 0x61 'a'
 
 const GFXfont FreeMonoOblique12pt_sub PROGMEM = {
   (uint8_t  *)FreeMonoOblique12pt_subBitmaps,
   (GFXglyph *)FreeMonoOblique12pt_subGlyphs,
   0x01, 0x15, 24,
-  " 0123456789.+-/%ChPa" };
+  FreeMonoOblique12pt_subChars };
+
+#ifdef __cplusplus
+#include "font_index.h"
+constexpr SubsetIndex FreeMonoOblique12pt_subIndex = subsetIndex(FreeMonoOblique12pt_subChars);
+#endif
 
-// Approx. 527 bytes
+// Approx. 525 bytes
@@ -0,0 +1,66 @@
+// FreeMonoOblique12pt_sub.h packed by tools/epd_fontpack.cpp (include/glyph_codec.h); regenerate, don't edit.
+// 357 bitmap bytes as 252 bytes of runs and 58 of codes.
+
+#pragma once
+
+#include "glyph_codec.h"
+#include "font_index.h"
+
+#define FreeMonoOblique12pt_subPackedChars " 0123456789.+-/%ChPa"
+
+const uint8_t FreeMonoOblique12pt_subPackedBitmaps[] = {
+  0xF0, 0x58, 0xA9, 0x4C, 0x81, 0x48, 0x34, 0x1A, 0x0E, 0x68, 0x34, 0x1A,
+  0x0D, 0x0A, 0x02, 0xA5, 0x32, 0xCF, 0x00, 0xAA, 0xB1, 0x62, 0xA0, 0x60,
+  0xB5, 0x9A, 0xD6, 0xB3, 0x5A, 0xC7, 0xD0, 0x78, 0xE9, 0x29, 0x0A, 0x9C,
+  0xD6, 0xD9, 0x63, 0x59, 0x65, 0x8D, 0x30, 0xFF, 0xE0, 0x5C, 0x31, 0xB5,
+  0xAC, 0xAE, 0xAC, 0xDB, 0x9A, 0xD6, 0xB0, 0x23, 0x2D, 0xF0, 0xB9, 0xA1,
+  0x40, 0x40, 0xA0, 0x24, 0x88, 0xA4, 0x92, 0x29, 0x20, 0xF6, 0xD8, 0xB3,
+  0xE7, 0x80, 0x3D, 0x96, 0xB5, 0xAC, 0x0C, 0x59, 0x2E, 0x6B, 0x5A, 0xC6,
+  0x40, 0xA3, 0xCF, 0x00, 0x7A, 0xA7, 0x5D, 0x8C, 0x68, 0x6C, 0xA2, 0x94,
+  0xE2, 0x0A, 0x80, 0xC0, 0xC1, 0x42, 0x2A, 0xDF, 0x00, 0xF7, 0xB0, 0x6C,
+  0x5B, 0x16, 0xC5, 0xB1, 0x6C, 0x5B, 0x16, 0xC7, 0x80, 0x5B, 0x42, 0x2A,
+  0x03, 0x03, 0x05, 0x08, 0xAB, 0x54, 0x52, 0x68, 0x5A, 0x16, 0x83, 0x49,
+  0x17, 0x3C, 0x5B, 0x42, 0x2A, 0x03, 0x03, 0x05, 0x40, 0xB0, 0x53, 0x42,
+  0x74, 0x35, 0x8C, 0xAE, 0x72, 0xE7, 0x80, 0x8E, 0xF8, 0xA6, 0xB5, 0x8D,
+  0x2F, 0x93, 0x58, 0xD6, 0xBC, 0xF7, 0xC0, 0xF9, 0xCF, 0x9C, 0xE7, 0x5C,
+  0xE7, 0x5C, 0xE7, 0x5C, 0xE7, 0x3E, 0x73, 0x9E, 0x38, 0xD2, 0x42, 0x42,
+  0x49, 0x3C, 0xFF, 0x16, 0x2C, 0x69, 0xC6, 0x92, 0x12, 0x12, 0x49, 0xE7,
+  0x80, 0x5A, 0x13, 0x1C, 0x07, 0x42, 0xC1, 0xAE, 0x73, 0x9C, 0xE7, 0xC6,
+  0x98, 0xD5, 0xBE, 0x9C, 0xF9, 0xD7, 0x3E, 0x7C, 0x8E, 0x54, 0x63, 0x50,
+  0x98, 0x98, 0xAA, 0x2A, 0xA6, 0xA1, 0x30, 0xE4, 0xF0, 0x9F, 0x29, 0x44,
+  0x62, 0x62, 0x62, 0xA1, 0x51, 0x76, 0x9F, 0x3E, 0x75, 0xCD, 0xEF, 0x80,
+  0x9E, 0xF5, 0xCE, 0x1F, 0x05, 0x41, 0x30, 0x58, 0x2B, 0x27, 0xF4, 0x68 };
+
+const PackedGlyph FreeMonoOblique12pt_subPackedGlyphs[] = {
+  {     0,   0,   0,  14,    0,    1 },    // 0x20 ' '
+  {     1,  10,  15,  14,    4,  -14 },    // 0x30 '0'
+  {    19,   9,  15,  14,    3,  -14 },    // 0x31 '1'
+  {    31,  12,  15,  14,    2,  -14 },    // 0x32 '2'
+  {    45,  11,  15,  14,    3,  -14 },    // 0x33 '3'
+  {    58,  10,  15,  14,    3,  -14 },    // 0x34 '4'
+  {    74,  11,  15,  14,    3,  -14 },    // 0x35 '5'
+  {    88,  11,  15,  14,    4,  -14 },    // 0x36 '6'
+  {   105,  10,  15,  14,    5,  -14 },    // 0x37 '7'
+  {   117,  11,  15,  14,    3,  -14 },    // 0x38 '8'
+  {   134,  11,  15,  14,    3,  -14 },    // 0x39 '9'
+  {   151,   3,   3,  14,    6,   -2 },    // 0x2E '.'
+  {   153,  11,  11,  14,    3,  -11 },    // 0x2B '+'
+  {   161,  11,   1,  14,    3,   -6 },    // 0x2D '-'
+  {   163,  13,  18,  14,    2,  -15 },    // 0x2F '/'
+  {   176,  11,  15,  14,    3,  -14 },    // 0x25 '%'
+  {   193,  12,  14,  14,    3,  -13 },    // 0x43 'C'
+  {   207,  13,  15,  14,    1,  -14 },    // 0x68 'h'
+  {   225,  13,  14,  14,    1,  -13 },    // 0x50 'P'
+  {   240,  12,  10,  14,    2,   -9 } };   // 0x61 'a'
+
+const PackedFont FreeMonoOblique12pt_subPacked = {
+  FreeMonoOblique12pt_subPackedBitmaps,
+  FreeMonoOblique12pt_subPackedGlyphs,
+  0x01, 0x15, 24,
+  FreeMonoOblique12pt_subPackedChars,
+  { { 0, 0, 0, 4, 7, 1, 2, 0, 0, 0, 0, 0, 0 },
+    { 2, 4, 5, 7, 1, 3, 6, 8, 9, 10, 11, 0, 12, 13, 0, 0 } },
+  { { 0, 1, 1, 0, 2, 2, 3, 2, 0, 0, 0, 0, 0 },
+    { 1, 2, 3, 4, 5, 7, 8, 9, 11, 6, 10, 0, 0, 0, 0, 0 } } };
+
+constexpr SubsetIndex FreeMonoOblique12pt_subPackedIndex = subsetIndex(FreeMonoOblique12pt_subPackedChars);
@@ -12,7 +12,7 @@
 #ifndef TEXTFONTS_H
 #define TEXTFONTS_H
 
-const char Font[] = {
+const unsigned char Font[] = {
 0x00, 0x00, 0x00, 0x00, 0x00,
 0x00, 0x00, 0x5F, 0x00, 0x00,
 0x00, 0x07, 0x00, 0x07, 0x00,
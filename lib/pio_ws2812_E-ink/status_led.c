@@ -0,0 +1,153 @@
+// --------------------------------------------------------------------------
+// Dioda statusu WS2812: alarm sprzętowy liczy wzór, DMA karmi FIFO PIO
+// --------------------------------------------------------------------------
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/timer.h"
+#include "status_led.h"
+
+typedef enum {
+    PATTERN_STEADY,
+    PATTERN_BLINK,      // pół okresu świeci, pół nie
+    PATTERN_BREATHE,    // trójkąt jasności z korekcją x^2
+    PATTERN_PROGRESS    // kolejne piksele zapalane wg status_led_progress()
+} pattern_t;
+
+typedef struct {
+    uint32_t grb;        // kolor jak w urgb_u32(): G<<16 | R<<8 | B
+    uint8_t pattern;
+    uint16_t period_ms;
+} look_t;
+
+// Kolory te same co dawne put_pixel() między krokami EPD; błąd ma własny
+// (magenta), żeby nie mylił się z READY
+static const look_t looks[STATUS_LED_STATE_COUNT] = {
+    [STATUS_LED_OFF]       = { 0x000000, PATTERN_STEADY,   0    },
+    [STATUS_LED_START]     = { 0x101010, PATTERN_STEADY,   0    },
+    [STATUS_LED_RENDERING] = { 0x101010, PATTERN_BREATHE,  1000 },
+    [STATUS_LED_SPI]       = { 0x100000, PATTERN_PROGRESS, 0    },
+    [STATUS_LED_BUSY]      = { 0x100000, PATTERN_BREATHE,  2000 },
+    [STATUS_LED_READY]     = { 0x002000, PATTERN_STEADY,   0    },
+    [STATUS_LED_SLEEP]     = { 0x000040, PATTERN_BREATHE,  4000 },
+    [STATUS_LED_ERROR]     = { 0x004040, PATTERN_BLINK,    250  },
+};
+
+static struct {
+    PIO pio;
+    uint sm;
+    uint num_pixels;
+    int dma_chan;
+    int alarm;
+    absolute_time_t next_tick;
+    volatile uint8_t state;      // zapisuje status_led_set(), czyta alarm
+    volatile bool error;         // zatrzaśnięty STATUS_LED_ERROR, przykrywa state
+    volatile uint8_t progress;
+    uint8_t shown;               // stan, którego wzór leci
+    uint32_t phase_ms;
+    uint32_t pixels[STATUS_LED_MAX_PIXELS];   // czyta DMA, nie ruszać w trakcie
+    bool sent;
+} led = { .dma_chan = -1, .alarm = -1 };
+
+// Jasność 0..255 piksela i w chwili phase_ms wzoru
+static uint8_t pattern_level(const look_t *look, uint i, uint32_t phase_ms){
+    switch (look->pattern){
+    case PATTERN_BLINK:
+        return phase_ms % look->period_ms < look->period_ms / 2 ? 255 : 0;
+    case PATTERN_BREATHE: {
+        const uint32_t half = look->period_ms / 2;
+        const uint32_t t = phase_ms % look->period_ms;
+        const uint32_t tri = (t < half ? t : look->period_ms - t) * 255 / half;
+        return (uint8_t)(tri * tri / 255);
+    }
+    case PATTERN_PROGRESS: {
+        // postęp rozłożony na piksele; przy jednym pikselu to jasność
+        const int32_t lit = (int32_t)led.progress * (int32_t)led.num_pixels - 100 * (int32_t)i;
+        if (lit <= 0) return 0;
+        return lit >= 100 ? 255 : (uint8_t)(lit * 255 / 100);
+    }
+    default:
+        return 255;
+    }
+}
+
+static uint32_t scale_grb(uint32_t grb, uint8_t level){
+    uint32_t out = 0;
+    for (uint shift = 0; shift < 24; shift += 8){
+        out |= (((grb >> shift) & 0xFF) * level / 255) << shift;
+    }
+    return out;
+}
+
+// Przerwanie alarmu: kilka mikrosekund co STATUS_LED_TICK_MS, nigdy nie czeka
+static void status_led_tick(uint alarm){
+    do {
+        led.next_tick = delayed_by_ms(led.next_tick, STATUS_LED_TICK_MS);
+    } while (hardware_alarm_set_target(alarm, led.next_tick));   // minięte tyknięcia przepadają
+
+    const uint8_t state = led.error ? STATUS_LED_ERROR : led.state;
+    if (state != led.shown){
+        led.shown = state;
+        led.phase_ms = 0;
+    } else {
+        led.phase_ms += STATUS_LED_TICK_MS;
+    }
+
+    const look_t *look = &looks[state];
+    uint32_t frame[STATUS_LED_MAX_PIXELS];
+    for (uint i = 0; i < led.num_pixels; i++){
+        // ws2812.pio wysyła od najstarszego bitu 24 (RGB) lub 32 bity (RGBW, W = 0)
+        frame[i] = scale_grb(look->grb, pattern_level(look, i, led.phase_ms)) << 8u;
+    }
+    // poprzednia ramka jeszcze w drodze albo nic się nie zmieniło: pomiń
+    if (dma_channel_is_busy((uint)led.dma_chan)) return;
+    if (led.sent && memcmp(frame, led.pixels, led.num_pixels * sizeof(frame[0])) == 0) return;
+    memcpy(led.pixels, frame, led.num_pixels * sizeof(frame[0]));
+    led.sent = true;
+    dma_channel_transfer_from_buffer_now((uint)led.dma_chan, led.pixels, led.num_pixels);
+}
+
+void status_led_init(PIO pio, uint sm, uint num_pixels){
+    led.pio = pio;
+    led.sm = sm;
+    led.num_pixels = num_pixels < STATUS_LED_MAX_PIXELS ? num_pixels : STATUS_LED_MAX_PIXELS;
+    led.shown = led.error ? STATUS_LED_ERROR : led.state;
+    led.phase_ms = 0;
+    led.sent = false;
+
+    // DMA bez przerwania: jedna ramka to kilka słów, alarm sprawdza tylko busy
+    led.dma_chan = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config((uint)led.dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_dreq(&c, pio_get_dreq(pio, sm, true));
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    dma_channel_configure((uint)led.dma_chan, &c, &pio->txf[sm], led.pixels, 0, false);
+
+    // Najniższy priorytet: IRQ DMA panelu (epd_spi.c) zawsze wywłaszcza diodę
+    led.alarm = hardware_alarm_claim_unused(true);
+    hardware_alarm_set_callback((uint)led.alarm, status_led_tick);
+    irq_set_priority(hardware_alarm_get_irq_num((uint)led.alarm), PICO_LOWEST_IRQ_PRIORITY);
+    led.next_tick = get_absolute_time();
+    status_led_tick((uint)led.alarm);
+}
+
+void status_led_set(status_led_state_t state){
+    if ((unsigned)state >= STATUS_LED_STATE_COUNT) state = STATUS_LED_ERROR;
+    if (state == STATUS_LED_ERROR) led.error = true;
+    else led.state = (uint8_t)state;
+}
+
+void status_led_clear_error(void){
+    led.error = false;
+}
+
+status_led_state_t status_led_get(void){
+    return led.error ? STATUS_LED_ERROR : (status_led_state_t)led.state;
+}
+
+void status_led_progress(uint8_t percent){
+    led.progress = percent > 100 ? 100 : percent;
+}
@@ -0,0 +1,56 @@
+// --------------------------------------------------------------------------
+// Dioda statusu WS2812 bez blokowania
+//
+// Wzór (miganie, oddech, postęp) liczy przerwanie alarmu sprzętowego co
+// STATUS_LED_TICK_MS, piksele do FIFO maszyny PIO przepisuje kanał DMA.
+// CPU niczego nie czeka: dioda animuje się także wtedy, gdy program stoi
+// w epd_update() albo w pętli czekania na BUSY.
+// --------------------------------------------------------------------------
+
+#ifndef STATUS_LED_H
+#define STATUS_LED_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "hardware/pio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define STATUS_LED_TICK_MS   20
+#define STATUS_LED_MAX_PIXELS 8
+
+typedef enum {
+    STATUS_LED_OFF,
+    STATUS_LED_START,       // zasilanie, inicjalizacja
+    STATUS_LED_RENDERING,   // rysowanie ramki w RAM
+    STATUS_LED_SPI,         // wysyłka płaszczyzn, wzór postępu
+    STATUS_LED_BUSY,        // panel odświeża, czekamy na BUSY
+    STATUS_LED_READY,       // odświeżenie zakończone
+    STATUS_LED_SLEEP,       // panel w deep sleep
+    STATUS_LED_ERROR,       // np. przekroczony czas BUSY
+    STATUS_LED_STATE_COUNT
+} status_led_state_t;
+
+// Maszyna sm musi już wykonywać program ws2812 (ws2812_program_init).
+// Zajmuje wolny kanał DMA i wolny alarm sprzętowy.
+void status_led_init(PIO pio, uint sm, uint num_pixels);
+
+// Z dowolnego miejsca, także z przerwania: tylko zapis zmiennej, wzór
+// zaczyna się od początku przy najbliższym tyknięciu alarmu.
+// STATUS_LED_ERROR się zatrzaskuje: późniejsze stany (np. fazy z
+// epd_on_phase) są zapamiętywane, ale dioda pokazuje błąd aż do
+// status_led_clear_error(), po którym wraca do ostatniego z nich.
+void status_led_set(status_led_state_t state);
+void status_led_clear_error(void);
+status_led_state_t status_led_get(void);
+
+// 0..100, dla wzoru postępu (STATUS_LED_SPI)
+void status_led_progress(uint8_t percent);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
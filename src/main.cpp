@@ -1,8 +1,23 @@
 #include <Arduino.h>
 #include <SPI.h>
 #include <GxEPD2_3C.h>
-#include <ctype.h>
+#include <hardware/dma.h>
+#include <hardware/irq.h>
+#include <hardware/spi.h>
+#include "plane_display.h"
+#include "dirty_region.h"
+#include "refresh_engine.h"
+#include "command_queue.h"
+#include "spsc_ring.h"
+#include "frame_protocol.h"
+#include "row_codec.h"
+#include "bus_profiler.h"
+#include "refresh_telemetry.h"
+#include "panel_traits.h"
+#include "frame_diff.h"
+#include <strings.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define PIN_SCK   2
 #define PIN_MOSI  3
@@ -12,14 +27,177 @@
 #define PIN_RST   7
 #define PIN_BUSY  8
 
+// 1 = panel work (rendering, SPI, BUSY) runs on core1 and core0 only reads
+// the console; set with build_flags = -DEPD_RENDER_CORE1=1
+#ifndef EPD_RENDER_CORE1
+#define EPD_RENDER_CORE1 0
+#endif
+
+// 1 = echo every raw command/data byte as "[TRC] C xx" / "[TRC] D xx .."
+// lines, which tools/epd_sim.c can replay off-target
+#ifndef EPD_TRACE_RAW
+#define EPD_TRACE_RAW 0
+#endif
+
+// 1 = count commands, data bytes, CS windows and bus/BUSY time per opcode
+// for the 'stats' command; 0 compiles the profiler and the command out
+#ifndef EPD_BUS_STATS
+#define EPD_BUS_STATS 0
+#endif
+
+// 1 = keep phase timings of the last REFRESH_HISTORY refreshes for the
+// 'timing' command; 0 compiles them out
+#ifndef EPD_REFRESH_TELEMETRY
+#define EPD_REFRESH_TELEMETRY 0
+#endif
+
+#define EPD_BUS_OBSERVED (EPD_BUS_STATS || EPD_REFRESH_TELEMETRY)
+
+// Rows per page; 0 keeps the whole frame in RAM. Otherwise the frame is
+// drawn into two page buffers of this many rows, one drawn while the other
+// is sent, and a page that hashes the same as the last one sent there is
+// not sent again; set with build_flags = -DEPD_PAGE_ROWS=16
+#ifndef EPD_PAGE_ROWS
+#define EPD_PAGE_ROWS 0
+#endif
+
+// 1 = keep a copy of the planes last written to the controller and send
+// only the rows and byte columns that changed since; costs two full planes
+// of RAM, so paged builds go without
+#ifndef EPD_FRAME_DIFF
+#define EPD_FRAME_DIFF (EPD_PAGE_ROWS == 0)
+#endif
+#if EPD_FRAME_DIFF && EPD_PAGE_ROWS > 0
+#error "EPD_FRAME_DIFF needs the whole frame in RAM (EPD_PAGE_ROWS=0)"
+#endif
+
+// After the flags: 'stats' and 'timing' are in the table only when enabled
+#include "console_commands.h"
+
 static constexpr uint32_t BUSY_TIMEOUT_MS = 9000;
 static constexpr uint32_t BUSY_TIMEOUT_US = BUSY_TIMEOUT_MS * 1000UL;
+// Above this share of the screen a partial window buys nothing over a full refresh
+static constexpr uint8_t PARTIAL_MAX_AREA_PCT = 75;
+// Each partial window is its own refresh; more dirty boxes are merged down.
+// Without a fast partial waveform (Panel::fastPartialRefresh) they are all
+// merged into one window, refreshed in the background like a full frame.
+static constexpr uint8_t PARTIAL_MAX_WINDOWS = 2;
+static constexpr size_t SERIAL_LINE_MAX = 96;
+static constexpr size_t COMMAND_QUEUE_DEPTH = 8;
+// Pending redraws wait for this much input silence so pasted batches coalesce
+static constexpr uint32_t COALESCE_QUIET_MS = 50;
+static constexpr size_t RENDER_QUEUE_DEPTH = 4;
+static constexpr uint32_t CORE1_START = 0x45504431; // "EPD1"
+static constexpr size_t REFRESH_HISTORY = 32;
+// The panel the display driver and the raw paths are built for
+using Panel = Panel213c;
+static_assert(Panel::width == GxEPD2_213c::WIDTH && Panel::height == GxEPD2_213c::HEIGHT,
+              "Panel traits do not match GxEPD2_213c");
+static_assert(Panel::fastPartialRefresh == GxEPD2_213c::hasFastPartialUpdate,
+              "Panel traits do not match GxEPD2_213c");
+// Controller the raw lab commands (gate, hs, diag) address
+using LabController = Ssd16xxController;
+static const SPISettings EPD_SPI_SETTINGS(4000000, MSBFIRST, SPI_MODE0); // GxEPD2_EPD default
+// The SPI block behind g_epdSpi; paged writes feed it by DMA
+static spi_inst_t *const EPD_SPI_HW = spi0;
+
+// Sends one plane of a page to the SPI block by DMA while the caller goes
+// on. Page rows are padded past the window, so a control channel feeds the
+// data channel one row address at a time; the null entry after the last row
+// raises the interrupt, which only marks the plane done. Commands, CS and
+// DC stay with the driver, in thread context.
+class PagePump
+{
+public:
+  static constexpr uint16_t MAX_ROWS = EPD_PAGE_ROWS > 0 ? EPD_PAGE_ROWS : 1;
+
+  void begin(spi_inst_t *spi)
+  {
+    if (_data >= 0) return;
+    _spi = spi;
+    _data = dma_claim_unused_channel(true);
+    _control = dma_claim_unused_channel(true);
+    dma_channel_config data = dma_channel_get_default_config(_data);
+    channel_config_set_transfer_data_size(&data, DMA_SIZE_8);
+    channel_config_set_dreq(&data, spi_get_dreq(spi, true));
+    channel_config_set_read_increment(&data, true);
+    channel_config_set_write_increment(&data, false);
+    channel_config_set_chain_to(&data, _control);
+    channel_config_set_irq_quiet(&data, true);
+    dma_channel_configure(_data, &data, &spi_get_hw(spi)->dr, nullptr, 0, false);
+    dma_channel_config control = dma_channel_get_default_config(_control);
+    channel_config_set_transfer_data_size(&control, DMA_SIZE_32);
+    channel_config_set_read_increment(&control, true);
+    channel_config_set_write_increment(&control, false);
+    dma_channel_configure(_control, &control, &dma_hw->ch[_data].al3_read_addr_trig, _rowAddr, 1, false);
+    s_pump = this;
+    irq_add_shared_handler(DMA_IRQ_1, onDmaIrq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    dma_channel_set_irq1_enabled(_data, true);
+    irq_set_enabled(DMA_IRQ_1, true);
+  }
+
+  // 'rows' rows of 'rowBytes' bytes, 'stride' apart; rows <= MAX_ROWS. The
+  // plane command is out and CS is low with DC high.
+  void start(const uint8_t *plane, uint16_t stride, uint16_t rowBytes, uint16_t rows)
+  {
+    for (uint16_t i = 0; i < rows; ++i) _rowAddr[i] = plane + static_cast<size_t>(i) * stride;
+    _rowAddr[rows] = nullptr;
+    _busy = true;
+    dma_channel_set_trans_count(_data, rowBytes, false);
+    dma_channel_set_read_addr(_control, _rowAddr, true);
+  }
+
+  bool busy() const
+  {
+    return _busy;
+  }
+
+  // Waits for the last row, then for the bytes still in the SPI FIFO (a few
+  // microseconds at 4 MHz), and drops what the receiver caught meanwhile.
+  void wait()
+  {
+    while (_busy)
+    {
+      tight_loop_contents();
+    }
+    while (spi_is_busy(_spi))
+    {
+      tight_loop_contents();
+    }
+    while (spi_is_readable(_spi))
+    {
+      (void)spi_get_hw(_spi)->dr;
+    }
+    spi_get_hw(_spi)->icr = SPI_SSPICR_RORIC_BITS;
+  }
+
+private:
+  static void onDmaIrq()
+  {
+    PagePump *pump = s_pump;
+    if (pump == nullptr || !dma_channel_get_irq1_status(pump->_data)) return;
+    dma_channel_acknowledge_irq1(pump->_data);
+    pump->_busy = false;
+  }
+
+  static PagePump *s_pump;
 
-class GxEPD2_213c_Lab : public GxEPD2_213c
+  spi_inst_t *_spi = nullptr;
+  int _data = -1;
+  int _control = -1;
+  const uint8_t *_rowAddr[MAX_ROWS + 1] = {};  // read by the control channel
+  volatile bool _busy = false;
+};
+
+PagePump *PagePump::s_pump = nullptr;
+
+class GxEPD2_213c_Lab : public GxEPD2_213c, public RefreshPort
 {
 public:
   using GxEPD2_213c::GxEPD2_213c;
 
+  // GxEPD2's own BUSY waits only; the engine's refresh phase keeps
+  // ASYNC_DEADLINES.refreshMs, which must cover full_refresh_time.
   void setBusyTimeout(uint32_t us)
   {
     _busy_timeout = us;
@@ -27,23 +205,626 @@ public:
 
   void rawWriteCommand(uint8_t cmd)
   {
+    finishRefresh();
+    forgetFrame();
+    traceRaw('C', &cmd, 1);
     _writeCommand(cmd);
   }
 
   void rawWriteDataByte(uint8_t data)
   {
+    finishRefresh();
+    traceRaw('D', &data, 1);
     _writeData(data);
   }
 
+  void rawWriteData(const uint8_t *data, size_t count)
+  {
+    rawBeginData();
+    rawStreamData(data, count);
+    rawEndData();
+  }
+
+  void rawFillData(uint8_t value, size_t count)
+  {
+    rawBeginData();
+    rawStreamFill(value, count);
+    rawEndData();
+  }
+
+  // Open one CS window for data bytes; the rawStream* calls keep it asserted
+  // until rawEndData(). No commands may be issued in between.
+  void rawBeginData()
+  {
+    finishRefresh();
+    _startTransfer();
+    if (_dc >= 0) digitalWrite(_dc, HIGH);
+  }
+
+  void rawStreamData(const uint8_t *data, size_t count)
+  {
+    traceRaw('D', data, count);
+    _pSPIx->transfer(data, nullptr, count);
+  }
+
+  void rawStreamFill(uint8_t value, size_t count)
+  {
+    uint8_t chunk[32];
+    memset(chunk, value, sizeof(chunk));
+    while (count > 0)
+    {
+      const size_t n = count < sizeof(chunk) ? count : sizeof(chunk);
+      traceRaw('D', chunk, n);
+      _pSPIx->transfer(chunk, nullptr, n);
+      count -= n;
+    }
+  }
+
+  void rawEndData()
+  {
+    _endTransfer();
+  }
+
   void waitWhileBusyLab(const char *comment)
   {
+    finishRefresh();
     _waitWhileBusy(comment);
   }
+
+  // With async refresh on, a full refresh only starts the RefreshEngine and
+  // returns; loop() drives it through pollRefresh().
+  void setAsyncRefresh(bool enabled)
+  {
+    finishRefresh();
+    _asyncRefresh = enabled;
+  }
+
+  bool refreshBusy() const
+  {
+    return _engine.busy();
+  }
+
+  const RefreshEngine &refreshEngine() const
+  {
+    return _engine;
+  }
+
+  RefreshEvent pollRefresh()
+  {
+    RefreshEvent event = _engine.poll(*this);
+    if (event == RefreshEvent::None)
+    {
+      event = _unreported;
+    }
+    _unreported = RefreshEvent::None;
+    if (event != RefreshEvent::None && _engine.poweredOff())
+    {
+      _power_is_on = false;
+    }
+    return event;
+  }
+
+  // Blocks until a running refresh or page write ends; every other bus
+  // access goes through here first. The outcome is still reported by
+  // pollRefresh().
+  void finishRefresh()
+  {
+    finishImagePart();
+    if (!_engine.busy()) return;
+    _unreported = _engine.finish(*this);
+    if (_engine.poweredOff()) _power_is_on = false;
+  }
+
+  // Called from the PIN_BUSY edge interrupt.
+  void busyEdgeIsr()
+  {
+    if (!busyActive()) _engine.notifyBusyEdge(millis());
+  }
+
+  void sendCommand(uint8_t cmd) override
+  {
+    _writeCommand(cmd);
+  }
+
+  bool busyActive() override
+  {
+    return digitalRead(_busy) == _busy_level;
+  }
+
+  uint32_t nowMs() override
+  {
+    return millis();
+  }
+
+  // The next image write is sent and refreshed even if it matches the last one.
+  void forceNextRefresh()
+  {
+    _forceNext = true;
+  }
+
+  bool lastRefreshSkipped() const
+  {
+    return _lastSkipped;
+  }
+
+  // Shadow the GxEPD2_213c entry points the display calls on epd2, so an
+  // image identical to the one already in controller RAM is neither sent
+  // nor refreshed. With EPD_FRAME_DIFF, writeImagePart() sends only the
+  // band that differs from what the controller holds.
+  void writeImage(const uint8_t *black, const uint8_t *color, int16_t x, int16_t y, int16_t w, int16_t h,
+                  bool invert = false, bool mirror_y = false, bool pgm = false)
+  {
+    uint64_t hash = hashWindow(x, y, w, h, invert, mirror_y, pgm);
+    const size_t planeBytes = static_cast<size_t>((w + 7) / 8) * (h > 0 ? h : 0);
+    hash = hashPlane(hash, black, planeBytes, pgm);
+    hash = hashPlane(hash, color, planeBytes, pgm);
+    if (skipWrite(hash)) return;
+    forgetPages();
+    GxEPD2_213c::writeImage(black, color, x, y, w, h, invert, mirror_y, pgm);
+#if EPD_FRAME_DIFF
+    s_shadow.invalidate();
+#endif
+    _frameHash = hash;
+    _frameHashValid = true;
+  }
+
+  void writeImagePart(const uint8_t *black, const uint8_t *color, int16_t x_part, int16_t y_part,
+                      int16_t w_bitmap, int16_t h_bitmap, int16_t x, int16_t y, int16_t w, int16_t h,
+                      bool invert = false, bool mirror_y = false, bool pgm = false)
+  {
+    const uint64_t hash = hashPart(black, color, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
+    if (skipWrite(hash)) return;
+    forgetPages();
+#if EPD_FRAME_DIFF
+    if (!writeChanges(black, color, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm))
+#endif
+    {
+      GxEPD2_213c::writeImagePart(black, color, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
+    }
+    _frameHash = hash;
+    _frameHashValid = true;
+  }
+
+  // One page of a paged frame (EPD_PAGE_ROWS), x and w on whole bytes:
+  // window and black plane command go out here, its rows through _pump
+  // while PlaneDisplay draws the next page; finishImagePart() sends the red
+  // plane. A page whose hash (window included) matches the last one sent to
+  // its rows is skipped, as the controller already holds it; the pages of a
+  // frame are also hashed together, so an unchanged frame sends nothing and
+  // is not refreshed. While GxEPD2 has yet to switch the controller to
+  // partial RAM mode (its _Init_Part() is private), or without the SPI
+  // block of selectSPI(), the page is written in place by
+  // GxEPD2_213c::writeImagePart().
+  void writeImagePartAsync(const uint8_t *black, const uint8_t *color, int16_t x_part, int16_t y_part,
+                           int16_t w_bitmap, int16_t h_bitmap, int16_t x, int16_t y, int16_t w, int16_t h)
+  {
+    finishRefresh();
+    const uint64_t part = hashPart(black, color, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, false, false, false);
+    _pageHash = _pagesOpen ? hashMix(hashMix(_pageHash, static_cast<uint32_t>(part)), static_cast<uint32_t>(part >> 32))
+                           : part;
+    _pagesOpen = true;
+    const uint16_t slot = y >= 0 ? static_cast<uint16_t>(y / PAGE_SLOT_ROWS) : PAGE_SLOTS;
+    if (slot < PAGE_SLOTS)
+    {
+      if (!_forceNext && !_initial_write && _pageSentValid[slot] && _pageSent[slot] == part) return;
+      _pageSent[slot] = part;
+      _pageSentValid[slot] = true;
+    }
+    if (_spiHw == nullptr || !_using_partial_mode || _initial_write || w <= 0 || h <= 0 || h > PagePump::MAX_ROWS)
+    {
+      GxEPD2_213c::writeImagePart(black, color, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h);
+      return;
+    }
+    _pump.begin(_spiHw);
+    _pumpStride = (w_bitmap + 7) / 8;
+    _pumpRowBytes = w / 8;
+    _pumpRows = h;
+    const size_t offset = static_cast<size_t>(y_part) * _pumpStride + x_part / 8;
+    _pumpRed = color + offset;
+    _writeCommand(Panel::Controller::partialIn);
+    setPartialRamArea(x, y, w, h);
+    _writeCommand(Panel::Controller::blackPlane);
+    pumpPlane(black + offset);
+    _pumping = true;
+  }
+
+  // Waits for the black plane _pump is sending, sends the red plane and
+  // leaves partial RAM mode.
+  void finishImagePart()
+  {
+    if (!_pumping) return;
+    _pumping = false;
+    endPlane();
+    _writeCommand(Panel::Controller::redPlane);
+    pumpPlane(_pumpRed);
+    endPlane();
+    _writeCommand(Panel::Controller::partialOut);
+  }
+
+  // The SPI block behind 'spi', which _pump writes directly, and a hook
+  // that sees the bytes it sends as the observed SPI port sees the rest.
+  void selectSPI(SPIClass &spi, spi_inst_t *hw, SPISettings settings)
+  {
+    GxEPD2_213c::selectSPI(spi, settings);
+    _spiHw = hw;
+  }
+
+  void observePages(void (*observer)(const uint8_t *bytes, size_t count))
+  {
+    _pageObserver = observer;
+  }
+
+  void refresh(bool partial_update_mode = false)
+  {
+    closePages();
+    if (consumeSkip()) return;
+    finishRefresh();
+    if (_asyncRefresh && !partial_update_mode)
+    {
+      startRefresh();
+      return;
+    }
+    GxEPD2_213c::refresh(partial_update_mode);
+  }
+
+  // Without a fast partial waveform the window refresh of GxEPD2_213c runs
+  // the full one and blocks for it; with async refresh on, the window is
+  // already in controller RAM, so the engine refreshes the panel instead.
+  void refresh(int16_t x, int16_t y, int16_t w, int16_t h)
+  {
+    closePages();
+    if (consumeSkip()) return;
+    finishRefresh();
+    if (_asyncRefresh && !Panel::fastPartialRefresh)
+    {
+      startRefresh();
+      return;
+    }
+    GxEPD2_213c::refresh(x, y, w, h);
+  }
+
+  void clearScreen(uint8_t black_value = 0xFF, uint8_t color_value = 0xFF)
+  {
+    finishRefresh();
+    forgetFrame();
+    GxEPD2_213c::clearScreen(black_value, color_value);
+  }
+
+  void writeScreenBuffer(uint8_t black_value = 0xFF, uint8_t color_value = 0xFF)
+  {
+    finishRefresh();
+    forgetFrame();
+    GxEPD2_213c::writeScreenBuffer(black_value, color_value);
+  }
+
+private:
+  static void traceRaw(char kind, const uint8_t *bytes, size_t count)
+  {
+#if EPD_TRACE_RAW
+    for (size_t i = 0; i < count; i += 16)
+    {
+      Serial.print(F("[TRC] "));
+      Serial.print(kind);
+      for (size_t j = i; j < count && j < i + 16; ++j)
+      {
+        Serial.print(bytes[j] < 0x10 ? F(" 0") : F(" "));
+        Serial.print(bytes[j], HEX);
+      }
+      Serial.println();
+    }
+#else
+    (void)kind;
+    (void)bytes;
+    (void)count;
+#endif
+  }
+
+  // GxEPD2_213c's _Init_Full() and _Init_Part() send the same init sequence
+  // and differ only in _using_partial_mode, so after image writes in partial
+  // RAM mode the controller is ready for the full waveform as it is.
+  void startRefresh()
+  {
+    _using_partial_mode = false;
+    _engine.start(*this, !_power_is_on);
+    _power_is_on = true;
+    _initial_refresh = false;
+  }
+
+  // One plane of the page in its own CS window; DC is still high after the
+  // plane command.
+  void pumpPlane(const uint8_t *plane)
+  {
+    _pSPIx->beginTransaction(_spi_settings);
+    if (_cs >= 0) digitalWrite(_cs, LOW);
+    if (_pageObserver != nullptr)
+    {
+      for (uint16_t row = 0; row < _pumpRows; ++row) _pageObserver(plane + row * _pumpStride, _pumpRowBytes);
+    }
+    _pump.start(plane, _pumpStride, _pumpRowBytes, _pumpRows);
+  }
+
+  void endPlane()
+  {
+    _pump.wait();
+    if (_cs >= 0) digitalWrite(_cs, HIGH);
+    _pSPIx->endTransaction();
+  }
+
+  static constexpr RefreshDeadlines ASYNC_DEADLINES = RefreshEngine::UC8151_DEADLINES;
+  static_assert(ASYNC_DEADLINES.refreshMs > full_refresh_time, "refresh deadline shorter than a full refresh");
+  static constexpr uint64_t FRAME_HASH_SEED = 14695981039346656037ULL;
+  // One hash per page of rows; a single unused slot without paging
+  static constexpr uint16_t PAGE_SLOT_ROWS = EPD_PAGE_ROWS > 0 ? EPD_PAGE_ROWS : Panel::height;
+  static constexpr uint16_t PAGE_SLOTS = (Panel::height + PAGE_SLOT_ROWS - 1) / PAGE_SLOT_ROWS;
+  static constexpr uint64_t FRAME_HASH_PRIME = 1099511628211ULL;
+
+  static uint64_t hashMix(uint64_t hash, uint32_t value)
+  {
+    return (hash ^ value) * FRAME_HASH_PRIME;
+  }
+
+  // FNV-1a over 32-bit words; the planes are a few KB, so this stays in the
+  // tens of microseconds on the RP2040.
+  static uint64_t hashPlane(uint64_t hash, const uint8_t *data, size_t count, bool pgm)
+  {
+    if (data == nullptr) return hashMix(hash, 0xA5A5A5A5UL);
+    size_t i = 0;
+    if (!pgm)
+    {
+      for (; i + 4 <= count; i += 4)
+      {
+        uint32_t word;
+        memcpy(&word, data + i, sizeof(word));
+        hash = hashMix(hash, word);
+      }
+    }
+    for (; i < count; ++i)
+    {
+      hash = hashMix(hash, pgm ? pgm_read_byte(data + i) : data[i]);
+    }
+    return hash;
+  }
+
+  static uint64_t hashWindow(int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+  {
+    uint64_t hash = hashMix(FRAME_HASH_SEED, (static_cast<uint32_t>(static_cast<uint16_t>(x)) << 16) | static_cast<uint16_t>(y));
+    hash = hashMix(hash, (static_cast<uint32_t>(static_cast<uint16_t>(w)) << 16) | static_cast<uint16_t>(h));
+    return hashMix(hash, (invert ? 1u : 0u) | (mirror_y ? 2u : 0u) | (pgm ? 4u : 0u));
+  }
+
+  // Only the window's bytes of each bitmap row are hashed.
+  static uint64_t hashPart(const uint8_t *black, const uint8_t *color, int16_t x_part, int16_t y_part,
+                           int16_t w_bitmap, int16_t h_bitmap, int16_t x, int16_t y, int16_t w, int16_t h,
+                           bool invert, bool mirror_y, bool pgm)
+  {
+    uint64_t hash = hashWindow(x, y, w, h, invert, mirror_y, pgm);
+    hash = hashMix(hash, (static_cast<uint32_t>(static_cast<uint16_t>(x_part)) << 16) | static_cast<uint16_t>(y_part));
+    if (w > 0 && h > 0 && x_part >= 0 && y_part >= 0 && y_part + h <= h_bitmap)
+    {
+      const size_t stride = static_cast<size_t>((w_bitmap + 7) / 8);
+      const size_t first = static_cast<size_t>(x_part / 8);
+      const size_t count = static_cast<size_t>((x_part + w + 7) / 8) - first;
+      for (int16_t row = 0; row < h; ++row)
+      {
+        const size_t offset = (static_cast<size_t>(y_part) + row) * stride + first;
+        hash = hashPlane(hash, black ? black + offset : nullptr, count, pgm);
+        hash = hashPlane(hash, color ? color + offset : nullptr, count, pgm);
+      }
+    }
+    return hash;
+  }
+
+  // GxEPD2_213c::_setPartialRamArea(), which is private.
+  void setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+  {
+    const uint16_t xe = (x + w - 1) | 0x0007;
+    const uint16_t ye = y + h - 1;
+    x &= 0xFFF8;
+    _writeCommand(Panel::Controller::partialWindow);
+    _writeData(x % 256);
+    _writeData(xe % 256);
+    _writeData(y / 256);
+    _writeData(y % 256);
+    _writeData(ye / 256);
+    _writeData(ye % 256);
+    _writeData(0x01);
+  }
+
+#if EPD_FRAME_DIFF
+  // writeImagePart() through s_shadow: the full frame at (x, y) of a
+  // PlaneRaster-shaped bitmap, x and w on whole bytes. Until the shadow
+  // holds the whole controller RAM, the window is written in full, which
+  // makes the shadow valid once the window is the whole panel. After that
+  // only the band of the window that changed is written, possibly nothing.
+  // False for any other call, which the caller writes as GxEPD2 would.
+  bool writeChanges(const uint8_t *black, const uint8_t *color, int16_t x_part, int16_t y_part, int16_t w_bitmap,
+                    int16_t h_bitmap, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+  {
+    const size_t stride = static_cast<size_t>((w_bitmap + 7) / 8);
+    if (invert || mirror_y || pgm || black == nullptr || color == nullptr || x_part != x || y_part != y ||
+        w_bitmap < Panel::width || h_bitmap < Panel::height || stride % 4 != 0 || x < 0 || y < 0 || w <= 0 ||
+        h <= 0 || x % 8 != 0 || w % 8 != 0 || x + w > Panel::width || y + h > Panel::height)
+    {
+      s_shadow.invalidate();
+      return false;
+    }
+    if (_initial_write || !s_shadow.valid())
+    {
+      GxEPD2_213c::writeImagePart(black, color, x, y, w_bitmap, h_bitmap, x, y, w, h);
+      if (w == Panel::width && h == Panel::height) s_shadow.reset(black, color, stride);
+      return true;
+    }
+    const RowBand window{static_cast<uint16_t>(y), static_cast<uint16_t>(y + h - 1), static_cast<uint16_t>(x / 8),
+                         static_cast<uint16_t>((x + w) / 8 - 1)};
+    const RowBand band = s_shadow.diff(black, color, stride, window);
+    if (band.empty()) return true;
+    const int16_t bx = band.xb0 * 8;
+    GxEPD2_213c::writeImagePart(black, color, bx, band.y0, w_bitmap, h_bitmap, bx, band.y0, band.bytes() * 8,
+                                band.rows());
+    s_shadow.commit(black, color, stride, band);
+    return true;
+  }
+#endif
+
+  // Controller RAM was written behind the image paths' back.
+  void forgetFrame()
+  {
+    _frameHashValid = false;
+    forgetPages();
+#if EPD_FRAME_DIFF
+    s_shadow.invalidate();
+#endif
+  }
+
+  // Rows written other than page by page no longer hold the pages sent.
+  void forgetPages()
+  {
+    memset(_pageSentValid, 0, sizeof(_pageSentValid));
+  }
+
+  // End of a paged frame: its hash decides the refresh as a whole frame's
+  // does in writeImagePart().
+  void closePages()
+  {
+    finishImagePart();
+    if (!_pagesOpen) return;
+    _pagesOpen = false;
+    skipWrite(_pageHash);
+    _frameHash = _pageHash;
+    _frameHashValid = true;
+  }
+
+  // Decides whether a write with this hash is skipped; otherwise waits for
+  // a running refresh so the write can go out.
+  bool skipWrite(uint64_t hash)
+  {
+    _skipPending = !_forceNext && _frameHashValid && hash == _frameHash;
+    _lastSkipped = _skipPending;
+    _forceNext = false;
+    if (_skipPending) return true;
+    finishRefresh();
+    return false;
+  }
+
+  bool consumeSkip()
+  {
+    const bool skip = _skipPending;
+    _skipPending = false;
+    return skip;
+  }
+
+  uint64_t _frameHash = 0;
+  uint64_t _pageHash = 0;
+  uint64_t _pageSent[PAGE_SLOTS] = {};  // hash of the page last sent to each slot's rows
+  bool _pageSentValid[PAGE_SLOTS] = {};
+  bool _pagesOpen = false;
+  bool _pumping = false;
+  PagePump _pump;
+  spi_inst_t *_spiHw = nullptr;
+  void (*_pageObserver)(const uint8_t *bytes, size_t count) = nullptr;
+  const uint8_t *_pumpRed = nullptr;
+  uint16_t _pumpStride = 0;
+  uint16_t _pumpRowBytes = 0;
+  uint16_t _pumpRows = 0;
+  bool _frameHashValid = false;
+  bool _skipPending = false;
+  bool _lastSkipped = false;
+  bool _forceNext = false;
+  bool _asyncRefresh = false;
+#if EPD_FRAME_DIFF
+  // static: the display takes its driver by value, too big a copy for the stack
+  static FrameShadow<Panel> s_shadow;
+#endif
+  RefreshEngine _engine{ASYNC_DEADLINES, Panel::Controller::refreshOpcodes()};
+  RefreshEvent _unreported = RefreshEvent::None;
 };
 
-using Display = GxEPD2_3C<GxEPD2_213c_Lab, GxEPD2_213c::HEIGHT>;
+#if EPD_FRAME_DIFF
+FrameShadow<Panel> GxEPD2_213c_Lab::s_shadow;
+#endif
+
+// The whole frame, or two pages of EPD_PAGE_ROWS rows
+static constexpr uint16_t PAGE_ROWS = EPD_PAGE_ROWS > 0 ? EPD_PAGE_ROWS : Panel::height;
+using Display = DirtyTracking<PlaneDisplay<GxEPD2_213c_Lab, Panel, 2048, PAGE_ROWS>>;
 static Display display(GxEPD2_213c_Lab(PIN_CS, PIN_DC, PIN_RST, PIN_BUSY));
 
+#if EPD_BUS_STATS
+static BusProfiler g_busProfiler;
+#endif
+#if EPD_REFRESH_TELEMETRY
+static RefreshTelemetry<REFRESH_HISTORY> g_refreshTelemetry;
+#endif
+
+#if EPD_BUS_OBSERVED
+static void observeBytes(const uint8_t *bytes, size_t count)
+{
+  const bool dc = digitalRead(PIN_DC) == HIGH;
+#if EPD_BUS_STATS
+  g_busProfiler.bytes(dc, bytes, count);
+#endif
+#if EPD_REFRESH_TELEMETRY
+  if (!dc)
+  {
+    for (size_t i = 0; i < count; ++i) g_refreshTelemetry.opcode(bytes[i], micros(), millis());
+  }
+#endif
+}
+
+// The panel's SPI port with every transaction reported to the profiler and
+// the refresh telemetry. GxEPD2's _writeCommand/_writeData/_transfer and the
+// raw* paths of GxEPD2_213c_Lab all go through these virtuals; DC tells
+// opcodes from data.
+template <typename Spi>
+class ObservedSpi : public Spi
+{
+public:
+  using Spi::Spi;
+  using Spi::transfer;
+
+  void beginTransaction(SPISettings settings) override
+  {
+    Spi::beginTransaction(settings);
+#if EPD_BUS_STATS
+    g_busProfiler.begin(micros());
+#endif
+  }
+
+  void endTransaction() override
+  {
+    const uint32_t now = micros();
+#if EPD_BUS_STATS
+    g_busProfiler.end(now);
+#endif
+#if EPD_REFRESH_TELEMETRY
+    g_refreshTelemetry.windowEnd(now);
+#endif
+    Spi::endTransaction();
+  }
+
+  uint8_t transfer(uint8_t data) override
+  {
+    observeBytes(&data, 1);
+    return Spi::transfer(data);
+  }
+
+  void transfer(void *buf, size_t count) override
+  {
+    observeBytes(static_cast<const uint8_t *>(buf), count);
+    Spi::transfer(buf, count);
+  }
+
+  void transfer(const void *txbuf, void *rxbuf, size_t count) override
+  {
+    observeBytes(static_cast<const uint8_t *>(txbuf), count);
+    Spi::transfer(txbuf, rxbuf, count);
+  }
+};
+
+static ObservedSpi<SPIClassRP2040> g_epdSpi(EPD_SPI_HW, PIN_MISO, PIN_CS, PIN_SCK, PIN_MOSI);
+#else
+static SPIClassRP2040 &g_epdSpi = SPI;
+#endif
+
 static int16_t g_offsetX = 0;
 static int16_t g_offsetY = 0;
 static uint8_t g_rotation = 1;
@@ -61,115 +842,304 @@ static OffsetPair g_baseOffset[4] = {
   {0, 0}
 };
 
+// What the renderer draws. Jobs carry a copy, so core0 may keep editing the
+// offsets while core1 is still drawing an earlier state.
+struct DiagState
+{
+  int16_t offsetX;
+  int16_t offsetY;
+  uint8_t rotation;
+  OffsetPair base[4];
+  uint8_t busy;  // PIN_BUSY, sampled by drawDiagnostics() once per frame
+};
+
+// Everything that touches the panel. Redraw jobs render the attached state;
+// panel jobs run a barrier command line on the render side; the rest carry
+// binary frames from the console to controller RAM.
+struct RenderJob
+{
+  enum class Type : uint8_t
+  {
+    Redraw,
+    Panel,
+    PlaneBegin,
+    PlaneData,
+    PlaneEnd,
+    Window,
+    Update
+  };
+
+  Type type;
+  bool full;
+  bool force;
+  bool crcOk;
+  ControllerFamily family;  // opcodes of binary frames ('bin [ssd]')
+  uint8_t target;
+  uint8_t size;
+  DiagState state;
+  char line[SERIAL_LINE_MAX];
+};
+
+// Owned by the render side; runJob() copies each job's state in and
+// drawDiagnostics() adds the BUSY sample.
+static DiagState g_renderState = {};
+// Expands packed plane frames row by row into the open CS window.
+static RowDecoder g_rowDecoder;
+static bool g_rowDecodeOk = false;
+#if EPD_RENDER_CORE1
+static SpscRing<RenderJob, RENDER_QUEUE_DEPTH> g_renderQueue;
+#endif
+
+static LineAssembler<SERIAL_LINE_MAX> g_lineIn;
+static LineQueue<COMMAND_QUEUE_DEPTH, SERIAL_LINE_MAX> g_commandQueue;
+static uint32_t g_lastInputMs = 0;
+static bool g_redrawPending = false;
+static bool g_fullRedrawPending = false;
+static bool g_forceRedrawPending = false;
+
+// Binary frame mode, entered with 'bin' and left with an Exit frame
+static bool g_binaryMode = false;
+static ControllerFamily g_binaryFamily = ControllerFamily::Uc8151;
+static FrameDecoder g_frameDecoder;
+static uint8_t g_binaryInput[SERIAL_LINE_MAX];
+static size_t g_binaryInputLength = 0;
+static size_t g_binaryInputPos = 0;
+static bool g_frameDiscard = false;
+static uint8_t g_frameWindow[FRAME_WINDOW_BYTES];
+static size_t g_frameWindowLength = 0;
+
 static void ensureInit();
-static void fullClear();
-static void drawDiagnostics();
-static void refreshDisplay(bool verbose = true);
+static void renderDiagnostics(uint16_t w, uint16_t h);
+static void drawDiagnostics(bool allowPartial = false);
+static void refreshDisplay(bool verbose = true, bool force = false);
+static void pollDisplay();
+static void onBusyEdge();
+static void updateDisplay();
+static void requestRedraw(bool full, bool force);
+static void flushRedraw();
+static DiagState captureState();
+static RenderJob makeJob(RenderJob::Type type);
+static size_t renderQueueSpace();
+static void submitJob(const RenderJob &job);
+static void runJob(const RenderJob &job);
+static void runFrameJob(const RenderJob &job);
 static void handleSerial();
-static void processCommand(const String &line);
+static void acceptTextByte(char c);
+static void handleBinary();
+static void onFrameEvent(const FrameEvent &event);
+static void runCommandQueue();
+static void startPanel();
+static CommandKind classifyCommand(const char *line);
+static void copyLine(char *dst, const char *src);
+static void processCommand(char *line);
 static void showHelp();
 static void printStatus();
 static void printBaseOffsets();
-static bool parseOffsetValues(const String &input, int16_t &outX, int16_t &outY);
-static bool parseRotationValue(const String &input, uint8_t &outRotation);
-static bool parseBaseCommand(const String &input, uint8_t &outRotation, int16_t &outX, int16_t &outY);
-static bool tokenize(const String &input, String *tokens, size_t &count, size_t maxTokens);
-static bool parseHexByte(const String &token, uint8_t &outValue);
-static long parseSigned(const String &token, int base = 10);
-static void commandRaw(const String &args);
-static void commandGate(const String &args);
-static void commandHScan(const String &args);
-static void commandDiagBlock(const String &args);
-static void commandWash();
-static void commandFullClear();
-static void commandContrastCycle();
+#if EPD_BUS_STATS
+static void printBusStats();
+#endif
+#if EPD_REFRESH_TELEMETRY
+static void printRefreshTimings();
+#endif
 
 static void ensureInit()
 {
   static bool initialized = false;
   if (initialized) return;
+  display.epd2.selectSPI(g_epdSpi, EPD_SPI_HW, EPD_SPI_SETTINGS);
+#if EPD_BUS_OBSERVED
+  display.epd2.observePages(observeBytes);
+#endif
   display.init(115200, true, 20, false);
   display.epd2.setBusyTimeout(BUSY_TIMEOUT_US);
+  display.epd2.setAsyncRefresh(true);
+  attachInterrupt(digitalPinToInterrupt(PIN_BUSY), onBusyEdge, CHANGE);
   initialized = true;
 }
 
-static void fullClear()
+static void renderDiagnostics(uint16_t w, uint16_t h)
+{
+  const DiagState &state = g_renderState;
+  const OffsetPair base = state.base[state.rotation & 0x03];
+  const int16_t ox = base.x + state.offsetX;
+  const int16_t oy = base.y + state.offsetY;
+
+  display.fillScreen(GxEPD_WHITE);
+  display.drawFastHLine(ox, (h / 2) + oy, w, GxEPD_BLACK);
+  display.drawFastVLine((w / 2) + ox, oy, h, GxEPD_BLACK);
+  display.drawRect(ox, oy, w, h, GxEPD_BLACK);
+  const int16_t boxSize = 48;
+  const int16_t boxX = (w / 2) + ox - (boxSize / 2);
+  const int16_t boxY = (h / 2) + oy - (boxSize / 2);
+  display.fillRect(boxX, boxY, boxSize, boxSize, GxEPD_RED);
+  display.setCursor(10 + ox, 16 + oy);
+  display.print(F("Diag GxEPD2_213c"));
+  display.setCursor(10 + ox, 36 + oy);
+  display.print(F("w="));
+  display.print(w);
+  display.print(F(" h="));
+  display.print(h);
+  display.setCursor(10 + ox, h - 24 + oy);
+  display.print(F("rot="));
+  display.print(state.rotation);
+  display.print(F(" busy="));
+  display.print(state.busy);
+  display.setCursor(10 + ox, h - 10 + oy);
+  display.print(F("off="));
+  display.print(state.offsetX);
+  display.print(',');
+  display.print(state.offsetY);
+  display.print(F(" base="));
+  display.print(base.x);
+  display.print(',');
+  display.print(base.y);
+}
+
+static void pushDiagnostics(uint16_t w, uint16_t h)
 {
-  ensureInit();
-  display.setRotation(g_rotation);
-  display.setFullWindow();
   display.firstPage();
   do
   {
-    display.fillScreen(GxEPD_WHITE);
+    renderDiagnostics(w, h);
   }
   while (display.nextPage());
 }
 
-static void drawDiagnostics()
+// Renders the frame once without touching the buffer to find what changed
+// since the last push, then pushes only those windows when allowed.
+static void drawDiagnostics(bool allowPartial)
 {
   ensureInit();
-  display.setRotation(g_rotation);
+  display.setRotation(g_renderState.rotation);
   const uint16_t w = display.width();
   const uint16_t h = display.height();
-  const OffsetPair base = g_baseOffset[g_rotation & 0x03];
-  const int16_t ox = base.x + g_offsetX;
-  const int16_t oy = base.y + g_offsetY;
 
+  // The frame pushed last is no baseline until its refresh has ended; the
+  // push below would wait for that refresh anyway.
+  if (display.commitDeferred())
+  {
+    display.epd2.finishRefresh();
+    pollDisplay();
+  }
+
+  // Both passes below must draw the same frame
+  g_renderState.busy = digitalRead(PIN_BUSY);
   display.setTextColor(GxEPD_BLACK);
-  display.setFullWindow();
-  display.firstPage();
-  do
+  display.beginTracking(true);
+  renderDiagnostics(w, h);
+  DirtyRegion dirty = display.endTracking();
+  if (allowPartial && dirty.empty())
+  {
+    Serial.println(F("[EPD] no change, refresh skipped"));
+    return;
+  }
+
+  dirty.reduce(Panel::fastPartialRefresh ? PARTIAL_MAX_WINDOWS : 1);
+  const bool partial = allowPartial && display.epd2.hasPartialUpdate &&
+                       dirty.area() * 100 <= static_cast<int32_t>(w) * h * PARTIAL_MAX_AREA_PCT;
+  if (partial)
   {
-    display.fillScreen(GxEPD_WHITE);
-    display.drawFastHLine(ox, (h / 2) + oy, w, GxEPD_BLACK);
-    display.drawFastVLine((w / 2) + ox, oy, h, GxEPD_BLACK);
-    display.drawRect(ox, oy, w, h, GxEPD_BLACK);
-    const int16_t boxSize = 48;
-    const int16_t boxX = (w / 2) + ox - (boxSize / 2);
-    const int16_t boxY = (h / 2) + oy - (boxSize / 2);
-    display.fillRect(boxX, boxY, boxSize, boxSize, GxEPD_RED);
-    display.setCursor(10 + ox, 16 + oy);
-    display.print(F("Diag GxEPD2_213c"));
-    display.setCursor(10 + ox, 36 + oy);
-    display.print(F("w="));
-    display.print(w);
-    display.print(F(" h="));
-    display.print(h);
-    display.setCursor(10 + ox, h - 24 + oy);
-    display.print(F("rot="));
-    display.print(g_rotation);
-    display.print(F(" busy="));
-    display.print(digitalRead(PIN_BUSY));
-    display.setCursor(10 + ox, h - 10 + oy);
-    display.print(F("off="));
-    display.print(g_offsetX);
-    display.print(',');
-    display.print(g_offsetY);
-    display.print(F(" base="));
-    display.print(base.x);
-    display.print(',');
-    display.print(base.y);
+    for (uint8_t i = 0; i < dirty.count; ++i)
+    {
+      const DirtyRect &r = dirty.rects[i];
+      display.setPartialWindow(r.x0, r.y0, r.width(), r.height());
+      Serial.print(F("[EPD] partial window "));
+      Serial.print(r.x0);
+      Serial.print(',');
+      Serial.print(r.y0);
+      Serial.print(' ');
+      Serial.print(r.width());
+      Serial.print('x');
+      Serial.println(r.height());
+      pushDiagnostics(w, h);
+    }
+  }
+  else
+  {
+    display.setFullWindow();
+    pushDiagnostics(w, h);
+  }
+  // A background refresh commits the frame from pollDisplay() when it
+  // succeeds; skipped and blocking refreshes are done here.
+  if (display.epd2.refreshBusy())
+  {
+    display.deferCommit();
+  }
+  else
+  {
+    display.commitTracking();
   }
-  while (display.nextPage());
 }
 
-static void refreshDisplay(bool verbose)
+// One render pass; when the planes hash to what the controller already holds
+// the write and refresh are skipped unless forced.
+static void refreshDisplay(bool verbose, bool force)
 {
-  fullClear();
+  ensureInit();
+  if (force)
+  {
+    display.epd2.forceNextRefresh();
+  }
   drawDiagnostics();
-  if (verbose)
+  if (verbose || display.epd2.lastRefreshSkipped())
+  {
+    Serial.println(display.epd2.lastRefreshSkipped() ? F("[EPD] frame unchanged, refresh skipped")
+                                                      : F("[EPD] refresh started"));
+  }
+}
+
+static void onBusyEdge()
+{
+#if EPD_BUS_OBSERVED
+  const bool busy = display.epd2.busyActive();
+  const uint32_t now = micros();
+#endif
+#if EPD_BUS_STATS
+  g_busProfiler.busyEdge(busy, now);
+#endif
+#if EPD_REFRESH_TELEMETRY
+  g_refreshTelemetry.busyEdge(busy, now);
+#endif
+  display.epd2.busyEdgeIsr();
+}
+
+// Reports the end of a background refresh started by drawDiagnostics(); the
+// frame it shows becomes the tracker's baseline only if it succeeded.
+static void pollDisplay()
+{
+  switch (display.epd2.pollRefresh())
   {
-    Serial.println(F("[EPD] display refreshed"));
+    case RefreshEvent::Done:
+      if (display.commitDeferred()) display.commitTracking();
+      Serial.print(F("[EPD] refresh done in "));
+      Serial.print(display.epd2.refreshEngine().lastDurationMs());
+      Serial.println(F(" ms"));
+      break;
+    case RefreshEvent::Timeout:
+      display.invalidateTracking();
+      Serial.print(F("[ERR] BUSY timeout in "));
+      Serial.print(RefreshEngine::phaseName(display.epd2.refreshEngine().failedPhase()));
+      Serial.print(F(" phase after "));
+      Serial.print(display.epd2.refreshEngine().lastDurationMs());
+      Serial.println(F(" ms"));
+      break;
+    default:
+      break;
   }
 }
 
+// State-only changes (offsets, rotation, base) go through the dirty tracker.
+static void updateDisplay()
+{
+  drawDiagnostics(true);
+}
+
 static void showHelp()
 {
   Serial.println(F("[HELP] Commands:"));
   Serial.println(F("  h                 - print this help"));
   Serial.println(F("  s                 - show offsets/status"));
-  Serial.println(F("  d                 - redraw diagnostics"));
+  Serial.println(F("  d [force]         - redraw diagnostics (force: even if unchanged)"));
   Serial.println(F("  o <x> <y>         - set user offsets"));
   Serial.println(F("  rot <0-3>         - set rotation"));
   Serial.println(F("  base <rot> <x> <y>- set base offset"));
@@ -182,166 +1152,358 @@ static void showHelp()
   Serial.println(F("  wash              - white->black conditioning"));
   Serial.println(F("  clear             - full white clear"));
   Serial.println(F("  contrast          - black/white cycle"));
+  Serial.println(F("  bin [uc|ssd]      - binary frames until an exit frame (frame_protocol.h)"));
+#if EPD_BUS_STATS
+  Serial.println(F("  stats [reset]     - per-opcode bus counters and times"));
+#endif
+#if EPD_REFRESH_TELEMETRY
+  Serial.println(F("  timing [reset]    - CSV of recent refresh phases with min/avg/p95/max"));
+#endif
+}
+
+static void printBaseOffsets()
+{
+  Serial.print(F("[BASE]"));
+  for (uint8_t rot = 0; rot < 4; ++rot)
+  {
+    Serial.print(' ');
+    Serial.print(rot);
+    Serial.print('=');
+    Serial.print(g_baseOffset[rot].x);
+    Serial.print(',');
+    Serial.print(g_baseOffset[rot].y);
+  }
+  Serial.println();
+}
+
+static void printStatus()
+{
+  Serial.print(F("[STAT] rot="));
+  Serial.print(g_rotation);
+  Serial.print(F(" offset="));
+  Serial.print(g_offsetX);
+  Serial.print(',');
+  Serial.println(g_offsetY);
+  printBaseOffsets();
+}
+
+#if EPD_BUS_STATS
+static void printStatsRow(int opcode, const BusOpcodeStats &row)
+{
+  Serial.print(F("[STATS] "));
+  if (opcode < 0)
+  {
+    Serial.print(F("all "));
+  }
+  else
+  {
+    Serial.print(opcode < 0x10 ? F("0x0") : F("0x"));
+    Serial.print(opcode, HEX);
+  }
+  Serial.print(F(" cmd="));
+  Serial.print(row.commands);
+  Serial.print(F(" data="));
+  Serial.print(row.dataBytes);
+  Serial.print(F(" cs="));
+  Serial.print(row.csAssertions);
+  Serial.print(F(" bus_us="));
+  Serial.print(row.busUs);
+  Serial.print(F(" busy_us="));
+  Serial.println(row.busyUs);
+}
+
+// Opcodes never seen are left out.
+static void printBusStats()
+{
+  for (int op = 0; op < 256; ++op)
+  {
+    if (g_busProfiler.used(static_cast<uint8_t>(op))) printStatsRow(op, g_busProfiler.stats(static_cast<uint8_t>(op)));
+  }
+  printStatsRow(-1, g_busProfiler.total());
+}
+#endif
+
+#if EPD_REFRESH_TELEMETRY
+static void printSpanValue(uint32_t us)
+{
+  Serial.print(',');
+  if (us != REFRESH_SPAN_NONE) Serial.print(us);
+}
+
+// One CSV row per kept refresh, then min/avg/p95/max rows in the same
+// columns; empty cells are phases the refresh never reached.
+static void printRefreshTimings()
+{
+  g_refreshTelemetry.settle();
+  Serial.println(F("[TIME] csv begin"));
+  Serial.print(F("seq,start_ms,trigger"));
+  for (size_t span = 0; span < REFRESH_SPAN_COUNT; ++span)
+  {
+    Serial.print(',');
+    Serial.print(RefreshTelemetry<REFRESH_HISTORY>::spanName(static_cast<RefreshSpan>(span)));
+    Serial.print(F("_us"));
+  }
+  Serial.println();
+  for (size_t i = 0; i < g_refreshTelemetry.size(); ++i)
+  {
+    const RefreshRecord &r = g_refreshTelemetry.record(i);
+    Serial.print(i);
+    Serial.print(',');
+    Serial.print(r.startMs);
+    Serial.print(r.trigger < 0x10 ? F(",0x0") : F(",0x"));
+    Serial.print(r.trigger, HEX);
+    for (uint32_t us : r.spanUs) printSpanValue(us);
+    Serial.println();
+  }
+  static const char *const STAT_NAMES[] = {"min", "avg", "p95", "max"};
+  for (size_t stat = 0; stat < 4; ++stat)
+  {
+    Serial.print(STAT_NAMES[stat]);
+    Serial.print(F(",,"));
+    for (size_t span = 0; span < REFRESH_SPAN_COUNT; ++span)
+    {
+      const RefreshSpanStats st = g_refreshTelemetry.spanStats(static_cast<RefreshSpan>(span));
+      const uint32_t values[] = {st.minUs, st.avgUs, st.p95Us, st.maxUs};
+      printSpanValue(st.count > 0 ? values[stat] : REFRESH_SPAN_NONE);
+    }
+    Serial.println();
+  }
+  Serial.println(F("[TIME] csv end"));
+}
+#endif
+
+static void commandHelp(size_t, char **)
+{
+  showHelp();
+}
+
+static void commandStatus(size_t, char **)
+{
+  printStatus();
+}
+
+static void commandRedraw(size_t argc, char **argv)
+{
+  const bool force = argc == 1 && strcasecmp(argv[0], "force") == 0;
+  Serial.println(force ? F("[CMD] redraw (forced)") : F("[CMD] redraw"));
+  requestRedraw(true, force);
 }
 
-static void printBaseOffsets()
+static void commandResetOffsets(size_t, char **)
 {
-  Serial.print(F("[BASE]"));
-  for (uint8_t rot = 0; rot < 4; ++rot)
-  {
-    Serial.print(' ');
-    Serial.print(rot);
-    Serial.print('=');
-    Serial.print(g_baseOffset[rot].x);
-    Serial.print(',');
-    Serial.print(g_baseOffset[rot].y);
-  }
-  Serial.println();
+  g_offsetX = 0;
+  g_offsetY = 0;
+  Serial.println(F("[CMD] user offsets reset"));
+  requestRedraw(false, false);
 }
 
-static void printStatus()
+static void commandOffsets(size_t, char **argv)
 {
-  Serial.print(F("[STAT] rot="));
-  Serial.print(g_rotation);
-  Serial.print(F(" offset="));
+  int16_t newX = 0;
+  int16_t newY = 0;
+  if (!parseOffset(argv[0], newX) || !parseOffset(argv[1], newY))
+  {
+    Serial.println(F("[ERR] usage: o <x> <y>"));
+    return;
+  }
+  g_offsetX = newX;
+  g_offsetY = newY;
+  Serial.print(F("[CMD] offsets updated to "));
   Serial.print(g_offsetX);
   Serial.print(',');
   Serial.println(g_offsetY);
-  printBaseOffsets();
+  requestRedraw(false, false);
 }
 
-static bool parseOffsetValues(const String &input, int16_t &outX, int16_t &outY)
+static void commandRotation(size_t, char **argv)
 {
-  String trimmed = input;
-  trimmed.trim();
-  int spacePos = trimmed.indexOf(' ');
-  if (spacePos < 0) return false;
-  String first = trimmed.substring(0, spacePos);
-  String second = trimmed.substring(spacePos + 1);
-  first.trim();
-  second.trim();
-  if (first.length() == 0 || second.length() == 0) return false;
-  outX = static_cast<int16_t>(first.toInt());
-  outY = static_cast<int16_t>(second.toInt());
-  return true;
-}
-
-static bool parseRotationValue(const String &input, uint8_t &outRotation)
-{
-  String trimmed = input;
-  trimmed.trim();
-  if (trimmed.length() == 0) return false;
-  long value = strtol(trimmed.c_str(), nullptr, 10);
-  if (value < 0 || value > 3) return false;
-  outRotation = static_cast<uint8_t>(value);
-  return true;
+  uint8_t newRotation = 0;
+  if (!parseRotationValue(argv[0], newRotation))
+  {
+    Serial.println(F("[ERR] usage: rot <0-3>"));
+    return;
+  }
+  g_rotation = newRotation;
+  Serial.print(F("[CMD] rotation set to "));
+  Serial.println(g_rotation);
+  requestRedraw(false, false);
 }
 
-static bool parseBaseCommand(const String &input, uint8_t &outRotation, int16_t &outX, int16_t &outY)
+static void commandBase(size_t, char **argv)
 {
-  String trimmed = input;
-  trimmed.trim();
-  int firstSpace = trimmed.indexOf(' ');
-  if (firstSpace < 0) return false;
-  String rotStr = trimmed.substring(0, firstSpace);
-  String rest = trimmed.substring(firstSpace + 1);
-  rotStr.trim();
-  rest.trim();
-  if (!parseRotationValue(rotStr, outRotation)) return false;
-  if (rest.length() == 0) return false;
-  int secondSpace = rest.indexOf(' ');
-  if (secondSpace < 0) return false;
-  String xStr = rest.substring(0, secondSpace);
-  String yStr = rest.substring(secondSpace + 1);
-  xStr.trim();
-  yStr.trim();
-  if (xStr.length() == 0 || yStr.length() == 0) return false;
-  outX = static_cast<int16_t>(xStr.toInt());
-  outY = static_cast<int16_t>(yStr.toInt());
-  return true;
+  uint8_t rotIndex = 0;
+  int16_t baseX = 0;
+  int16_t baseY = 0;
+  if (!parseRotationValue(argv[0], rotIndex) || !parseOffset(argv[1], baseX) || !parseOffset(argv[2], baseY))
+  {
+    Serial.println(F("[ERR] usage: base <rot> <x> <y>"));
+    return;
+  }
+  g_baseOffset[rotIndex].x = baseX;
+  g_baseOffset[rotIndex].y = baseY;
+  Serial.print(F("[CMD] base offset updated rot="));
+  Serial.print(rotIndex);
+  Serial.print(F(" -> "));
+  Serial.print(baseX);
+  Serial.print(',');
+  Serial.println(baseY);
+  requestRedraw(false, false);
 }
 
-static bool tokenize(const String &input, String *tokens, size_t &count, size_t maxTokens)
+static void commandResetBase(size_t, char **)
 {
-  count = 0;
-  const int len = input.length();
-  int idx = 0;
-  while (idx < len && count < maxTokens)
+  for (uint8_t rot = 0; rot < 4; ++rot)
   {
-    while (idx < len && isspace(static_cast<unsigned char>(input[idx]))) ++idx;
-    if (idx >= len) break;
-    const int start = idx;
-    while (idx < len && !isspace(static_cast<unsigned char>(input[idx]))) ++idx;
-    tokens[count++] = input.substring(start, idx);
+    g_baseOffset[rot].x = 0;
+    g_baseOffset[rot].y = 0;
   }
-  return count > 0;
+  Serial.println(F("[CMD] base offsets reset"));
+  requestRedraw(false, false);
 }
 
-static bool parseHexByte(const String &token, uint8_t &outValue)
+#if EPD_BUS_STATS
+// Runs on the render side, which owns the counters.
+static void commandStats(size_t argc, char **argv)
 {
-  const long value = strtol(token.c_str(), nullptr, 16);
-  if (value < 0x00 || value > 0xFF) return false;
-  outValue = static_cast<uint8_t>(value);
-  return true;
+  if (argc == 1 && strcasecmp(argv[0], "reset") != 0)
+  {
+    Serial.println(F("[ERR] usage: stats [reset]"));
+    return;
+  }
+  if (argc == 1)
+  {
+    g_busProfiler.reset();
+    Serial.println(F("[STATS] reset"));
+    return;
+  }
+  printBusStats();
 }
+#endif
 
-static long parseSigned(const String &token, int base)
+#if EPD_REFRESH_TELEMETRY
+// Runs on the render side, which owns the records.
+static void commandTiming(size_t argc, char **argv)
 {
-  return strtol(token.c_str(), nullptr, base);
+  if (argc == 1 && strcasecmp(argv[0], "reset") != 0)
+  {
+    Serial.println(F("[ERR] usage: timing [reset]"));
+    return;
+  }
+  if (argc == 1)
+  {
+    g_refreshTelemetry.reset();
+    Serial.println(F("[TIME] reset"));
+    return;
+  }
+  printRefreshTimings();
 }
+#endif
 
-static void commandRaw(const String &args)
+static void commandBinary(size_t argc, char **argv)
 {
-  String tokens[10];
-  size_t count = 0;
-  if (!tokenize(args, tokens, count, 10) || count == 0)
+  if (argc == 1 && strcasecmp(argv[0], "ssd") != 0 && strcasecmp(argv[0], "uc") != 0)
   {
-    Serial.println(F("[ERR] usage: rawcmd <cmd> [data..] (hex)"));
+    Serial.println(F("[ERR] usage: bin [uc|ssd]"));
     return;
   }
+  g_binaryFamily = (argc == 1 && strcasecmp(argv[0], "ssd") == 0) ? ControllerFamily::Ssd16xx : ControllerFamily::Uc8151;
+  g_frameDecoder.reset();
+  g_binaryInputLength = 0;
+  g_binaryInputPos = 0;
+  g_binaryMode = true;
+  Serial.println(g_binaryFamily == ControllerFamily::Ssd16xx ? F("[BIN] ready ssd16xx") : F("[BIN] ready uc8151"));
+}
+
+static void commandRaw(size_t argc, char **argv)
+{
   uint8_t cmd;
-  if (!parseHexByte(tokens[0], cmd))
+  if (!parseHexByte(argv[0], cmd))
   {
     Serial.println(F("[ERR] invalid command byte"));
     return;
   }
-  ensureInit();
-  display.epd2.rawWriteCommand(cmd);
-  for (size_t i = 1; i < count; ++i)
+  uint8_t data[RAW_DATA_MAX];
+  for (size_t i = 1; i < argc; ++i)
   {
-    uint8_t dataByte;
-    if (!parseHexByte(tokens[i], dataByte))
+    if (!parseHexByte(argv[i], data[i - 1]))
     {
       Serial.print(F("[ERR] invalid data byte at index "));
       Serial.println(i - 1);
       return;
     }
-    display.epd2.rawWriteDataByte(dataByte);
   }
+  ensureInit();
+  display.invalidateTracking();
+  display.epd2.rawWriteCommand(cmd);
+  display.epd2.rawWriteData(data, argc - 1);
   Serial.print(F("[CMD] rawcmd 0x"));
   Serial.print(cmd, HEX);
   Serial.print(F(" len="));
-  Serial.println(count - 1);
+  Serial.println(argc - 1);
+}
+
+// Refresh of what the controller RAM holds: SSD16xx runs the full update
+// sequence and blocks; UC8151 goes through the driver's refresh engine.
+static void triggerUpdate(Ssd16xxController, const char *comment)
+{
+  display.epd2.rawWriteCommand(Ssd16xxController::updateControl);
+  display.epd2.rawWriteDataByte(Ssd16xxController::updateFull);
+  display.epd2.rawWriteCommand(Ssd16xxController::masterActivation);
+  display.epd2.waitWhileBusyLab(comment);
+}
+
+static void triggerUpdate(Uc8151Controller, const char *)
+{
+  display.epd2.forceNextRefresh();
+  display.epd2.refresh(false);
 }
 
-static void commandGate(const String &args)
+// Streams a white black plane with the block's byte columns cleared, a white
+// red plane, and refreshes. Only two distinct rows exist: blank, and blank
+// with the block; both are built once and the plane goes in one CS window.
+template <typename PanelT, typename Controller>
+static void drawDiagBlock(long sx, long ex, long sy, long ey, uint8_t rotation)
 {
-  String tokens[2];
-  size_t count = 0;
-  if (!tokenize(args, tokens, count, 2) || count != 2)
+  const uint16_t w = PanelT::widthFor(rotation);
+  const uint16_t h = PanelT::heightFor(rotation);
+  const uint16_t bytesPerRow = w / 8;
+
+  uint8_t blankRow[PanelT::maxRowBytes];
+  uint8_t blockRow[PanelT::maxRowBytes];
+  memset(blankRow, 0xFF, bytesPerRow);
+  for (uint16_t xb = 0; xb < bytesPerRow; ++xb)
   {
-    Serial.println(F("[ERR] usage: gate <start> <end> (decimal)"));
-    return;
+    const uint16_t xStart = xb * 8;
+    const uint16_t xEnd = xStart + 7;
+    blockRow[xb] = (xStart >= sx && xEnd <= ex) ? 0x00 : 0xFF;
+  }
+
+  display.epd2.rawWriteCommand(Controller::blackPlane);
+  display.epd2.rawBeginData();
+  for (uint16_t y = 0; y < h; ++y)
+  {
+    const bool inBlock = y >= sy && y <= ey;
+    display.epd2.rawStreamData(inBlock ? blockRow : blankRow, bytesPerRow);
   }
-  const long start = parseSigned(tokens[0]);
-  const long end = parseSigned(tokens[1]);
-  if (start < 0 ||  start > 65535 || end < 0 || end > 65535 || start > end)
+  display.epd2.rawEndData();
+  display.epd2.rawWriteCommand(Controller::redPlane);
+  display.epd2.rawFillData(0xFF, static_cast<uint32_t>(w) * h / 8);
+  triggerUpdate(Controller(), "diag block");
+}
+
+static void commandGate(size_t, char **argv)
+{
+  long start = 0;
+  long end = 0;
+  if (!parseNumber(argv[0], start, 10) || !parseNumber(argv[1], end, 10) ||
+      start < 0 ||  start > 65535 || end < 0 || end > 65535 || start > end)
   {
     Serial.println(F("[ERR] invalid gate arguments"));
     return;
   }
   ensureInit();
-  display.epd2.rawWriteCommand(0x45);
+  display.invalidateTracking();
+  display.epd2.rawWriteCommand(LabController::ramYRange);
   display.epd2.rawWriteDataByte(static_cast<uint8_t>(start & 0xFF));
   display.epd2.rawWriteDataByte(static_cast<uint8_t>((start >> 8) & 0xFF));
   display.epd2.rawWriteDataByte(static_cast<uint8_t>(end & 0xFF));
@@ -352,24 +1514,19 @@ static void commandGate(const String &args)
   Serial.println(end);
 }
 
-static void commandHScan(const String &args)
+static void commandHScan(size_t, char **argv)
 {
-  String tokens[2];
-  size_t count = 0;
-  if (!tokenize(args, tokens, count, 2) || count != 2)
-  {
-    Serial.println(F("[ERR] usage: hs <start> <end> (decimal, multiples of 8)"));
-    return;
-  }
-  const long start = parseSigned(tokens[0]);
-  const long end = parseSigned(tokens[1]);
-  if (start < 0 || end < 0 || start > 255 || end > 255 || start > end)
+  long start = 0;
+  long end = 0;
+  if (!parseNumber(argv[0], start, 10) || !parseNumber(argv[1], end, 10) ||
+      start < 0 || end < 0 || start > 255 || end > 255 || start > end)
   {
     Serial.println(F("[ERR] invalid horizontal range"));
     return;
   }
   ensureInit();
-  display.epd2.rawWriteCommand(0x44);
+  display.invalidateTracking();
+  display.epd2.rawWriteCommand(LabController::ramXRange);
   display.epd2.rawWriteDataByte(static_cast<uint8_t>(start));
   display.epd2.rawWriteDataByte(static_cast<uint8_t>(end));
   Serial.print(F("[CMD] horizontal range set to "));
@@ -378,50 +1535,22 @@ static void commandHScan(const String &args)
   Serial.println(end);
 }
 
-static void commandDiagBlock(const String &args)
+static void commandDiagBlock(size_t, char **argv)
 {
-  String tokens[4];
-  size_t count = 0;
-  if (!tokenize(args, tokens, count, 4) || count != 4)
+  long sx = 0;
+  long ex = 0;
+  long sy = 0;
+  long ey = 0;
+  if (!parseNumber(argv[0], sx, 10) || !parseNumber(argv[1], ex, 10) ||
+      !parseNumber(argv[2], sy, 10) || !parseNumber(argv[3], ey, 10))
   {
     Serial.println(F("[ERR] usage: diag <sx> <ex> <sy> <ey>"));
     return;
   }
-  const long sx = parseSigned(tokens[0]);
-  const long ex = parseSigned(tokens[1]);
-  const long sy = parseSigned(tokens[2]);
-  const long ey = parseSigned(tokens[3]);
   ensureInit();
-  display.setRotation(g_rotation);
-
-  const uint16_t w = display.width();
-  const uint16_t h = display.height();
-  const uint16_t bytesPerRow = w / 8;
-
-  display.epd2.rawWriteCommand(0x24);
-  for (uint16_t y = 0; y < h; ++y)
-  {
-    for (uint16_t xb = 0; xb < bytesPerRow; ++xb)
-    {
-      const uint16_t xStart = xb * 8;
-      const uint16_t xEnd = xStart + 7;
-      uint8_t value = 0xFF;
-      if (y >= sy && y <= ey && xStart >= sx && xEnd <= ex)
-      {
-        value = 0x00;
-      }
-      display.epd2.rawWriteDataByte(value);
-    }
-  }
-  display.epd2.rawWriteCommand(0x26);
-  for (uint32_t i = 0; i < (w * h / 8); ++i)
-  {
-    display.epd2.rawWriteDataByte(0xFF);
-  }
-  display.epd2.rawWriteCommand(0x22);
-  display.epd2.rawWriteDataByte(0xF7);
-  display.epd2.rawWriteCommand(0x20);
-  display.epd2.waitWhileBusyLab("diag block");
+  display.invalidateTracking();
+  display.setRotation(g_renderState.rotation);
+  drawDiagBlock<Panel, LabController>(sx, ex, sy, ey, g_renderState.rotation);
   Serial.print(F("[CMD] diag block drawn x:"));
   Serial.print(sx);
   Serial.print('-');
@@ -432,7 +1561,7 @@ static void commandDiagBlock(const String &args)
   Serial.println(ey);
 }
 
-static void commandWash()
+static void commandWash(size_t, char **)
 {
   ensureInit();
   Serial.println(F("[CMD] wash (white -> black -> redraw)"));
@@ -440,18 +1569,18 @@ static void commandWash()
   delay(300);
   display.epd2.clearScreen(0x00, 0xFF);
   delay(300);
-  refreshDisplay(false);
+  refreshDisplay(false, true);
 }
 
-static void commandFullClear()
+static void commandFullClear(size_t, char **)
 {
   ensureInit();
   Serial.println(F("[CMD] clear (full white)"));
   display.epd2.clearScreen(0xFF, 0xFF);
-  refreshDisplay(false);
+  refreshDisplay(false, true);
 }
 
-static void commandContrastCycle()
+static void commandContrastCycle(size_t, char **)
 {
   ensureInit();
   Serial.println(F("[CMD] contrast cycle (white/black/white)"));
@@ -460,163 +1589,510 @@ static void commandContrastCycle()
   display.epd2.clearScreen(0x00, 0xFF);
   delay(200);
   display.epd2.clearScreen(0xFF, 0xFF);
-  refreshDisplay(false);
+  refreshDisplay(false, true);
+}
+
+
+// Handlers of the console table in console_commands.h.
+struct FirmwareCommands
+{
+  using Fn = void (*)(size_t argc, char **argv);
+
+  static constexpr Fn base = commandBase;
+  static constexpr Fn binary = commandBinary;
+  static constexpr Fn clear = commandFullClear;
+  static constexpr Fn contrast = commandContrastCycle;
+  static constexpr Fn redraw = commandRedraw;
+  static constexpr Fn diag = commandDiagBlock;
+  static constexpr Fn gate = commandGate;
+  static constexpr Fn help = commandHelp;
+  static constexpr Fn hscan = commandHScan;
+  static constexpr Fn offsets = commandOffsets;
+  static constexpr Fn resetOffsets = commandResetOffsets;
+  static constexpr Fn raw = commandRaw;
+  static constexpr Fn resetBase = commandResetBase;
+  static constexpr Fn rotation = commandRotation;
+  static constexpr Fn status = commandStatus;
+#if EPD_BUS_STATS
+  static constexpr Fn stats = commandStats;
+#endif
+#if EPD_REFRESH_TELEMETRY
+  static constexpr Fn timing = commandTiming;
+#endif
+  static constexpr Fn wash = commandWash;
+};
+
+using Command = ConsoleCommands<FirmwareCommands>::Spec;
+
+// Lookup is a binary search.
+static constexpr const auto &COMMANDS = ConsoleCommands<FirmwareCommands>::table;
+static_assert(commandTableSorted(COMMANDS), "COMMANDS must be sorted by name");
+
+static const Command *lookupCommand(const char *line)
+{
+  size_t length = 0;
+  const char *word = commandWord(line, length);
+  return length > 0 ? findCommand(COMMANDS, word, length) : nullptr;
 }
 
-static void processCommand(const String &line)
+// Splits line in place and runs the matching handler.
+static void processCommand(char *line)
 {
-  if (line.length() == 0) return;
+  char *argv[COMMAND_ARGS_MAX + 1];
+  const size_t count = splitArgs(line, argv, COMMAND_ARGS_MAX + 1);
+  if (count == 0) return;
 
-  String lower = line;
-  lower.toLowerCase();
-  if (lower.startsWith("rot"))
+  const Command *command = findCommand(COMMANDS, argv[0], strlen(argv[0]));
+  if (command == nullptr)
   {
-    uint8_t newRotation = g_rotation;
-    if (!parseRotationValue(line.substring(3), newRotation))
-    {
-      Serial.println(F("[ERR] usage: rot <0-3>"));
-      return;
-    }
-    g_rotation = newRotation;
-    ensureInit();
-    display.setRotation(g_rotation);
-    Serial.print(F("[CMD] rotation set to "));
-    Serial.println(g_rotation);
-    refreshDisplay(false);
+    Serial.println(F("[ERR] unknown command; use 'h' for help"));
     return;
   }
-  if (lower.startsWith("base"))
+  const size_t argc = count - 1;
+  if (argc < command->minArgs || argc > command->maxArgs)
   {
-    uint8_t rotIndex = g_rotation;
-    int16_t baseX = 0;
-    int16_t baseY = 0;
-    if (!parseBaseCommand(line.substring(4), rotIndex, baseX, baseY))
-    {
-      Serial.println(F("[ERR] usage: base <rot> <x> <y>"));
-      return;
-    }
-    rotIndex &= 0x03;
-    g_baseOffset[rotIndex].x = baseX;
-    g_baseOffset[rotIndex].y = baseY;
-    Serial.print(F("[CMD] base offset updated rot="));
-    Serial.print(rotIndex);
-    Serial.print(F(" -> "));
-    Serial.print(baseX);
-    Serial.print(',');
-    Serial.println(baseY);
-    refreshDisplay(false);
+    Serial.print(F("[ERR] usage: "));
+    Serial.println(command->usage);
     return;
   }
-  if (lower.startsWith("rb"))
+  command->run(argc, argv + 1);
+}
+
+static void requestRedraw(bool full, bool force)
+{
+  g_redrawPending = true;
+  g_fullRedrawPending |= full;
+  g_forceRedrawPending |= force;
+}
+
+static void flushRedraw()
+{
+  if (!g_redrawPending) return;
+  const bool full = g_fullRedrawPending;
+  const bool force = g_forceRedrawPending;
+  g_redrawPending = false;
+  g_fullRedrawPending = false;
+  g_forceRedrawPending = false;
+  RenderJob job = makeJob(RenderJob::Type::Redraw);
+  job.full = full;
+  job.force = force;
+  submitJob(job);
+}
+
+static RenderJob makeJob(RenderJob::Type type)
+{
+  RenderJob job;
+  job.type = type;
+  job.full = false;
+  job.force = false;
+  job.crcOk = false;
+  job.family = g_binaryFamily;
+  job.target = 0;
+  job.size = 0;
+  job.state = captureState();
+  job.line[0] = '\0';
+  return job;
+}
+
+static DiagState captureState()
+{
+  DiagState state;
+  state.offsetX = g_offsetX;
+  state.offsetY = g_offsetY;
+  state.rotation = g_rotation;
+  memcpy(state.base, g_baseOffset, sizeof(state.base));
+  state.busy = 0;
+  return state;
+}
+
+// Free job slots between core0 and the renderer; unlimited when inline.
+static size_t renderQueueSpace()
+{
+#if EPD_RENDER_CORE1
+  return g_renderQueue.space();
+#else
+  return RENDER_QUEUE_DEPTH;
+#endif
+}
+
+// Callers check renderQueueSpace() first, so the push cannot fail.
+static void submitJob(const RenderJob &job)
+{
+#if EPD_RENDER_CORE1
+  g_renderQueue.push(job);
+#else
+  runJob(job);
+#endif
+}
+
+static void runJob(const RenderJob &job)
+{
+  g_renderState = job.state;
+  if (job.type == RenderJob::Type::Panel)
+  {
+    char line[SERIAL_LINE_MAX];
+    copyLine(line, job.line);
+    processCommand(line);
+  }
+  else if (job.type != RenderJob::Type::Redraw)
+  {
+    runFrameJob(job);
+  }
+  else if (job.full)
+  {
+    refreshDisplay(false, job.force);
+  }
+  else
+  {
+    updateDisplay();
+  }
+}
+
+template <typename Controller>
+static uint8_t planeOpcode(uint8_t target)
+{
+  const bool red = target == static_cast<uint8_t>(FrameTarget::Red) ||
+                   target == static_cast<uint8_t>(FrameTarget::PackedRed);
+  return red ? Controller::redPlane : Controller::blackPlane;
+}
+
+static bool isPackedTarget(uint8_t target)
+{
+  return target == static_cast<uint8_t>(FrameTarget::PackedBlack) ||
+         target == static_cast<uint8_t>(FrameTarget::PackedRed);
+}
+
+static uint16_t frameWord(const char *bytes, size_t index)
+{
+  const uint8_t *p = reinterpret_cast<const uint8_t *>(bytes) + index * 2;
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+// frame_diff.h's RAM window setters over the raw command path
+struct LabBus
+{
+  void command(uint8_t cmd)
+  {
+    display.epd2.rawWriteCommand(cmd);
+  }
+
+  void data(const uint8_t *bytes, size_t count)
+  {
+    display.epd2.rawWriteData(bytes, count);
+  }
+};
+
+// Plane frames hold one CS window open from PlaneBegin to PlaneEnd; no other
+// job reaches the panel in between because core0 only sends frame jobs
+// while in binary mode.
+template <typename Controller>
+static void runFrameJobOn(const RenderJob &job)
+{
+  switch (job.type)
   {
-    for (uint8_t rot = 0; rot < 4; ++rot)
+    case RenderJob::Type::PlaneBegin:
+      ensureInit();
+      display.invalidateTracking();
+      display.epd2.rawWriteCommand(planeOpcode<Controller>(job.target));
+      display.epd2.rawBeginData();
+      g_rowDecoder.begin();
+      g_rowDecodeOk = true;
+      break;
+    case RenderJob::Type::PlaneData:
     {
-      g_baseOffset[rot].x = 0;
-      g_baseOffset[rot].y = 0;
+      const uint8_t *data = reinterpret_cast<const uint8_t *>(job.line);
+      if (!isPackedTarget(job.target))
+      {
+        display.epd2.rawStreamData(data, job.size);
+      }
+      else if (g_rowDecodeOk)
+      {
+        g_rowDecodeOk = g_rowDecoder.feed(data, job.size, [](const uint8_t *row, size_t rowBytes)
+        {
+          display.epd2.rawStreamData(row, rowBytes);
+        });
+      }
+      break;
     }
-    Serial.println(F("[CMD] base offsets reset"));
-    refreshDisplay(false);
-    return;
+    case RenderJob::Type::PlaneEnd:
+      display.epd2.rawEndData();
+      if (isPackedTarget(job.target) && !(g_rowDecodeOk && g_rowDecoder.finished()))
+      {
+        Serial.print(F("[ERR] bin packed plane malformed after "));
+        Serial.print(g_rowDecoder.rows());
+        Serial.println(F(" rows"));
+      }
+      else if (job.crcOk)
+      {
+        Serial.print(F("[BIN] ok "));
+        Serial.println(static_cast<char>(job.target));
+      }
+      else
+      {
+        Serial.println(F("[ERR] bin CRC mismatch, plane data already written"));
+      }
+      break;
+    case RenderJob::Type::Window:
+    {
+      const uint16_t x0 = frameWord(job.line, 0);
+      const uint16_t x1 = frameWord(job.line, 1);
+      const uint16_t y0 = frameWord(job.line, 2);
+      const uint16_t y1 = frameWord(job.line, 3);
+      ensureInit();
+      display.invalidateTracking();
+      LabBus bus;
+      setRamWindow(bus, Controller(), x0, x1, y0, y1);
+      Serial.println(F("[BIN] ok W"));
+      break;
+    }
+    case RenderJob::Type::Update:
+      ensureInit();
+      display.invalidateTracking();
+      triggerUpdate(Controller(), "bin update");
+      Serial.println(F("[BIN] ok U"));
+      break;
+    default:
+      break;
   }
-  if (lower.startsWith("rawcmd"))
+}
+
+static void runFrameJob(const RenderJob &job)
+{
+  if (job.family == ControllerFamily::Ssd16xx)
   {
-    commandRaw(line.substring(6));
-    return;
+    runFrameJobOn<Ssd16xxController>(job);
   }
-  if (lower.startsWith("gate"))
+  else
   {
-    commandGate(line.substring(4));
-    return;
+    runFrameJobOn<Uc8151Controller>(job);
   }
-  if (lower.startsWith("hs"))
+}
+
+static CommandKind classifyCommand(const char *line)
+{
+  const Command *command = lookupCommand(line);
+  return command != nullptr ? command->kind : CommandKind::Info;
+}
+
+static void copyLine(char *dst, const char *src)
+{
+  strncpy(dst, src, SERIAL_LINE_MAX - 1);
+  dst[SERIAL_LINE_MAX - 1] = '\0';
+}
+
+// Reads whatever bytes are available without blocking; complete lines go
+// to the command queue. Reading pauses while the queue is full.
+static void handleSerial()
+{
+  if (g_binaryMode)
   {
-    commandHScan(line.substring(2));
+    handleBinary();
     return;
   }
-  if (lower.startsWith("diag"))
+  // text that followed an Exit frame in the same read
+  while (!g_commandQueue.full() && g_binaryInputPos < g_binaryInputLength)
   {
-    commandDiagBlock(line.substring(4));
-    return;
+    acceptTextByte(static_cast<char>(g_binaryInput[g_binaryInputPos++]));
   }
-  if (lower.startsWith("wash"))
+  while (!g_commandQueue.full() && Serial.available() > 0)
   {
-    commandWash();
-    return;
+    const int c = Serial.read();
+    if (c < 0) break;
+    g_lastInputMs = millis();
+    acceptTextByte(static_cast<char>(c));
   }
-  if (lower.startsWith("clear"))
+}
+
+static void acceptTextByte(char c)
+{
+  if (!g_lineIn.feed(c)) return;
+  if (g_lineIn.overflow())
   {
-    commandFullClear();
-    return;
+    Serial.println(F("[ERR] line too long, truncated"));
+  }
+  g_commandQueue.push(g_lineIn.line(), g_lineIn.length());
+}
+
+// Every decoder event turns into at most one render job, so input is only
+// read while the renderer has a free slot; payload is never staged whole.
+static void handleBinary()
+{
+  while (g_binaryMode && renderQueueSpace() > 0)
+  {
+    if (g_binaryInputPos == g_binaryInputLength)
+    {
+      const int available = Serial.available();
+      if (available <= 0) return;
+      const size_t want = static_cast<size_t>(available) < sizeof(g_binaryInput) ? static_cast<size_t>(available)
+                                                                                  : sizeof(g_binaryInput);
+      g_binaryInputLength = Serial.readBytes(g_binaryInput, want);
+      g_binaryInputPos = 0;
+      g_lastInputMs = millis();
+      if (g_binaryInputLength == 0) return;
+    }
+    FrameEvent event;
+    g_binaryInputPos += g_frameDecoder.feed(g_binaryInput + g_binaryInputPos,
+                                            g_binaryInputLength - g_binaryInputPos, event);
+    onFrameEvent(event);
   }
-  if (lower.startsWith("contrast"))
+}
+
+static bool isPlaneTarget(uint8_t target)
+{
+  return target == static_cast<uint8_t>(FrameTarget::Black) || target == static_cast<uint8_t>(FrameTarget::Red) ||
+         isPackedTarget(target);
+}
+
+static bool frameLengthValid(uint8_t target, uint16_t length)
+{
+  switch (static_cast<FrameTarget>(target))
   {
-    commandContrastCycle();
-    return;
+    case FrameTarget::Black:
+    case FrameTarget::Red:
+    case FrameTarget::PackedBlack:
+    case FrameTarget::PackedRed:
+      return length > 0;
+    case FrameTarget::Window:
+      return length == FRAME_WINDOW_BYTES;
+    case FrameTarget::Update:
+    case FrameTarget::Exit:
+      return length == 0;
+    default:
+      return false;
   }
+}
 
-  const char cmd = tolower(line.charAt(0));
-  switch (cmd)
+static void onFrameEvent(const FrameEvent &event)
+{
+  switch (event.kind)
   {
-    case 'h':
-      showHelp();
-      break;
-    case 's':
-      printStatus();
-      break;
-    case 'd':
-      Serial.println(F("[CMD] redraw"));
-      refreshDisplay(false);
+    case FrameEvent::Kind::Begin:
+      g_frameWindowLength = 0;
+      g_frameDiscard = !frameLengthValid(event.target, event.length);
+      if (!g_frameDiscard && isPlaneTarget(event.target))
+      {
+        RenderJob job = makeJob(RenderJob::Type::PlaneBegin);
+        job.target = event.target;
+        submitJob(job);
+      }
       break;
-    case 'r':
-      g_offsetX = 0;
-      g_offsetY = 0;
-      Serial.println(F("[CMD] user offsets reset"));
-      refreshDisplay(false);
+    case FrameEvent::Kind::Data:
+      if (g_frameDiscard) break;
+      if (isPlaneTarget(event.target))
+      {
+        RenderJob job = makeJob(RenderJob::Type::PlaneData);
+        job.target = event.target;
+        job.size = static_cast<uint8_t>(event.size);
+        memcpy(job.line, event.data, event.size);
+        submitJob(job);
+      }
+      else
+      {
+        memcpy(g_frameWindow + g_frameWindowLength, event.data, event.size);
+        g_frameWindowLength += event.size;
+      }
       break;
-    case 'o':
-    {
-      int16_t newX = g_offsetX;
-      int16_t newY = g_offsetY;
-      if (!parseOffsetValues(line.substring(1), newX, newY))
+    case FrameEvent::Kind::End:
+      if (g_frameDiscard)
       {
-        Serial.println(F("[ERR] usage: o <x> <y>"));
+        Serial.print(F("[ERR] bin bad frame target=0x"));
+        Serial.print(event.target, HEX);
+        Serial.print(F(" len="));
+        Serial.println(event.length);
         break;
       }
-      g_offsetX = newX;
-      g_offsetY = newY;
-      Serial.print(F("[CMD] offsets updated to "));
-      Serial.print(g_offsetX);
-      Serial.print(',');
-      Serial.println(g_offsetY);
-      refreshDisplay(false);
+      if (isPlaneTarget(event.target))
+      {
+        RenderJob job = makeJob(RenderJob::Type::PlaneEnd);
+        job.target = event.target;
+        job.crcOk = event.crcOk;
+        submitJob(job);
+        break;
+      }
+      if (!event.crcOk)
+      {
+        Serial.println(F("[ERR] bin CRC mismatch, frame dropped"));
+        break;
+      }
+      if (event.target == static_cast<uint8_t>(FrameTarget::Exit))
+      {
+        g_binaryMode = false;
+        Serial.println(F("[BIN] exit"));
+        break;
+      }
+      {
+        const bool window = event.target == static_cast<uint8_t>(FrameTarget::Window);
+        RenderJob job = makeJob(window ? RenderJob::Type::Window : RenderJob::Type::Update);
+        job.target = event.target;
+        memcpy(job.line, g_frameWindow, g_frameWindowLength);
+        job.size = static_cast<uint8_t>(g_frameWindowLength);
+        submitJob(job);
+      }
       break;
-    }
     default:
-      Serial.println(F("[ERR] unknown command; use 'h' for help"));
       break;
   }
 }
 
-static void handleSerial()
+// Barrier commands become panel jobs behind any pending redraw. When the
+// renderer has no room the line stays queued, which in turn stops reading.
+static void runCommandQueue()
+{
+  while (!g_binaryMode && !g_commandQueue.empty())
+  {
+    const char *queued = g_commandQueue.front();
+    const CommandKind kind = classifyCommand(queued);
+    if (kind != CommandKind::Barrier && kind != CommandKind::Stream)
+    {
+      char line[SERIAL_LINE_MAX];
+      copyLine(line, queued);
+      g_commandQueue.pop();
+      processCommand(line);
+      continue;
+    }
+    if (renderQueueSpace() < (g_redrawPending ? 2u : 1u)) return;
+    if (kind == CommandKind::Stream)
+    {
+      char line[SERIAL_LINE_MAX];
+      copyLine(line, queued);
+      g_commandQueue.pop();
+      flushRedraw();
+      processCommand(line);
+      continue;
+    }
+    RenderJob job = makeJob(RenderJob::Type::Panel);
+    copyLine(job.line, queued);
+    g_commandQueue.pop();
+    flushRedraw();
+    submitJob(job);
+  }
+  if (g_redrawPending && millis() - g_lastInputMs >= COALESCE_QUIET_MS && renderQueueSpace() > 0)
+  {
+    flushRedraw();
+  }
+}
+
+static void startPanel()
 {
-  if (!Serial.available()) return;
-  String line = Serial.readStringUntil('\n');
-  line.trim();
-  processCommand(line);
+  ensureInit();
+  Serial.println(F("[EPD] init done (GxEPD2_213c lab mode)"));
 }
 
 void setup()
 {
   Serial.begin(115200);
-  SPI.setSCK(PIN_SCK);
-  SPI.setTX(PIN_MOSI);
-  SPI.setRX(PIN_MISO);
-
-  ensureInit();
-  display.setRotation(g_rotation);
+  g_epdSpi.setSCK(PIN_SCK);
+  g_epdSpi.setTX(PIN_MOSI);
+  g_epdSpi.setRX(PIN_MISO);
 
-  Serial.println(F("[EPD] init done (GxEPD2_213c lab mode)"));
-  refreshDisplay(false);
+#if EPD_RENDER_CORE1
+  // core1 waits for the SPI pins before it touches the panel
+  rp2040.fifo.push(CORE1_START);
+#else
+  startPanel();
+#endif
+  requestRedraw(true, false);
+  flushRedraw();
   showHelp();
   printStatus();
   Serial.println(F("[NOTE] Full refresh can take >10s on tri-colour panels"));
@@ -625,6 +2101,33 @@ void setup()
 void loop()
 {
   handleSerial();
+  runCommandQueue();
+#if !EPD_RENDER_CORE1
+  pollDisplay();
+#endif
+}
+
+#if EPD_RENDER_CORE1
+// Core1 owns the display: init, rendering, SPI and the BUSY interrupt,
+// which attachInterrupt() routes to the core that registered it.
+void setup1()
+{
+  while (rp2040.fifo.pop() != CORE1_START)
+  {
+  }
+  startPanel();
+  Serial.println(F("[EPD] rendering on core1"));
+}
+
+void loop1()
+{
+  RenderJob job;
+  if (g_renderQueue.pop(job))
+  {
+    runJob(job);
+  }
+  pollDisplay();
 }
+#endif
 
 
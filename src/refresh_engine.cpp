@@ -0,0 +1,160 @@
+#include "refresh_engine.h"
+
+constexpr RefreshOpcodes RefreshEngine::UC8151_OPCODES;
+constexpr RefreshDeadlines RefreshEngine::UC8151_DEADLINES;
+
+RefreshEngine::RefreshEngine(const RefreshDeadlines &deadlines, const RefreshOpcodes &opcodes)
+  : _deadlines(deadlines), _opcodes(opcodes)
+{
+}
+
+void RefreshEngine::setDeadlines(const RefreshDeadlines &deadlines)
+{
+  _deadlines = deadlines;
+}
+
+bool RefreshEngine::start(RefreshPort &port, bool powerOn)
+{
+  if (busy()) return false;
+  _powerOn = powerOn;
+  _failedPhase = RefreshPhase::Idle;
+  _powerOffSent = false;
+  _startMs = port.nowMs();
+  enter(port, RefreshPhase::Init, _startMs);
+  return true;
+}
+
+void RefreshEngine::notifyBusyEdge(uint32_t nowMs)
+{
+  _edgeMs = nowMs;
+  _edgeSeen = true;
+}
+
+RefreshEvent RefreshEngine::poll(RefreshPort &port)
+{
+  if (!busy()) return RefreshEvent::None;
+  const uint32_t now = port.nowMs();
+
+  // The edge flag is a hint; the level is what decides, so a missed or
+  // spurious interrupt cannot wedge the sequence.
+  if (port.busyActive())
+  {
+    _busySeen = true;
+    if (now - _phaseStartMs > deadlineFor(_phase))
+    {
+      _failedPhase = _phase;
+      // Do not leave the booster on: the panel takes power-off once the
+      // stuck phase ends. Nothing was powered on before Init ran out.
+      if (_phase == RefreshPhase::PowerOn || _phase == RefreshPhase::Refresh)
+      {
+        port.sendCommand(_opcodes.powerOff);
+        _powerOffSent = true;
+      }
+      _phase = RefreshPhase::Idle;
+      _lastDurationMs = now - _startMs;
+      return RefreshEvent::Timeout;
+    }
+    return RefreshEvent::None;
+  }
+
+  // BUSY rises a moment after the opcode; an idle line that was never seen
+  // busy only counts once the settle time has passed.
+  if (!_busySeen && _phase != RefreshPhase::Init && now - _phaseStartMs < BUSY_SETTLE_MS)
+  {
+    return RefreshEvent::None;
+  }
+
+  const uint32_t releasedMs = _edgeSeen ? _edgeMs : now;
+  _edgeSeen = false;
+  const RefreshPhase next = nextPhase(_phase);
+  if (next == RefreshPhase::Idle)
+  {
+    _phase = RefreshPhase::Idle;
+    _lastDurationMs = releasedMs - _startMs;
+    return RefreshEvent::Done;
+  }
+  enter(port, next, now);
+  return RefreshEvent::None;
+}
+
+RefreshEvent RefreshEngine::finish(RefreshPort &port)
+{
+  RefreshEvent event = RefreshEvent::None;
+  while (busy())
+  {
+    event = poll(port);
+  }
+  return event;
+}
+
+void RefreshEngine::enter(RefreshPort &port, RefreshPhase phase, uint32_t nowMs)
+{
+  _phase = phase;
+  _phaseStartMs = nowMs;
+  _busySeen = false;
+  _edgeSeen = false;
+  switch (phase)
+  {
+    case RefreshPhase::PowerOn:
+      port.sendCommand(_opcodes.powerOn);
+      break;
+    case RefreshPhase::Refresh:
+      port.sendCommand(_opcodes.refresh);
+      break;
+    case RefreshPhase::PowerOff:
+      port.sendCommand(_opcodes.powerOff);
+      _powerOffSent = true;
+      break;
+    default:
+      break;
+  }
+}
+
+RefreshPhase RefreshEngine::nextPhase(RefreshPhase phase) const
+{
+  switch (phase)
+  {
+    case RefreshPhase::Init:
+      return _powerOn ? RefreshPhase::PowerOn : RefreshPhase::Refresh;
+    case RefreshPhase::PowerOn:
+      return RefreshPhase::Refresh;
+    case RefreshPhase::Refresh:
+      return RefreshPhase::PowerOff;
+    default:
+      return RefreshPhase::Idle;
+  }
+}
+
+uint32_t RefreshEngine::deadlineFor(RefreshPhase phase) const
+{
+  switch (phase)
+  {
+    case RefreshPhase::Init:
+      return _deadlines.initMs;
+    case RefreshPhase::PowerOn:
+      return _deadlines.powerOnMs;
+    case RefreshPhase::Refresh:
+      return _deadlines.refreshMs;
+    case RefreshPhase::PowerOff:
+      return _deadlines.powerOffMs;
+    default:
+      return 0;
+  }
+}
+
+const char *RefreshEngine::phaseName(RefreshPhase phase)
+{
+  switch (phase)
+  {
+    case RefreshPhase::Init:
+      return "init";
+    case RefreshPhase::PowerOn:
+      return "power-on";
+    case RefreshPhase::Refresh:
+      return "refresh";
+    case RefreshPhase::PowerOff:
+      return "power-off";
+    default:
+      return "idle";
+  }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+// renderDiagnostics() of src/main.cpp on a PlaneRaster, for the host tools
+// that need the frame the firmware shows: the same lines, outline, centre
+// box and status text at the same positions for a given state, the text in
+// the 5x8 font drawn through GlyphCache and wrapped as
+// PlaneDisplay::write() does. Font[] of TextFonts.h stands in for
+// Adafruit's glcdfont, which is not part of this tree. Host tools only.
+
+#include "TextFonts.h"
+#include "glyph_cache.h"
+#include "plane_raster.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// The part of main.cpp's DiagState one frame shows.
+struct DiagView
+{
+  int16_t offsetX = 0;
+  int16_t offsetY = 0;
+  uint8_t rotation = 1;
+  int16_t baseX = 0;  // base offsets of this rotation
+  int16_t baseY = 0;
+  uint8_t busy = 0;   // the BUSY level printed in the status line
+};
+
+template <typename PanelT, size_t GlyphBudget = 2048>
+class DiagFrame
+{
+public:
+  static constexpr uint16_t WHITE = 0xFFFF;
+  static constexpr uint16_t BLACK = 0x0000;
+  static constexpr uint16_t RED = 0xF800;
+
+  template <typename Raster>
+  void draw(Raster &raster, const DiagView &view)
+  {
+    const uint8_t rotation = view.rotation & 3;
+    const int16_t w = PanelT::widthFor(rotation);
+    const int16_t h = PanelT::heightFor(rotation);
+    const int16_t ox = view.baseX + view.offsetX;
+    const int16_t oy = view.baseY + view.offsetY;
+    const PlaneInk black = planeInk(BLACK);
+
+    raster.fill(planeInk(WHITE));
+    raster.fillRect(rotation, ox, h / 2 + oy, w, 1, black);
+    raster.fillRect(rotation, w / 2 + ox, oy, 1, h, black);
+    raster.fillRect(rotation, ox, oy, w, 1, black);
+    raster.fillRect(rotation, ox, oy + h - 1, w, 1, black);
+    raster.fillRect(rotation, ox, oy, 1, h, black);
+    raster.fillRect(rotation, ox + w - 1, oy, 1, h, black);
+    const int16_t box = 48;
+    raster.fillRect(rotation, w / 2 + ox - box / 2, h / 2 + oy - box / 2, box, box, planeInk(RED));
+
+    char line[48];
+    text(raster, rotation, w, 10 + ox, 16 + oy, "Diag GxEPD2_213c");
+    snprintf(line, sizeof(line), "w=%d h=%d", w, h);
+    text(raster, rotation, w, 10 + ox, 36 + oy, line);
+    snprintf(line, sizeof(line), "rot=%u busy=%u", rotation, view.busy);
+    text(raster, rotation, w, 10 + ox, h - 24 + oy, line);
+    snprintf(line, sizeof(line), "off=%d,%d base=%d,%d", view.offsetX, view.offsetY, view.baseX, view.baseY);
+    text(raster, rotation, w, 10 + ox, h - 10 + oy, line);
+  }
+
+private:
+  static constexpr char CLASSIC_FIRST = 0x20;
+  static constexpr uint16_t CLASSIC_COUNT = sizeof(Font) / 5;
+
+  template <typename Raster>
+  void text(Raster &raster, uint8_t rotation, int16_t w, int16_t x, int16_t y, const char *s)
+  {
+    const GlyphFace face = GlyphFace::columns(reinterpret_cast<const uint8_t *>(Font), CLASSIC_FIRST, CLASSIC_COUNT);
+    _glyphs.bind(face);
+    for (; *s; ++s)
+    {
+      GlyphSource glyph;
+      if (!face.glyph(static_cast<uint8_t>(*s), glyph)) continue;
+      if (x + 6 > w)
+      {
+        x = 0;
+        y += 8;
+      }
+      if (!_glyphs.draw(raster, rotation, static_cast<uint8_t>(*s), glyph, x, y, planeInk(BLACK)))
+      {
+        fprintf(stderr, "glyph 0x%02X did not fit a slot\n", *s);
+        exit(1);
+      }
+      x += glyph.xAdvance;
+    }
+  }
+
+  GlyphCache<PanelT, GlyphBudget> _glyphs;
+};
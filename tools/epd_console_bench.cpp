@@ -0,0 +1,340 @@
+// Host benchmark of the console path: recorded command lines go byte by
+// byte through LineAssembler and LineQueue (include/command_queue.h), are
+// classified, copied, split by splitArgs() and dispatched through the
+// firmware's command table (include/console_commands.h) to handlers that
+// parse their arguments with the firmware's parsers. Prints ns per command
+// and the heap allocations made on the way, which must be zero: a counting
+// operator new replaces the global one.
+//
+// Build (Linux/macOS):
+//   c++ -std=c++17 -O2 -Iinclude tools/epd_console_bench.cpp -o epd_console_bench
+//
+// Usage:
+//   epd_console_bench [--lines N] [SESSION]
+//
+// SESSION holds console lines as typed ('[' output lines and '#' comments
+// are skipped); without it a built-in session is used that also has
+// unknown commands, bad numbers and wrong argument counts. The session is
+// replayed until N lines (1000000 by default) have been dispatched.
+// Exits non-zero if any allocation happened while timing.
+
+#include "command_queue.h"
+#include "console_commands.h"
+
+#include <chrono>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+static constexpr size_t SERIAL_LINE_MAX = 96;
+static constexpr size_t COMMAND_QUEUE_DEPTH = 8;
+
+static size_t g_allocations = 0;
+
+void *operator new(size_t size)
+{
+  ++g_allocations;
+  void *p = malloc(size ? size : 1);
+  if (p == nullptr) throw std::bad_alloc();
+  return p;
+}
+
+void *operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void *p) noexcept
+{
+  free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+  free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+  free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+  free(p);
+}
+
+// What the firmware's handlers would change, so the parsing is not dead code.
+struct BenchState
+{
+  int16_t offsetX = 0;
+  int16_t offsetY = 0;
+  uint8_t rotation = 1;
+  int16_t baseX[4] = {};
+  int16_t baseY[4] = {};
+  uint32_t rawBytes = 0;
+  uint32_t redraws = 0;
+  uint32_t barriers = 0;
+  uint32_t info = 0;
+  uint32_t parseErrors = 0;
+  uint32_t unknown = 0;
+  uint32_t usageErrors = 0;
+};
+
+static BenchState g_state;
+
+struct BenchCommands
+{
+  using Fn = void (*)(size_t argc, char **argv);
+
+  static void base(size_t, char **argv)
+  {
+    uint8_t rot = 0;
+    int16_t x = 0;
+    int16_t y = 0;
+    if (!parseRotationValue(argv[0], rot) || !parseOffset(argv[1], x) || !parseOffset(argv[2], y))
+    {
+      ++g_state.parseErrors;
+      return;
+    }
+    g_state.baseX[rot] = x;
+    g_state.baseY[rot] = y;
+  }
+
+  static void binary(size_t, char **)
+  {
+    ++g_state.barriers;
+  }
+
+  static void redraw(size_t argc, char **argv)
+  {
+    if (argc > 0 && strcmp(argv[0], "force") != 0) ++g_state.parseErrors;
+    ++g_state.redraws;
+  }
+
+  static void barrier(size_t, char **)
+  {
+    ++g_state.barriers;
+  }
+
+  // gate, hs and diag take decimal numbers
+  static void numbers(size_t argc, char **argv)
+  {
+    for (size_t i = 0; i < argc; ++i)
+    {
+      long value = 0;
+      if (!parseNumber(argv[i], value, 10))
+      {
+        ++g_state.parseErrors;
+        return;
+      }
+    }
+    ++g_state.barriers;
+  }
+
+  static void info(size_t, char **)
+  {
+    ++g_state.info;
+  }
+
+  static void offsets(size_t, char **argv)
+  {
+    int16_t x = 0;
+    int16_t y = 0;
+    if (!parseOffset(argv[0], x) || !parseOffset(argv[1], y))
+    {
+      ++g_state.parseErrors;
+      return;
+    }
+    g_state.offsetX = x;
+    g_state.offsetY = y;
+  }
+
+  static void resetOffsets(size_t, char **)
+  {
+    g_state.offsetX = 0;
+    g_state.offsetY = 0;
+  }
+
+  static void raw(size_t argc, char **argv)
+  {
+    uint8_t data[RAW_DATA_MAX + 1];
+    for (size_t i = 0; i < argc; ++i)
+    {
+      if (!parseHexByte(argv[i], data[i]))
+      {
+        ++g_state.parseErrors;
+        return;
+      }
+    }
+    g_state.rawBytes += data[0] + static_cast<uint32_t>(argc);
+  }
+
+  static void resetBase(size_t, char **)
+  {
+    const uint8_t r = g_state.rotation & 3;
+    g_state.baseX[r] = 0;
+    g_state.baseY[r] = 0;
+  }
+
+  static void rotation(size_t, char **argv)
+  {
+    if (!parseRotationValue(argv[0], g_state.rotation)) ++g_state.parseErrors;
+  }
+
+  static constexpr Fn clear = barrier;
+  static constexpr Fn contrast = barrier;
+  static constexpr Fn diag = numbers;
+  static constexpr Fn gate = numbers;
+  static constexpr Fn help = info;
+  static constexpr Fn hscan = numbers;
+  static constexpr Fn status = info;
+  static constexpr Fn wash = barrier;
+};
+
+using Command = ConsoleCommands<BenchCommands>::Spec;
+static constexpr const auto &COMMANDS = ConsoleCommands<BenchCommands>::table;
+static_assert(commandTableSorted(COMMANDS), "COMMANDS must be sorted by name");
+
+// As main.cpp: classifyCommand() when the line is queued, processCommand()
+// on a copy when it runs.
+static CommandKind classifyCommand(const char *line)
+{
+  size_t length = 0;
+  const char *word = commandWord(line, length);
+  const Command *command = length > 0 ? findCommand(COMMANDS, word, length) : nullptr;
+  return command != nullptr ? command->kind : CommandKind::Info;
+}
+
+static void processCommand(char *line)
+{
+  char *argv[COMMAND_ARGS_MAX + 1];
+  const size_t count = splitArgs(line, argv, COMMAND_ARGS_MAX + 1);
+  if (count == 0) return;
+  const Command *command = findCommand(COMMANDS, argv[0], strlen(argv[0]));
+  if (command == nullptr)
+  {
+    ++g_state.unknown;
+    return;
+  }
+  const size_t argc = count - 1;
+  if (argc < command->minArgs || argc > command->maxArgs)
+  {
+    ++g_state.usageErrors;
+    return;
+  }
+  command->run(argc, argv + 1);
+}
+
+static const char *const BUILTIN_SESSION[] = {
+  "o 5 0", "o -3 2", "rot 0", "rot 1", "base 1 2 -1", "rb", "r", "d", "d force", "s",
+  "rawcmd 12", "rawcmd 50 97", "rawcmd 61 68 00 D4", "gate 0 211", "hs 8 96", "diag 16 87 50 150",
+  "O 1 1", "  o   2\t3  ", "wash", "clear", "h", "bogus", "o 1", "rot 7", "rawcmd 1FF", "base 4 0 0",
+};
+
+int main(int argc, char **argv)
+{
+  size_t lines = 1000000;
+  const char *sessionPath = nullptr;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (arg == "--lines" && i + 1 < argc)
+    {
+      lines = strtoul(argv[++i], nullptr, 0);
+    }
+    else if (arg[0] != '-' && sessionPath == nullptr)
+    {
+      sessionPath = argv[i];
+    }
+    else
+    {
+      fprintf(stderr, "usage: epd_console_bench [--lines N] [SESSION]\n");
+      return 2;
+    }
+  }
+
+  // Loaded before timing; the replay itself reads from this buffer.
+  std::string session;
+  size_t sessionLines = 0;
+  if (sessionPath != nullptr)
+  {
+    FILE *f = fopen(sessionPath, "r");
+    if (f == nullptr)
+    {
+      perror(sessionPath);
+      return 2;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), f))
+    {
+      if (line[0] == '[' || line[0] == '#' || line[0] == '\n' || line[0] == '\r') continue;
+      session += line;
+      if (session.back() != '\n') session += '\n';
+      ++sessionLines;
+    }
+    fclose(f);
+  }
+  else
+  {
+    for (const char *line : BUILTIN_SESSION)
+    {
+      session += line;
+      session += '\n';
+      ++sessionLines;
+    }
+  }
+  if (sessionLines == 0 || lines == 0)
+  {
+    fprintf(stderr, "nothing to replay\n");
+    return 2;
+  }
+
+  static LineAssembler<SERIAL_LINE_MAX> lineIn;
+  static LineQueue<COMMAND_QUEUE_DEPTH, SERIAL_LINE_MAX> queue;
+  const char *const text = session.c_str();
+  const size_t textLength = session.size();
+  size_t pos = 0;
+  size_t dispatched = 0;
+  uint32_t kinds[5] = {};
+
+  const size_t allocationsBefore = g_allocations;
+  const auto t0 = std::chrono::steady_clock::now();
+  while (dispatched < lines)
+  {
+    if (lineIn.feed(text[pos]))
+    {
+      queue.push(lineIn.line(), lineIn.length());
+    }
+    if (++pos == textLength) pos = 0;
+    while (!queue.empty())
+    {
+      ++kinds[static_cast<uint8_t>(classifyCommand(queue.front()))];
+      char line[SERIAL_LINE_MAX];
+      strncpy(line, queue.front(), SERIAL_LINE_MAX - 1);
+      line[SERIAL_LINE_MAX - 1] = '\0';
+      queue.pop();
+      processCommand(line);
+      ++dispatched;
+    }
+  }
+  const auto t1 = std::chrono::steady_clock::now();
+  const size_t allocations = g_allocations - allocationsBefore;
+
+  const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  printf("%zu lines (%zu-line session), %zu commands in the table\n", dispatched, sessionLines,
+         sizeof(COMMANDS) / sizeof(COMMANDS[0]));
+  printf("  %.1f ns/command, %.1f ms total\n", ns / dispatched, ns / 1e6);
+  printf("  kinds: info %u, state %u, redraw %u, barrier %u, stream %u\n", kinds[0], kinds[1], kinds[2], kinds[3],
+         kinds[4]);
+  printf("  unknown %u, usage errors %u, parse errors %u\n", g_state.unknown, g_state.usageErrors,
+         g_state.parseErrors);
+  printf("  state: off=%d,%d rot=%u raw=%u redraws=%u barriers=%u\n", g_state.offsetX, g_state.offsetY,
+         g_state.rotation, g_state.rawBytes, g_state.redraws, g_state.barriers);
+  printf("  heap allocations while dispatching: %zu\n", allocations);
+  printf("%s\n", allocations == 0 ? "ok" : "FAILED");
+  return allocations == 0 ? 0 : 1;
+}
@@ -0,0 +1,860 @@
+// Replays a recorded console session against a timing model of the panel
+// path and prints where the wall time goes, per command.
+//
+// Build (Linux/macOS):
+//   c++ -std=c++17 -O2 -Iinclude -Ilib/pio_ws2812_E-ink/generated -Itools
+//       tools/epd_cost.cpp src/refresh_engine.cpp -o epd_cost
+//
+// Usage:
+//   epd_cost [--spi-hz N] [--cs-us X] [--busy KIND=MS].. [--timeout MS] [SESSION]
+//
+// Exits with 1 when a partial step costs more than a full frame push would.
+//
+// SESSION (default stdin) holds console lines as typed: 'd', 'o 5 0',
+// 'wash', 'diag 16 87 50 150', ... Lines starting with '[' (firmware
+// output) are skipped, so a captured monitor log works as-is. A blank line
+// stands for an input pause longer than COALESCE_QUIET_MS; '# wait MS'
+// lets MS of idle time pass, '#' starts any other comment.
+//
+// Lines go through the firmware's command table and argument parsers
+// (console_commands.h) with the same kinds and the same coalescing rules as
+// runCommandQueue(). Each redraw renders the diagnostics frame
+// (tools/diag_frame.h) and diffs it against the frame last pushed with
+// FrameShadow (frame_diff.h). Runs of changed rows are merged by the
+// firmware's DirtyRegion (dirty_rect.h) into at most PARTIAL_MAX_WINDOWS
+// windows, or into one without Panel::fastPartialRefresh: no change skips
+// the refresh, windows within PARTIAL_MAX_AREA_PCT of the screen go out as
+// partial pushes, anything else as a full frame. A partial push on a panel
+// without a fast partial waveform writes its window and refreshes the panel
+// asynchronously like a full frame; otherwise each window is a blocking
+// partial refresh. The
+// firmware takes its boxes from the primitives it drew rather than from
+// pixel rows, so where an offset nudge moves the text, the box and the
+// outline together it can still fit partial windows where this charges a
+// full refresh. Async refreshes run through RefreshEngine against a
+// FakeBusyLine with the firmware's phase deadlines. Bus cost is
+// bytes * 8 / spi-hz plus cs-us per CS window, with the transaction pattern
+// GxEPD2_213c and the GxEPD2_213c_Lab raw paths produce. KIND is one of
+// power-on, power-off, full, partial, ssd (the 0x20 trigger of 'diag' and
+// 'bin ssd' updates).
+//
+// Defaults: 4 MHz (GxEPD2_EPD SPISettings; ws2812.c runs SPI_BAUD 2 MHz),
+// GxEPD2_213c power/refresh times. The 20 s refresh deadline of
+// RefreshEngine::UC8151_DEADLINES bounds async refreshes; --timeout is
+// GxEPD2's own BUSY timeout, 9 s as BUSY_TIMEOUT_MS in main.cpp, and only
+// bounds the blocking waits ('clear', 'wash', blocking partial refreshes),
+// so a 15 s blocking full refresh is reported as a BUSY timeout there as it
+// would be on the board.
+//
+// The cost of a step is its bus, blocking BUSY and async refresh time; a
+// partial step must not cost more than writing both planes and refreshing
+// them asynchronously, or the partial path is not worth taking.
+
+#include "console_commands.h"
+#include "diag_frame.h"
+#include "dirty_rect.h"
+#include "fake_busy_line.h"
+#include "frame_diff.h"
+#include "panel_traits.h"
+#include "plane_raster.h"
+#include "refresh_engine.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// The firmware's panel and the controller its raw lab commands address
+using Panel = Panel213c;
+using Uc = Panel::Controller;
+using Lab = Ssd16xxController;
+using Raster = PlaneRaster<Panel>;
+using Shadow = FrameShadow<Panel>;
+static constexpr size_t SERIAL_LINE_MAX = 96;
+static constexpr uint8_t PARTIAL_MAX_AREA_PCT = 75;
+static constexpr uint8_t PARTIAL_MAX_WINDOWS = 2;
+
+struct CostModel
+{
+  uint32_t spiHz = 4000000;
+  double csUs = 5.0;
+  uint32_t powerOnMs = 40;
+  uint32_t powerOffMs = 30;
+  uint32_t fullMs = 15000;
+  uint32_t partialMs = 15000;
+  uint32_t ssdMs = 15000;
+  uint32_t timeoutMs = 9000;
+};
+
+// One row of the breakdown: a console line or a coalesced redraw.
+struct Row
+{
+  unsigned line = 0;
+  std::string text;
+  uint32_t transactions = 0;
+  uint32_t bytes = 0;
+  double spiMs = 0;
+  double waitMs = 0;
+  double busyMs = 0;
+  double delayMs = 0;
+  double asyncMs = 0;
+  bool partial = false;
+  std::string note;
+
+  double totalMs() const
+  {
+    return spiMs + waitMs + busyMs + delayMs;
+  }
+
+  double stepMs() const
+  {
+    return spiMs + busyMs + asyncMs;
+  }
+
+  void addNote(const char *text)
+  {
+    if (!note.empty()) note += ", ";
+    note += text;
+  }
+};
+
+// Mirrors DiagState and the parts of it renderDiagnostics() draws.
+struct DiagState
+{
+  int16_t offsetX = 0;
+  int16_t offsetY = 0;
+  uint8_t rotation = 1;
+  int16_t baseX[4] = {};
+  int16_t baseY[4] = {};
+};
+
+class Replay;
+
+// Wall clock of the console core with the panel as the only resource. Every
+// bus access waits for a running async refresh first, as finishRefresh()
+// does in GxEPD2_213c_Lab.
+class Replay
+{
+public:
+  explicit Replay(const CostModel &model) : _model(model)
+  {
+    _busy.setBusyFor(Uc::powerOn, model.powerOnMs);
+    _busy.setBusyFor(Uc::displayRefresh, model.fullMs);
+    _busy.setBusyFor(Uc::powerOff, model.powerOffMs);
+  }
+
+  DiagState state;
+
+  void feedLine(unsigned number, const char *text);
+  void pause()
+  {
+    flushRedraw();
+  }
+  void idle(uint32_t ms)
+  {
+    flushRedraw();
+    _idleMs += ms;
+    _nowMs += ms;
+  }
+  void finish();
+  void print() const;
+  bool checkBudget() const;
+
+  // Handler side, mirroring the firmware commands
+  void requestRedraw(bool full, bool force)
+  {
+    _redrawPending = true;
+    _fullPending |= full;
+    _forcePending |= force;
+    _coalesced.push_back(_current);
+  }
+  void rawCommand();
+  void rawData(size_t count);
+  void diagBlock();
+  void clearScreen();
+  void redraw(bool allowPartial, bool force);
+  DirtyRegion changedWindows() const;
+  void delay(uint32_t ms)
+  {
+    _row->delayMs += ms;
+    _nowMs += ms;
+  }
+  void note(const char *text)
+  {
+    _row->addNote(text);
+  }
+  void forgetFrame()
+  {
+    _shown.invalidate();
+    _hashValid = false;
+  }
+
+private:
+  void flushRedraw();
+  void beginRow(unsigned line, const std::string &text);
+  void transaction(size_t bytes);
+  void command(uint8_t cmd)
+  {
+    (void)cmd;
+    transaction(1);
+  }
+  void dataBytes(size_t count)
+  {
+    for (size_t i = 0; i < count; ++i) transaction(1);
+  }
+  void panelInit();
+  void finishRefresh();
+  void waitBusy(uint32_t ms);
+  void powerOn();
+  void partialRamArea();
+  void writeImage(size_t planeBytes);
+  void asyncRefresh();
+  double fullPushMs() const;
+
+  const CostModel &_model;
+  std::vector<Row> _rows;
+  Row *_row = nullptr;
+  std::string _current;
+  std::vector<std::string> _coalesced;
+  double _nowMs = 0;
+  double _idleMs = 0;
+  double _panelBusyUntil = 0;
+  double _engineIdleAt = 0;
+  bool _initialized = false;
+  bool _initialWrite = true;
+  bool _powerOn = false;
+  bool _hashValid = false;
+  DiagFrame<Panel> _diag;
+  Raster _frame;
+  Shadow _shown;
+  bool _redrawPending = false;
+  bool _fullPending = false;
+  bool _forcePending = false;
+  FakeBusyLine _busy;
+  RefreshEngine _engine{RefreshEngine::UC8151_DEADLINES};
+};
+
+void Replay::beginRow(unsigned line, const std::string &text)
+{
+  _rows.emplace_back();
+  _row = &_rows.back();
+  _row->line = line;
+  _row->text = text;
+}
+
+void Replay::transaction(size_t bytes)
+{
+  panelInit();
+  const double ms = _model.csUs / 1000.0 + bytes * 8.0 * 1000.0 / _model.spiHz;
+  ++_row->transactions;
+  _row->bytes += static_cast<uint32_t>(bytes);
+  _row->spiMs += ms;
+  _nowMs += ms;
+}
+
+// GxEPD2_213c::_InitDisplay on first bus use: reset pulses, booster, power
+// on, panel setting, VCOM, resolution; data bytes go out one CS window each.
+void Replay::panelInit()
+{
+  if (_initialized) return;
+  _initialized = true;
+  delay(2 * 20);
+  command(0x06);
+  dataBytes(3);
+  powerOn();
+  command(0x00);
+  dataBytes(1);
+  command(0x50);
+  dataBytes(1);
+  command(0x61);
+  dataBytes(3);
+  _row->addNote("panel init");
+}
+
+void Replay::finishRefresh()
+{
+  if (_engineIdleAt > _nowMs)
+  {
+    _row->waitMs += _engineIdleAt - _nowMs;
+    _nowMs = _engineIdleAt;
+  }
+}
+
+// GxEPD2 _waitWhileBusy: gives up after the busy timeout, the panel itself
+// stays busy for its full time.
+void Replay::waitBusy(uint32_t ms)
+{
+  const double release = (_panelBusyUntil > _nowMs ? _panelBusyUntil : _nowMs) + ms;
+  double wait = release - _nowMs;
+  if (wait > _model.timeoutMs)
+  {
+    wait = _model.timeoutMs;
+    _row->addNote("BUSY timeout");
+  }
+  _panelBusyUntil = release;
+  _row->busyMs += wait;
+  _nowMs += wait;
+}
+
+void Replay::powerOn()
+{
+  if (_powerOn) return;
+  command(Uc::powerOn);
+  waitBusy(_model.powerOnMs);
+  _powerOn = true;
+}
+
+void Replay::partialRamArea()
+{
+  command(Uc::partialWindow);
+  dataBytes(7);
+}
+
+// GxEPD2_213c::writeImage/writeScreenBuffer: partial in, RAM area, both
+// planes streamed in one CS window each, partial out.
+void Replay::writeImage(size_t planeBytes)
+{
+  finishRefresh();
+  if (_initialWrite)
+  {
+    _initialWrite = false;
+    writeImage(Panel::planeBytes);
+  }
+  command(Uc::partialIn);
+  partialRamArea();
+  command(Uc::blackPlane);
+  transaction(planeBytes);
+  command(Uc::redPlane);
+  transaction(planeBytes);
+  command(Uc::partialOut);
+}
+
+// RefreshEngine sequence started from GxEPD2_213c_Lab::refresh(false); the
+// console is free right away, the next bus access waits for the end.
+void Replay::asyncRefresh()
+{
+  finishRefresh();
+  const uint32_t startMs = static_cast<uint32_t>(_nowMs);
+  _busy.advance(startMs - _busy.nowMs());
+  _engine.start(_busy, !_powerOn);
+  RefreshEvent event = RefreshEvent::None;
+  while (event == RefreshEvent::None)
+  {
+    _busy.advance(1);
+    event = _engine.poll(_busy);
+  }
+  if (!_powerOn) command(Uc::powerOn);
+  command(Uc::displayRefresh);
+  command(Uc::powerOff);
+  const double duration = _engine.lastDurationMs();
+  _engineIdleAt = startMs + duration;
+  _panelBusyUntil = _busy.releaseMs() > _engineIdleAt ? _busy.releaseMs() : _engineIdleAt;
+  _row->asyncMs += duration;
+  if (event == RefreshEvent::Timeout)
+  {
+    std::string text = "async timeout in ";
+    text += RefreshEngine::phaseName(_engine.failedPhase());
+    _row->addNote(text.c_str());
+  }
+  _powerOn = false;
+}
+
+void Replay::rawCommand()
+{
+  finishRefresh();
+  forgetFrame();
+  command(0x00);
+}
+
+// One CS window, even for zero bytes (rawBeginData/rawEndData).
+void Replay::rawData(size_t count)
+{
+  finishRefresh();
+  transaction(count);
+}
+
+// commandDiagBlock: both planes in one CS window each, 0x22/0xF7, 0x20 and
+// a blocking wait.
+void Replay::diagBlock()
+{
+  finishRefresh();
+  forgetFrame();
+  const uint16_t w = Panel::widthFor(state.rotation);
+  const uint16_t h = Panel::heightFor(state.rotation);
+  command(Lab::blackPlane);
+  transaction(static_cast<size_t>(w / 8) * h);
+  command(Lab::redPlane);
+  transaction(static_cast<size_t>(w) * h / 8);
+  command(Lab::updateControl);
+  transaction(1);
+  command(Lab::masterActivation);
+  waitBusy(_model.ssdMs);
+}
+
+// Lab::clearScreen -> GxEPD2_213c::clearScreen: screen buffer, then a
+// blocking full refresh.
+void Replay::clearScreen()
+{
+  finishRefresh();
+  _hashValid = false;
+  writeImage(Panel::planeBytes);
+  powerOn();
+  command(Uc::displayRefresh);
+  waitBusy(_model.fullMs);
+}
+
+// The runs of changed rows of the rendered frame, each with its own byte
+// columns, merged into windows the way drawDiagnostics() merges its boxes.
+DirtyRegion Replay::changedWindows() const
+{
+  DirtyRegion dirty;
+  if (!_shown.valid()) return dirty;
+  const uint16_t lastByte = Panel::rowBytes - 1;
+  uint16_t y = 0;
+  while (y < Panel::height)
+  {
+    const RowBand rest = _shown.diff(_frame.black(), _frame.red(), Raster::STRIDE,
+                                     RowBand{y, Panel::height - 1, 0, lastByte});
+    if (rest.empty()) break;
+    uint16_t y1 = rest.y0;
+    while (y1 < rest.y1 && !_shown.diff(_frame.black(), _frame.red(), Raster::STRIDE,
+                                        RowBand{static_cast<uint16_t>(y1 + 1), static_cast<uint16_t>(y1 + 1), 0,
+                                                lastByte})
+                               .empty())
+    {
+      ++y1;
+    }
+    const RowBand run =
+      _shown.diff(_frame.black(), _frame.red(), Raster::STRIDE, RowBand{rest.y0, y1, 0, lastByte});
+    dirty.add(DirtyRect{static_cast<int16_t>(run.xb0 * 8), static_cast<int16_t>(run.y0),
+                        static_cast<int16_t>(run.xb1 * 8 + 7), static_cast<int16_t>(run.y1)});
+    y = y1 + 1;
+  }
+  dirty.reduce(Panel::fastPartialRefresh ? PARTIAL_MAX_WINDOWS : 1);
+  return dirty;
+}
+
+// drawDiagnostics(): what changed since the last push decides between no
+// refresh, a partial window and the full frame behind the hash skip.
+void Replay::redraw(bool allowPartial, bool force)
+{
+  const uint8_t r = state.rotation & 3;
+  DiagView view;
+  view.offsetX = state.offsetX;
+  view.offsetY = state.offsetY;
+  view.rotation = state.rotation;
+  view.baseX = state.baseX[r];
+  view.baseY = state.baseY[r];
+  _diag.draw(_frame, view);
+  const bool known = _shown.valid();
+  const DirtyRegion dirty = changedWindows();
+  if (allowPartial && known && dirty.empty())
+  {
+    _row->addNote("no change");
+    return;
+  }
+  if (allowPartial && known && dirty.area() * 100 <= static_cast<int32_t>(Panel::width) * Panel::height * PARTIAL_MAX_AREA_PCT)
+  {
+    for (uint8_t i = 0; i < dirty.count; ++i)
+    {
+      const DirtyRect &r = dirty.rects[i];
+      const RowBand band{static_cast<uint16_t>(r.y0), static_cast<uint16_t>(r.y1), static_cast<uint16_t>(r.x0 / 8),
+                         static_cast<uint16_t>(r.x1 / 8)};
+      writeImage(static_cast<size_t>(band.bytes()) * band.rows());
+      if (Panel::fastPartialRefresh)
+      {
+        powerOn();
+        command(Uc::partialIn);
+        partialRamArea();
+        command(Uc::displayRefresh);
+        waitBusy(_model.partialMs);
+        command(Uc::partialOut);
+      }
+      else
+      {
+        asyncRefresh();
+      }
+      _row->partial = true;
+      _shown.commit(_frame.black(), _frame.red(), Raster::STRIDE, band);
+      char note[48];
+      snprintf(note, sizeof(note), "partial window %dx%d", r.width(), r.height());
+      _row->addNote(note);
+    }
+    return;
+  }
+  if (!force && _hashValid && known && dirty.empty())
+  {
+    _row->addNote("frame unchanged");
+    return;
+  }
+  writeImage(Panel::planeBytes);
+  asyncRefresh();
+  _shown.reset(_frame.black(), _frame.red(), Raster::STRIDE);
+  _hashValid = true;
+}
+
+void Replay::flushRedraw()
+{
+  if (!_redrawPending) return;
+  std::string text = _fullPending ? "redraw (full" : "redraw (state";
+  if (_forcePending) text += ", forced";
+  text += ")";
+  beginRow(0, text);
+  if (_coalesced.size() > 1)
+  {
+    char note[48];
+    snprintf(note, sizeof(note), "%zu commands coalesced", _coalesced.size());
+    _row->addNote(note);
+  }
+  const bool full = _fullPending;
+  const bool force = _forcePending;
+  _redrawPending = false;
+  _fullPending = false;
+  _forcePending = false;
+  _coalesced.clear();
+  redraw(!full, force);
+}
+
+static void commandNone(Replay &, size_t, char **)
+{
+}
+
+static void commandRedraw(Replay &replay, size_t argc, char **argv)
+{
+  replay.requestRedraw(true, argc == 1 && strcasecmp(argv[0], "force") == 0);
+}
+
+static void commandOffsets(Replay &replay, size_t, char **argv)
+{
+  int16_t x = 0;
+  int16_t y = 0;
+  if (!parseOffset(argv[0], x) || !parseOffset(argv[1], y))
+  {
+    replay.note("rejected");
+    return;
+  }
+  replay.state.offsetX = x;
+  replay.state.offsetY = y;
+  replay.requestRedraw(false, false);
+}
+
+static void commandResetOffsets(Replay &replay, size_t, char **)
+{
+  replay.state.offsetX = 0;
+  replay.state.offsetY = 0;
+  replay.requestRedraw(false, false);
+}
+
+static void commandRotation(Replay &replay, size_t, char **argv)
+{
+  if (!parseRotationValue(argv[0], replay.state.rotation))
+  {
+    replay.note("rejected");
+    return;
+  }
+  replay.requestRedraw(false, false);
+}
+
+static void commandBase(Replay &replay, size_t, char **argv)
+{
+  uint8_t rot = 0;
+  int16_t x = 0;
+  int16_t y = 0;
+  if (!parseRotationValue(argv[0], rot) || !parseOffset(argv[1], x) || !parseOffset(argv[2], y))
+  {
+    replay.note("rejected");
+    return;
+  }
+  replay.state.baseX[rot] = x;
+  replay.state.baseY[rot] = y;
+  replay.requestRedraw(false, false);
+}
+
+static void commandResetBase(Replay &replay, size_t, char **)
+{
+  memset(replay.state.baseX, 0, sizeof(replay.state.baseX));
+  memset(replay.state.baseY, 0, sizeof(replay.state.baseY));
+  replay.requestRedraw(false, false);
+}
+
+static void commandRaw(Replay &replay, size_t argc, char **)
+{
+  replay.rawCommand();
+  replay.rawData(argc - 1);
+}
+
+// gate/hs send every data byte through rawWriteDataByte: one CS window each
+static void commandGate(Replay &replay, size_t, char **)
+{
+  replay.rawCommand();
+  for (int i = 0; i < 4; ++i) replay.rawData(1);
+}
+
+static void commandHScan(Replay &replay, size_t, char **)
+{
+  replay.rawCommand();
+  for (int i = 0; i < 2; ++i) replay.rawData(1);
+}
+
+static void commandDiag(Replay &replay, size_t, char **)
+{
+  replay.diagBlock();
+}
+
+static void commandWash(Replay &replay, size_t, char **)
+{
+  replay.clearScreen();
+  replay.delay(300);
+  replay.clearScreen();
+  replay.delay(300);
+  replay.redraw(false, true);
+}
+
+static void commandClear(Replay &replay, size_t, char **)
+{
+  replay.clearScreen();
+  replay.redraw(false, true);
+}
+
+static void commandContrast(Replay &replay, size_t, char **)
+{
+  replay.clearScreen();
+  replay.delay(200);
+  replay.clearScreen();
+  replay.delay(200);
+  replay.clearScreen();
+  replay.redraw(false, true);
+}
+
+static void commandBinary(Replay &replay, size_t, char **)
+{
+  replay.note("binary frames not modelled");
+}
+
+// Handlers of the firmware's console table, acting on the replay.
+struct CostCommands
+{
+  using Fn = void (*)(Replay &replay, size_t argc, char **argv);
+
+  static constexpr Fn base = commandBase;
+  static constexpr Fn binary = commandBinary;
+  static constexpr Fn clear = commandClear;
+  static constexpr Fn contrast = commandContrast;
+  static constexpr Fn redraw = commandRedraw;
+  static constexpr Fn diag = commandDiag;
+  static constexpr Fn gate = commandGate;
+  static constexpr Fn help = commandNone;
+  static constexpr Fn hscan = commandHScan;
+  static constexpr Fn offsets = commandOffsets;
+  static constexpr Fn resetOffsets = commandResetOffsets;
+  static constexpr Fn raw = commandRaw;
+  static constexpr Fn resetBase = commandResetBase;
+  static constexpr Fn rotation = commandRotation;
+  static constexpr Fn status = commandNone;
+  static constexpr Fn wash = commandWash;
+};
+
+using Command = ConsoleCommands<CostCommands>::Spec;
+static constexpr const auto &COMMANDS = ConsoleCommands<CostCommands>::table;
+static_assert(commandTableSorted(COMMANDS), "COMMANDS must be sorted by name");
+
+// State and redraw commands only set flags; barriers flush the pending
+// redraw first, as runCommandQueue() does, whatever their arguments.
+void Replay::feedLine(unsigned number, const char *text)
+{
+  char line[SERIAL_LINE_MAX];
+  strncpy(line, text, SERIAL_LINE_MAX - 1);
+  line[SERIAL_LINE_MAX - 1] = '\0';
+  _current = line;
+  char *argv[COMMAND_ARGS_MAX + 1];
+  const size_t count = splitArgs(line, argv, COMMAND_ARGS_MAX + 1);
+  if (count == 0) return;
+
+  const Command *command = findCommand(COMMANDS, argv[0], strlen(argv[0]));
+  const size_t argc = count - 1;
+  const bool valid = command != nullptr && argc >= command->minArgs && argc <= command->maxArgs;
+  const CommandKind kind = command != nullptr ? command->kind : CommandKind::Info;
+  if (kind == CommandKind::Barrier || kind == CommandKind::Stream) flushRedraw();
+
+  beginRow(number, _current);
+  if (!valid)
+  {
+    _row->addNote(command == nullptr ? "unknown command" : "usage error");
+    return;
+  }
+  if (kind == CommandKind::State || kind == CommandKind::Redraw) _row->addNote("queued");
+  command->run(*this, argc, argv + 1);
+}
+
+void Replay::finish()
+{
+  flushRedraw();
+  if (_engineIdleAt > _nowMs)
+  {
+    beginRow(0, "(last refresh)");
+    finishRefresh();
+  }
+}
+
+void Replay::print() const
+{
+  printf("line  %-26s %5s %6s %9s %9s %9s %8s %9s %9s  %s\n", "command", "tx", "bytes", "spi ms", "wait ms",
+         "busy ms", "delay ms", "total ms", "async ms", "note");
+  Row sum;
+  for (const Row &row : _rows)
+  {
+    char line[12] = "";
+    if (row.line > 0) snprintf(line, sizeof(line), "%4u", row.line);
+    printf("%4s  %-26.26s %5u %6u %9.2f %9.1f %9.1f %8.1f %9.1f %9.1f  %s\n", line, row.text.c_str(),
+           row.transactions, row.bytes, row.spiMs, row.waitMs, row.busyMs, row.delayMs, row.totalMs(), row.asyncMs,
+           row.note.c_str());
+    sum.transactions += row.transactions;
+    sum.bytes += row.bytes;
+    sum.spiMs += row.spiMs;
+    sum.waitMs += row.waitMs;
+    sum.busyMs += row.busyMs;
+    sum.delayMs += row.delayMs;
+    sum.asyncMs += row.asyncMs;
+  }
+  const double wall = _nowMs > 0 ? _nowMs : 1;
+  printf("%4s  %-26s %5u %6u %9.2f %9.1f %9.1f %8.1f %9.1f %9.1f\n", "", "total", sum.transactions, sum.bytes,
+         sum.spiMs, sum.waitMs, sum.busyMs, sum.delayMs, sum.totalMs(), sum.asyncMs);
+  printf("[COST] wall %.1f ms: spi %.1f%%, waiting on async refresh %.1f%%, blocking BUSY %.1f%%, delay %.1f%%, "
+         "idle %.1f%%\n",
+         _nowMs, 100 * sum.spiMs / wall, 100 * sum.waitMs / wall, 100 * sum.busyMs / wall, 100 * sum.delayMs / wall,
+         100 * _idleMs / wall);
+}
+
+// writeImage() of both planes and asyncRefresh() from power-off, the
+// refresh timed by RefreshEngine on a BUSY line of its own.
+double Replay::fullPushMs() const
+{
+  FakeBusyLine busy;
+  busy.setBusyFor(Uc::powerOn, _model.powerOnMs);
+  busy.setBusyFor(Uc::displayRefresh, _model.fullMs);
+  busy.setBusyFor(Uc::powerOff, _model.powerOffMs);
+  RefreshEngine engine{RefreshEngine::UC8151_DEADLINES};
+  engine.start(busy, true);
+  do
+  {
+    busy.advance(1);
+  }
+  while (engine.poll(busy) == RefreshEvent::None);
+  const size_t transactions = 14 + 3;
+  const size_t bytes = transactions - 2 + 2 * Panel::planeBytes;
+  return transactions * _model.csUs / 1000.0 + bytes * 8.0 * 1000.0 / _model.spiHz + engine.lastDurationMs();
+}
+
+bool Replay::checkBudget() const
+{
+  const double budget = fullPushMs();
+  bool ok = true;
+  for (const Row &row : _rows)
+  {
+    if (!row.partial || row.stepMs() <= budget) continue;
+    printf("[FAIL] %s: partial step %.1f ms, full frame push %.1f ms\n", row.text.c_str(), row.stepMs(), budget);
+    ok = false;
+  }
+  return ok;
+}
+
+static bool parseBusy(const char *spec, CostModel &model)
+{
+  const char *eq = strchr(spec, '=');
+  long ms = 0;
+  if (eq == nullptr || !parseNumber(eq + 1, ms, 10) || ms < 0) return false;
+  const std::string kind(spec, eq);
+  if (kind == "power-on") model.powerOnMs = static_cast<uint32_t>(ms);
+  else if (kind == "power-off") model.powerOffMs = static_cast<uint32_t>(ms);
+  else if (kind == "full") model.fullMs = static_cast<uint32_t>(ms);
+  else if (kind == "partial") model.partialMs = static_cast<uint32_t>(ms);
+  else if (kind == "ssd") model.ssdMs = static_cast<uint32_t>(ms);
+  else return false;
+  return true;
+}
+
+static void usage()
+{
+  fprintf(stderr,
+          "usage: epd_cost [--spi-hz N] [--cs-us X] [--busy power-on|power-off|full|partial|ssd=MS]..\n"
+          "                [--timeout MS] [SESSION]\n");
+}
+
+int main(int argc, char **argv)
+{
+  CostModel model;
+  const char *path = nullptr;
+  for (int i = 1; i < argc; i++)
+  {
+    const std::string arg = argv[i];
+    long value = 0;
+    if (arg == "--spi-hz" && i + 1 < argc && parseNumber(argv[i + 1], value, 10) && value > 0)
+    {
+      model.spiHz = static_cast<uint32_t>(value);
+      ++i;
+    }
+    else if (arg == "--cs-us" && i + 1 < argc)
+    {
+      model.csUs = atof(argv[++i]);
+    }
+    else if (arg == "--busy" && i + 1 < argc && parseBusy(argv[i + 1], model))
+    {
+      ++i;
+    }
+    else if (arg == "--timeout" && i + 1 < argc && parseNumber(argv[i + 1], value, 10) && value > 0)
+    {
+      model.timeoutMs = static_cast<uint32_t>(value);
+      ++i;
+    }
+    else if (arg[0] != '-' && path == nullptr)
+    {
+      path = argv[i];
+    }
+    else
+    {
+      usage();
+      return 2;
+    }
+  }
+
+  FILE *in = path != nullptr ? fopen(path, "r") : stdin;
+  if (in == nullptr)
+  {
+    perror(path);
+    return 1;
+  }
+  printf("[COST] spi %u Hz, cs %.1f us, busy power-on %u / full %u / partial %u / ssd %u / power-off %u ms, "
+         "refresh deadline %u ms, blocking timeout %u ms\n",
+         model.spiHz, model.csUs, model.powerOnMs, model.fullMs, model.partialMs, model.ssdMs, model.powerOffMs,
+         RefreshEngine::UC8151_DEADLINES.refreshMs, model.timeoutMs);
+
+  Replay replay(model);
+  char text[256];
+  unsigned number = 0;
+  while (fgets(text, sizeof(text), in))
+  {
+    ++number;
+    size_t length = strlen(text);
+    while (length > 0 && (text[length - 1] == '\n' || text[length - 1] == '\r')) text[--length] = '\0';
+    size_t wordLength = 0;
+    const char *word = commandWord(text, wordLength);
+    if (wordLength == 0)
+    {
+      replay.pause();
+      continue;
+    }
+    if (word[0] == '[') continue;
+    if (word[0] == '#')
+    {
+      long ms = 0;
+      if (sscanf(word, "# wait %ld", &ms) == 1 && ms > 0) replay.idle(static_cast<uint32_t>(ms));
+      continue;
+    }
+    replay.feedLine(number, word);
+  }
+  if (in != stdin) fclose(in);
+  replay.finish();
+  replay.print();
+  return replay.checkBudget() ? 0 : 1;
+}
@@ -0,0 +1,254 @@
+// Host test for the frame diff of include/frame_diff.h: pushes a sequence
+// of frames to two copies of the tools/epd_sim.c controller model, one in
+// full and one as only the band FrameShadow::diff() finds, and checks both
+// end up with the same RAM.
+//
+// Build (Linux/macOS):
+//   cc -std=c99 -O2 -c tools/epd_sim.c -o epd_sim.o
+//   c++ -std=c++17 -O2 -Iinclude -Itools tools/epd_diff.cpp epd_sim.o -o epd_diff
+//
+// Usage:
+//   epd_diff [--seed N] [--spi-hz HZ] [--cs-us US]
+//
+// Runs on the 2.13" UC8151 panel the firmware drives (the 0x90 partial
+// window) and on the 2.13" SSD1680 one (the 0x44/0x45 RAM window, 122
+// pixels wide, so the last byte of a row is partly padding). The base frame
+// is random; the steps after it change a status label, a counter, red
+// pixels only, the last column and the last row, nothing at all, and
+// finally the whole frame. After each step both models must match each
+// other and the frame pixel for pixel. SPI time is modelled as in epd_cost:
+// bytes * 8 / HZ plus US per CS window, one window per command and per row
+// or parameter block. Exits non-zero on any mismatch.
+
+#include "epd_sim.h"
+#include "frame_diff.h"
+#include "panel_traits.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+struct BusModel
+{
+  uint32_t spiHz = 4000000;
+  double csUs = 5.0;
+};
+
+// Bus of frame_diff.h onto the controller model, counting what it sends.
+struct SimBus
+{
+  epd_sim_t *sim;
+  size_t bytes = 0;
+  size_t windows = 0;
+
+  void command(uint8_t cmd)
+  {
+    epd_sim_command(sim, cmd);
+    ++bytes;
+    ++windows;
+  }
+
+  void data(const uint8_t *p, size_t count)
+  {
+    epd_sim_data(sim, p, count);
+    bytes += count;
+    ++windows;
+  }
+
+  double us(const BusModel &model) const
+  {
+    return bytes * 8.0 * 1e6 / model.spiHz + windows * model.csUs;
+  }
+};
+
+// Both planes of a frame in the controller's encoding, rows word aligned
+// as PlaneRaster keeps them. Pixels are set through paint(), so padding
+// bits past the width stay as they are.
+template <typename PanelT>
+class Frame
+{
+public:
+  static constexpr uint16_t STRIDE = FrameShadow<PanelT>::STRIDE;
+  static constexpr bool SSD = PanelT::Controller::family == ControllerFamily::Ssd16xx;
+
+  Frame() : _black(STRIDE / 4 * PanelT::height, 0xFFFFFFFFu), _red(STRIDE / 4 * PanelT::height, SSD ? 0 : 0xFFFFFFFFu)
+  {
+  }
+
+  const uint8_t *black() const
+  {
+    return reinterpret_cast<const uint8_t *>(_black.data());
+  }
+
+  const uint8_t *red() const
+  {
+    return reinterpret_cast<const uint8_t *>(_red.data());
+  }
+
+  void paint(uint16_t x, uint16_t y, epd_sim_pixel_t p)
+  {
+    if (x >= PanelT::width || y >= PanelT::height) return;
+    const size_t i = static_cast<size_t>(y) * STRIDE + x / 8;
+    const uint8_t bit = 0x80 >> (x & 7);
+    uint8_t *b = reinterpret_cast<uint8_t *>(_black.data());
+    uint8_t *r = reinterpret_cast<uint8_t *>(_red.data());
+    b[i] = p == EPD_SIM_BLACK ? b[i] & ~bit : b[i] | bit;
+    const bool red = p == EPD_SIM_RED;
+    r[i] = red == SSD ? r[i] | bit : r[i] & ~bit;
+  }
+
+  void rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, epd_sim_pixel_t p)
+  {
+    for (uint16_t j = 0; j < h; ++j)
+    {
+      for (uint16_t i = 0; i < w; ++i) paint(x + i, y + j, p);
+    }
+  }
+
+  // A few pixels of noise per glyph cell, like text.
+  void label(uint16_t x, uint16_t y, uint16_t chars, uint32_t &seed, epd_sim_pixel_t ink)
+  {
+    rect(x, y, chars * 6, 8, EPD_SIM_WHITE);
+    for (uint16_t c = 0; c < chars; ++c)
+    {
+      for (uint16_t j = 0; j < 7; ++j)
+      {
+        for (uint16_t i = 0; i < 5; ++i)
+        {
+          if (next(seed) & 1) paint(x + c * 6 + i, y + j, ink);
+        }
+      }
+    }
+  }
+
+  void noise(uint32_t &seed)
+  {
+    static const epd_sim_pixel_t inks[4] = {EPD_SIM_WHITE, EPD_SIM_WHITE, EPD_SIM_BLACK, EPD_SIM_RED};
+    for (uint16_t y = 0; y < PanelT::height; ++y)
+    {
+      for (uint16_t x = 0; x < PanelT::width; ++x) paint(x, y, inks[next(seed) & 3]);
+    }
+  }
+
+  epd_sim_pixel_t at(uint16_t x, uint16_t y) const
+  {
+    const size_t i = static_cast<size_t>(y) * STRIDE + x / 8;
+    const uint8_t bit = 0x80 >> (x & 7);
+    if (((red()[i] & bit) != 0) == SSD) return EPD_SIM_RED;
+    return (black()[i] & bit) ? EPD_SIM_WHITE : EPD_SIM_BLACK;
+  }
+
+  static uint32_t next(uint32_t &seed)
+  {
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 16;
+  }
+
+private:
+  std::vector<uint32_t> _black;
+  std::vector<uint32_t> _red;
+};
+
+template <typename PanelT>
+static bool sameRam(const epd_sim_t *a, const epd_sim_t *b, const Frame<PanelT> &frame)
+{
+  for (uint16_t y = 0; y < PanelT::height; ++y)
+  {
+    for (uint16_t x = 0; x < PanelT::width; ++x)
+    {
+      const epd_sim_pixel_t want = frame.at(x, y);
+      if (epd_sim_pixel(a, x, y) != want || epd_sim_pixel(b, x, y) != want) return false;
+    }
+  }
+  return true;
+}
+
+template <typename PanelT>
+static bool run(const char *name, epd_sim_model_t model, const BusModel &bus, uint32_t seed)
+{
+  using Controller = typename PanelT::Controller;
+  using Shadow = FrameShadow<PanelT>;
+  static Shadow shadow;
+  Frame<PanelT> frame;
+  SimBus full{epd_sim_create(model, PanelT::width, PanelT::height)};
+  SimBus diff{epd_sim_create(model, PanelT::width, PanelT::height)};
+  const uint16_t W = PanelT::width;
+  const uint16_t H = PanelT::height;
+
+  printf("%s, %ux%u, planes 2 x %zu B\n", name, W, H, PanelT::planeBytes);
+  bool allOk = true;
+  shadow.invalidate();
+  for (int step = 0; step < 9; ++step)
+  {
+    const char *what = "";
+    switch (step)
+    {
+      case 0: what = "base frame"; frame.noise(seed); break;
+      case 1: what = "status label"; frame.label(10, 20, 8, seed, EPD_SIM_BLACK); break;
+      case 2: what = "counter digit"; frame.label(40, H / 2, 1, seed, EPD_SIM_BLACK); break;
+      case 3: what = "red label"; frame.label(W / 2, 6, 3, seed, EPD_SIM_RED); break;
+      case 4: what = "last column"; frame.rect(W - 1, H / 3, 1, 5, EPD_SIM_BLACK); break;
+      case 5: what = "last row"; frame.rect(W / 3, H - 1, 9, 1, EPD_SIM_RED); break;
+      case 6: what = "no change"; break;
+      case 7: what = "two labels"; frame.label(2, 2, 4, seed, EPD_SIM_BLACK); frame.label(W - 30, H - 10, 4, seed, EPD_SIM_RED); break;
+      default: what = "new frame"; frame.noise(seed); break;
+    }
+    const size_t fullBytes = full.bytes;
+    const size_t fullWindows = full.windows;
+    sendBand(full, Controller(), Shadow::all(), frame.black(), frame.red(), Shadow::STRIDE);
+    SimBus fullStep{nullptr, full.bytes - fullBytes, full.windows - fullWindows};
+
+    const size_t diffBytes = diff.bytes;
+    const size_t diffWindows = diff.windows;
+    const RowBand band = shadow.diff(frame.black(), frame.red(), Shadow::STRIDE);
+    sendBand(diff, Controller(), band, frame.black(), frame.red(), Shadow::STRIDE);
+    if (shadow.valid()) shadow.commit(frame.black(), frame.red(), Shadow::STRIDE, band);
+    else shadow.reset(frame.black(), frame.red(), Shadow::STRIDE);
+    SimBus diffStep{nullptr, diff.bytes - diffBytes, diff.windows - diffWindows};
+
+    const bool ok = sameRam(full.sim, diff.sim, frame);
+    allOk = allOk && ok;
+    char rows[32] = "-";
+    if (!band.empty()) snprintf(rows, sizeof(rows), "%u-%u x %u-%u", band.y0, band.y1, band.xb0, band.xb1);
+    printf("  %-14s band %-16s  diff %5zu B %8.1f us  full %5zu B %8.1f us  %s\n", what, rows, diffStep.bytes,
+           diffStep.us(bus), fullStep.bytes, fullStep.us(bus), ok ? "identical" : "MISMATCH");
+  }
+  epd_sim_destroy(full.sim);
+  epd_sim_destroy(diff.sim);
+  return allOk;
+}
+
+int main(int argc, char **argv)
+{
+  BusModel bus;
+  uint32_t seed = 1;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (arg == "--seed" && i + 1 < argc)
+    {
+      seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+    }
+    else if (arg == "--spi-hz" && i + 1 < argc)
+    {
+      bus.spiHz = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+    }
+    else if (arg == "--cs-us" && i + 1 < argc)
+    {
+      bus.csUs = atof(argv[++i]);
+    }
+    else
+    {
+      fprintf(stderr, "usage: epd_diff [--seed N] [--spi-hz HZ] [--cs-us US]\n");
+      return 2;
+    }
+  }
+  if (bus.spiHz == 0) bus.spiHz = 1;
+
+  printf("SPI %u Hz, %.1f us per CS window, seed %u\n", bus.spiHz, bus.csUs, seed);
+  bool allOk = true;
+  allOk = run<Panel213c>("GxEPD2_213c (UC8151)", EPD_SIM_UC8151_3C, bus, seed) && allOk;
+  allOk = run<Panel213Ssd>("2.13\" SSD1680", EPD_SIM_SSD16XX_3C, bus, seed) && allOk;
+  return allOk ? 0 : 1;
+}
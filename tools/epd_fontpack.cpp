@@ -0,0 +1,351 @@
+// Host converter from GFXfont headers to the packed glyph format of
+// include/glyph_codec.h.
+//
+// Build (Linux/macOS):
+//   c++ -std=c++17 -O2 -Iinclude tools/epd_fontpack.cpp -o epd_fontpack
+//
+// Usage:
+//   epd_fontpack [--name NAME] IN.h OUT.h
+//
+// IN.h is a GFXfont header (fontconvert output, or a subset font with its
+// 'subset' string). OUT.h defines NAMEBitmaps[], NAMEGlyphs[] and the
+// PackedFont NAME, by default the font's name with 'Packed' appended;
+// subset fonts also get NAMEChars and a constexpr SubsetIndex NAMEIndex.
+// Every glyph is decoded back with RunDecoder before anything is written;
+// exits non-zero when one differs.
+
+#include "glyph_codec.h"
+#include "gfxfont_source.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+struct Code
+{
+  uint16_t bits[RUN_SYMBOLS];
+  uint8_t length[RUN_SYMBOLS];  // 0: symbol unused
+  RunCode table;
+};
+
+// Huffman code lengths for 'counts', at most RUN_CODE_BITS long; counts
+// are halved until the tree is shallow enough.
+static void codeLengths(std::vector<uint32_t> counts, uint8_t *length)
+{
+  for (;;)
+  {
+    std::vector<std::vector<uint8_t>> members;
+    std::vector<uint32_t> weight;
+    memset(length, 0, RUN_SYMBOLS);
+    for (uint8_t s = 0; s < RUN_SYMBOLS; ++s)
+    {
+      if (counts[s] == 0) continue;
+      members.push_back({s});
+      weight.push_back(counts[s]);
+    }
+    if (members.empty()) return;
+    if (members.size() == 1)
+    {
+      length[members[0][0]] = 1;
+      return;
+    }
+    while (members.size() > 1)
+    {
+      // merge the two lightest; ties go to the earlier node
+      size_t a = 0, b = 1;
+      if (weight[b] < weight[a]) std::swap(a, b);
+      for (size_t i = 2; i < members.size(); ++i)
+      {
+        if (weight[i] < weight[a])
+        {
+          b = a;
+          a = i;
+        }
+        else if (weight[i] < weight[b])
+        {
+          b = i;
+        }
+      }
+      for (uint8_t s : members[a]) ++length[s];
+      for (uint8_t s : members[b]) ++length[s];
+      members[a].insert(members[a].end(), members[b].begin(), members[b].end());
+      weight[a] += weight[b];
+      members.erase(members.begin() + b);
+      weight.erase(weight.begin() + b);
+    }
+    if (*std::max_element(length, length + RUN_SYMBOLS) <= RUN_CODE_BITS) return;
+    for (uint32_t &c : counts)
+    {
+      if (c > 0) c = (c + 1) / 2;
+    }
+  }
+}
+
+// Canonical code for the lengths: shorter codes first, equal lengths in
+// symbol order, as RunDecoder::symbol() expects.
+static Code canonicalCode(const std::vector<uint32_t> &counts)
+{
+  Code code{};
+  codeLengths(counts, code.length);
+  uint16_t next = 0;
+  uint8_t index = 0;
+  for (uint8_t len = 1; len <= RUN_CODE_BITS; ++len)
+  {
+    for (uint8_t s = 0; s < RUN_SYMBOLS; ++s)
+    {
+      if (code.length[s] != len) continue;
+      code.bits[s] = next++;
+      ++code.table.counts[len];
+      code.table.symbols[index++] = s;
+    }
+    next <<= 1;
+  }
+  return code;
+}
+
+struct Run
+{
+  bool black;
+  uint32_t length;
+};
+
+// Runs as the stream holds them: alternating from white, the first white
+// run possibly empty, a trailing white run replaced by an empty one (the
+// end mark) and a glyph with no ink as one white run.
+static std::vector<Run> glyphRuns(const std::vector<bool> &pixels)
+{
+  std::vector<Run> runs;
+  bool black = false;
+  uint32_t length = 0;
+  for (bool p : pixels)
+  {
+    if (p != black)
+    {
+      runs.push_back(Run{black, length});
+      black = p;
+      length = 0;
+    }
+    ++length;
+  }
+  if (black || runs.empty()) runs.push_back(Run{black, length});
+  else if (length > 0) runs.push_back(Run{false, 0});
+  return runs;
+}
+
+// Symbols of one run: RUN_ESCAPE per whole RUN_ESCAPE, then the rest.
+template <typename Emit>
+static void runSymbols(uint32_t length, Emit emit)
+{
+  for (; length >= RUN_ESCAPE; length -= RUN_ESCAPE) emit(RUN_ESCAPE);
+  emit(static_cast<uint8_t>(length));
+}
+
+class BitWriter
+{
+public:
+  void put(uint16_t bits, uint8_t count)
+  {
+    for (int8_t i = count - 1; i >= 0; --i)
+    {
+      if (_used == 0) _out.push_back(0);
+      if ((bits >> i) & 1) _out.back() |= 0x80 >> _used;
+      _used = (_used + 1) & 7;
+    }
+  }
+
+  void align()
+  {
+    _used = 0;
+  }
+
+  std::vector<uint8_t> &bytes()
+  {
+    return _out;
+  }
+
+private:
+  std::vector<uint8_t> _out;
+  uint8_t _used = 0;
+};
+
+struct Packed
+{
+  std::vector<uint8_t> bitmap;
+  std::vector<PackedGlyph> glyphs;
+  Code white;
+  Code black;
+};
+
+static bool pack(const GfxFontSource &font, Packed &out, std::string &error)
+{
+  std::vector<std::vector<Run>> runs;
+  std::vector<uint32_t> whiteCounts(RUN_SYMBOLS), blackCounts(RUN_SYMBOLS);
+  for (size_t i = 0; i < font.glyphs.size(); ++i)
+  {
+    runs.push_back(glyphRuns(font.pixels(i)));
+    for (const Run &r : runs.back())
+    {
+      std::vector<uint32_t> &counts = r.black ? blackCounts : whiteCounts;
+      runSymbols(r.length, [&](uint8_t s) { ++counts[s]; });
+    }
+  }
+  out.white = canonicalCode(whiteCounts);
+  out.black = canonicalCode(blackCounts);
+
+  BitWriter writer;
+  for (size_t i = 0; i < font.glyphs.size(); ++i)
+  {
+    const GfxGlyphSource &g = font.glyphs[i];
+    writer.align();
+    const size_t offset = writer.bytes().size();
+    if (offset > 0xFFFF)
+    {
+      error = font.name + ": packed bitmap exceeds 64 KiB";
+      return false;
+    }
+    out.glyphs.push_back(PackedGlyph{static_cast<uint16_t>(offset), g.width, g.height, g.xAdvance, g.xOffset,
+                                     g.yOffset});
+    for (const Run &r : runs[i])
+    {
+      const Code &code = r.black ? out.black : out.white;
+      runSymbols(r.length, [&](uint8_t s) { writer.put(code.bits[s], code.length[s]); });
+    }
+  }
+  out.bitmap = writer.bytes();
+  return true;
+}
+
+// Every glyph decoded back must be the source glyph.
+static bool verify(const GfxFontSource &font, const Packed &packed, std::string &error)
+{
+  const PackedFont pf{packed.bitmap.data(), packed.glyphs.data(), font.first, font.last, font.yAdvance, nullptr,
+                      packed.white.table, packed.black.table};
+  for (size_t i = 0; i < font.glyphs.size(); ++i)
+  {
+    const std::vector<bool> pixels = font.pixels(i);
+    RunDecoder runs(pf, packed.glyphs[i]);
+    for (size_t p = 0; p < pixels.size(); ++p)
+    {
+      if (runs.next() != pixels[p])
+      {
+        char buf[96];
+        snprintf(buf, sizeof(buf), "glyph 0x%02X: pixel %zu,%zu decodes wrong", font.character(i),
+                 p % font.glyphs[i].width, p / font.glyphs[i].width);
+        error = font.name + ": " + buf;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static std::string quoted(const std::string &s)
+{
+  std::string out = "\"";
+  for (char c : s)
+  {
+    if (c == '"' || c == '\\') out += '\\';
+    out += c;
+  }
+  return out + "\"";
+}
+
+static std::string charComment(uint8_t c)
+{
+  char buf[16];
+  if (c >= 0x20 && c < 0x7F) snprintf(buf, sizeof(buf), "0x%02X '%c'", c, c);
+  else snprintf(buf, sizeof(buf), "0x%02X", c);
+  return buf;
+}
+
+static void writeCode(FILE *f, const RunCode &code, bool last)
+{
+  fprintf(f, "  { {");
+  for (uint8_t i = 0; i <= RUN_CODE_BITS; ++i) fprintf(f, "%s%u", i ? ", " : " ", code.counts[i]);
+  fprintf(f, " },\n    {");
+  for (uint8_t i = 0; i < RUN_SYMBOLS; ++i) fprintf(f, "%s%u", i ? ", " : " ", code.symbols[i]);
+  fprintf(f, " } }%s\n", last ? " };" : ",");
+}
+
+static size_t codeBytes()
+{
+  return 2 * sizeof(RunCode);
+}
+
+static bool writeHeader(const char *path, const char *source, const std::string &name, const GfxFontSource &font,
+                        const Packed &packed)
+{
+  FILE *f = fopen(path, "w");
+  if (!f) return false;
+  const char *base = strrchr(source, '/');
+  base = base ? base + 1 : source;
+  fprintf(f, "// %s packed by tools/epd_fontpack.cpp (include/glyph_codec.h); regenerate, don't edit.\n", base);
+  fprintf(f, "// %zu bitmap bytes as %zu bytes of runs and %zu of codes.\n", font.bitmap.size(),
+          packed.bitmap.size(), codeBytes());
+  fprintf(f, "\n#pragma once\n\n#include \"glyph_codec.h\"\n");
+  if (font.hasSubset)
+  {
+    fprintf(f, "#include \"font_index.h\"\n\n#define %sChars %s\n", name.c_str(), quoted(font.subset).c_str());
+  }
+  fprintf(f, "\nconst uint8_t %sBitmaps[] = {", name.c_str());
+  for (size_t i = 0; i < packed.bitmap.size(); ++i)
+  {
+    fprintf(f, "%s0x%02X%s", i % 12 == 0 ? "\n  " : " ", packed.bitmap[i], i + 1 < packed.bitmap.size() ? "," : "");
+  }
+  fprintf(f, " };\n\nconst PackedGlyph %sGlyphs[] = {\n", name.c_str());
+  for (size_t i = 0; i < packed.glyphs.size(); ++i)
+  {
+    const PackedGlyph &g = packed.glyphs[i];
+    const bool last = i + 1 == packed.glyphs.size();
+    fprintf(f, "  { %5u, %3u, %3u, %3u, %4d, %4d }%s   // %s\n", g.bitmapOffset, g.width, g.height, g.xAdvance,
+            g.xOffset, g.yOffset, last ? " };" : ", ", charComment(font.character(i)).c_str());
+  }
+  fprintf(f, "\nconst PackedFont %s = {\n  %sBitmaps,\n  %sGlyphs,\n  0x%02X, 0x%02X, %u,\n  %s%s,\n", name.c_str(),
+          name.c_str(), name.c_str(), font.first, font.last, font.yAdvance, font.hasSubset ? name.c_str() : "nullptr",
+          font.hasSubset ? "Chars" : "");
+  writeCode(f, packed.white.table, false);
+  writeCode(f, packed.black.table, true);
+  if (font.hasSubset)
+  {
+    fprintf(f, "\nconstexpr SubsetIndex %sIndex = subsetIndex(%sChars);\n", name.c_str(), name.c_str());
+  }
+  return fclose(f) == 0;
+}
+
+int main(int argc, char **argv)
+{
+  std::string name;
+  std::vector<const char *> paths;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (std::string(argv[i]) == "--name" && i + 1 < argc) name = argv[++i];
+    else paths.push_back(argv[i]);
+  }
+  if (paths.size() != 2)
+  {
+    fprintf(stderr, "usage: epd_fontpack [--name NAME] IN.h OUT.h\n");
+    return 2;
+  }
+  GfxFontSource font;
+  std::string error;
+  Packed packed;
+  if (!loadGfxFont(paths[0], font, error) || !pack(font, packed, error) || !verify(font, packed, error))
+  {
+    fprintf(stderr, "epd_fontpack: %s\n", error.c_str());
+    return 1;
+  }
+  if (name.empty()) name = font.name + "Packed";
+  if (!writeHeader(paths[1], paths[0], name, font, packed))
+  {
+    fprintf(stderr, "epd_fontpack: cannot write %s\n", paths[1]);
+    return 1;
+  }
+  const size_t raw = font.bitmap.size();
+  const size_t out = packed.bitmap.size() + codeBytes();
+  printf("%s: %zu glyphs, bitmap %zu B -> %zu B runs + %zu B codes = %zu B (%.0f%%)\n", name.c_str(),
+         font.glyphs.size(), raw, packed.bitmap.size(), codeBytes(), out, 100.0 * out / raw);
+  return 0;
+}
@@ -0,0 +1,206 @@
+// Host tool that cuts a subset font (ST7735_TFT.h's GFXfont with a
+// 'subset' string) out of a full GFXfont header.
+//
+// Build (Linux/macOS):
+//   c++ -std=c++17 -O2 -Iinclude tools/epd_fontsubset.cpp -o epd_fontsubset
+//
+// Usage:
+//   epd_fontsubset --chars CHARS [--name NAME] IN.h OUT.h
+//
+// The glyphs come in the order of CHARS, repeats dropped; a character the
+// font lacks is an error. Bitmaps are copied glyph by glyph and offsets
+// recomputed, glyphs with the same pixels share one bitmap. OUT.h has the
+// layout of FreeMonoOblique12pt_sub.h: NAMEChars, NAMEBitmaps[],
+// NAMEGlyphs[], the GFXfont NAME and, for C++, a constexpr SubsetIndex
+// NAMEIndex (include/font_index.h). NAME defaults to the font's name with
+// '_sub' appended. The written header is read back and every glyph
+// compared with the full font; exits non-zero when one differs.
+
+#include "gfxfont_source.h"
+
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+struct Subset
+{
+  std::string chars;
+  std::vector<uint8_t> bitmap;
+  std::vector<GfxGlyphSource> glyphs;
+  size_t shared = 0;  // glyphs pointing at an earlier glyph's bitmap
+};
+
+static bool cut(const GfxFontSource &font, const std::string &wanted, Subset &out, std::string &error)
+{
+  // same size and pixels -> offset of the first such bitmap
+  std::map<std::pair<std::pair<uint8_t, uint8_t>, std::vector<bool>>, uint16_t> seen;
+  for (char ch : wanted)
+  {
+    const uint8_t c = static_cast<uint8_t>(ch);
+    if (out.chars.find(ch) != std::string::npos) continue;
+    const int index = font.glyphOf(c);
+    if (c == 0 || index < 0)
+    {
+      char buf[64];
+      snprintf(buf, sizeof(buf), "%s has no glyph for 0x%02X", font.name.c_str(), c);
+      error = buf;
+      return false;
+    }
+    GfxGlyphSource g = font.glyphs[index];
+    const std::vector<bool> pixels = font.pixels(index);
+    const size_t bytes = (pixels.size() + 7) / 8;
+    if (out.bitmap.size() + bytes > 0xFFFF)
+    {
+      error = "subset bitmap exceeds 64 KiB";
+      return false;
+    }
+    const auto key = std::make_pair(std::make_pair(g.width, g.height), pixels);
+    const auto hit = bytes > 0 ? seen.find(key) : seen.end();
+    if (hit != seen.end())
+    {
+      g.bitmapOffset = hit->second;
+      ++out.shared;
+    }
+    else
+    {
+      const uint16_t offset = static_cast<uint16_t>(out.bitmap.size());
+      out.bitmap.insert(out.bitmap.end(), font.bitmap.begin() + g.bitmapOffset,
+                        font.bitmap.begin() + g.bitmapOffset + bytes);
+      g.bitmapOffset = offset;
+      if (bytes > 0) seen.emplace(key, offset);
+    }
+    out.chars += ch;
+    out.glyphs.push_back(g);
+  }
+  if (out.chars.empty())
+  {
+    error = "empty character set";
+    return false;
+  }
+  return true;
+}
+
+static std::string quoted(const std::string &s)
+{
+  std::string out = "\"";
+  for (char c : s)
+  {
+    if (c == '"' || c == '\\') out += '\\';
+    out += c;
+  }
+  return out + "\"";
+}
+
+// Glyph numbering as the hand-made subsets had it: first 0x01, last - first
+// the glyph count. Lookups go through the subset string, not these.
+static bool writeHeader(const char *path, const std::string &name, const GfxFontSource &font, const Subset &sub)
+{
+  FILE *f = fopen(path, "w");
+  if (!f) return false;
+  fprintf(f, "#define %sChars %s\n\n", name.c_str(), quoted(sub.chars).c_str());
+  fprintf(f, "const uint8_t %sBitmaps[] PROGMEM = {", name.c_str());
+  for (size_t i = 0; i < sub.bitmap.size(); ++i)
+  {
+    fprintf(f, "%s0x%02X%s", i % 12 == 0 ? "\n  " : " ", sub.bitmap[i], i + 1 < sub.bitmap.size() ? "," : "");
+  }
+  fprintf(f, " };\n\nconst GFXglyph %sGlyphs[] PROGMEM = {\n", name.c_str());
+  for (size_t i = 0; i < sub.glyphs.size(); ++i)
+  {
+    const GfxGlyphSource &g = sub.glyphs[i];
+    const uint8_t c = static_cast<uint8_t>(sub.chars[i]);
+    const bool last = i + 1 == sub.glyphs.size();
+    fprintf(f, "  { %5u, %3u, %3u, %3u, %4d, %4d }%s // 0x%02X", g.bitmapOffset, g.width, g.height, g.xAdvance,
+            g.xOffset, g.yOffset, last ? " };" : ",  ", c);
+    if (c >= 0x20 && c < 0x7F) fprintf(f, " '%c'", c);
+    fprintf(f, "\n");
+  }
+  fprintf(f, "\nconst GFXfont %s PROGMEM = {\n", name.c_str());
+  fprintf(f, "  (uint8_t  *)%sBitmaps,\n  (GFXglyph *)%sGlyphs,\n", name.c_str(), name.c_str());
+  fprintf(f, "  0x01, 0x%02zX, %u,\n  %sChars };\n\n", sub.glyphs.size() + 1, font.yAdvance, name.c_str());
+  fprintf(f, "#ifdef __cplusplus\n#include \"font_index.h\"\n");
+  fprintf(f, "constexpr SubsetIndex %sIndex = subsetIndex(%sChars);\n#endif\n\n", name.c_str(), name.c_str());
+  // fontconvert's estimate: bitmaps, 7-byte glyphs, the font; plus the string
+  fprintf(f, "// Approx. %zu bytes\n", sub.bitmap.size() + sub.glyphs.size() * 7 + sub.chars.size() + 1 + 7);
+  return fclose(f) == 0;
+}
+
+// The header as written must give back the full font's glyphs.
+static bool verify(const char *path, const std::string &name, const GfxFontSource &font, std::string &error)
+{
+  GfxFontSource sub;
+  if (!loadGfxFont(path, sub, error)) return false;
+  if (sub.name != name || !sub.hasSubset || sub.yAdvance != font.yAdvance)
+  {
+    error = std::string(path) + ": header does not read back";
+    return false;
+  }
+  for (size_t i = 0; i < sub.glyphs.size(); ++i)
+  {
+    const int from = font.glyphOf(sub.character(i));
+    const GfxGlyphSource &a = sub.glyphs[i];
+    const GfxGlyphSource &b = font.glyphs[from];
+    if (a.width != b.width || a.height != b.height || a.xAdvance != b.xAdvance || a.xOffset != b.xOffset ||
+        a.yOffset != b.yOffset || sub.pixels(i) != font.pixels(from))
+    {
+      char buf[64];
+      snprintf(buf, sizeof(buf), ": glyph 0x%02X differs from the full font", sub.character(i));
+      error = path + std::string(buf);
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char **argv)
+{
+  std::string name, chars;
+  bool haveChars = false;
+  std::vector<const char *> paths;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (arg == "--name" && i + 1 < argc)
+    {
+      name = argv[++i];
+    }
+    else if (arg == "--chars" && i + 1 < argc)
+    {
+      chars = argv[++i];
+      haveChars = true;
+    }
+    else
+    {
+      paths.push_back(argv[i]);
+    }
+  }
+  if (paths.size() != 2 || !haveChars)
+  {
+    fprintf(stderr, "usage: epd_fontsubset --chars CHARS [--name NAME] IN.h OUT.h\n");
+    return 2;
+  }
+  GfxFontSource font;
+  Subset sub;
+  std::string error;
+  if (!loadGfxFont(paths[0], font, error) || !cut(font, chars, sub, error))
+  {
+    fprintf(stderr, "epd_fontsubset: %s\n", error.c_str());
+    return 1;
+  }
+  if (name.empty()) name = font.name + "_sub";
+  if (!writeHeader(paths[1], name, font, sub))
+  {
+    fprintf(stderr, "epd_fontsubset: cannot write %s\n", paths[1]);
+    return 1;
+  }
+  if (!verify(paths[1], name, font, error))
+  {
+    fprintf(stderr, "epd_fontsubset: %s\n", error.c_str());
+    return 1;
+  }
+  printf("%s: %zu of %zu glyphs, %zu sharing a bitmap, bitmap %zu B of %zu B\n", name.c_str(), sub.glyphs.size(),
+         font.glyphs.size(), sub.shared, sub.bitmap.size(), font.bitmap.size());
+  return 0;
+}
@@ -0,0 +1,209 @@
+// Host encoder for the packed plane format in include/row_codec.h.
+//
+// Build (Linux/macOS):
+//   c++ -std=c++17 -O2 -Iinclude -Ilib/pio_ws2812_E-ink/generated -Itools tools/epd_pack.cpp -o epd_pack
+//
+// Usage:
+//   epd_pack --width W IN OUT   raw plane -> packed payload ('b'/'r' frames)
+//   epd_pack --bench            round-trip, ratio and decode speed on the
+//                               test patterns the firmware draws
+//
+// The diagnostics planes are rendered by tools/diag_frame.h into a
+// PlaneRaster, as the firmware draws them, at rest and after 'o 3 -2'.
+// --bench exits non-zero when any pattern fails to decode back bit-exact.
+
+#include "diag_frame.h"
+#include "panel_traits.h"
+#include "row_codec.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+struct Plane
+{
+  const char *name;
+  size_t width;
+  size_t height;
+  std::vector<uint8_t> bytes;  // 1 = white, rows padded to a byte
+
+  size_t rowBytes() const
+  {
+    return (width + 7) / 8;
+  }
+
+  void clearPixel(long x, long y)
+  {
+    if (x < 0 || y < 0 || static_cast<size_t>(x) >= width || static_cast<size_t>(y) >= height) return;
+    bytes[y * rowBytes() + x / 8] &= static_cast<uint8_t>(~(0x80 >> (x % 8)));
+  }
+
+  void fillRect(long x, long y, long w, long h)
+  {
+    for (long j = y; j < y + h; ++j)
+    {
+      for (long i = x; i < x + w; ++i) clearPixel(i, j);
+    }
+  }
+};
+
+static Plane blankPlane(const char *name, size_t width, size_t height)
+{
+  Plane p{name, width, height, {}};
+  p.bytes.assign(p.rowBytes() * height, 0xFF);
+  return p;
+}
+
+static std::vector<uint8_t> encodePlane(const uint8_t *plane, size_t rowBytes, size_t rows)
+{
+  std::vector<uint8_t> out(rowCodecBound(rowBytes, rows));
+  out.resize(rowCodecEncode(plane, rowBytes, rows, out.data()));
+  return out;
+}
+
+// Decodes in USB-packet sized pieces, as the firmware sees the payload.
+static bool decodePlane(const std::vector<uint8_t> &packed, std::vector<uint8_t> &out, size_t piece)
+{
+  RowDecoder decoder;
+  decoder.begin();
+  out.clear();
+  for (size_t pos = 0; pos < packed.size(); pos += piece)
+  {
+    const size_t n = packed.size() - pos < piece ? packed.size() - pos : piece;
+    const bool ok = decoder.feed(packed.data() + pos, n, [&](const uint8_t *row, size_t rowBytes)
+    {
+      out.insert(out.end(), row, row + rowBytes);
+    });
+    if (!ok) return false;
+  }
+  return decoder.finished();
+}
+
+// The black and red planes of the diagnostics frame, physical rows
+static void addDiagnostics(std::vector<Plane> &planes, const DiagView &view)
+{
+  using Raster = PlaneRaster<Panel213c>;
+  static Raster raster;
+  static DiagFrame<Panel213c> frame;
+  frame.draw(raster, view);
+  static char names[2][2][40];
+  const bool moved = view.offsetX != 0 || view.offsetY != 0;
+  const uint8_t *sources[2] = {raster.black(), raster.red()};
+  const char *kinds[2] = {"black", "red"};
+  for (int k = 0; k < 2; ++k)
+  {
+    char *name = names[moved][k];
+    snprintf(name, sizeof(names[0][0]), "diag%s %s %ux%u", moved ? " o" : "", kinds[k], Panel213c::width,
+             Panel213c::height);
+    Plane plane = blankPlane(name, Panel213c::width, Panel213c::height);
+    for (size_t y = 0; y < plane.height; ++y)
+    {
+      memcpy(&plane.bytes[y * plane.rowBytes()], sources[k] + y * Raster::STRIDE, plane.rowBytes());
+    }
+    planes.push_back(plane);
+  }
+}
+
+static std::vector<Plane> benchPlanes()
+{
+  std::vector<Plane> planes;
+
+  // ws2812.c make_test_bands(): top half black on the 112x208 UC8151D panel
+  Plane bands = blankPlane("test_bands 112x208", 112, 208);
+  bands.fillRect(0, 0, 112, 104);
+  planes.push_back(bands);
+
+  // commandDiagBlock 'diag 16 87 50 150' on the 104x212 GxEPD2_213c plane
+  Plane block = blankPlane("diag block 104x212", 104, 212);
+  block.fillRect(16, 50, 72, 101);
+  planes.push_back(block);
+
+  // drawDiagnostics() in rotation 1, both planes as sent to the controller
+  addDiagnostics(planes, DiagView{});
+  DiagView nudged;
+  nudged.offsetX = 3;
+  nudged.offsetY = -2;
+  addDiagnostics(planes, nudged);
+
+  // incompressible worst case
+  Plane noise = blankPlane("random 104x212", 104, 212);
+  uint32_t seed = 12345;
+  for (uint8_t &b : noise.bytes)
+  {
+    seed = seed * 1103515245u + 12345u;
+    b = static_cast<uint8_t>(seed >> 16);
+  }
+  planes.push_back(noise);
+  return planes;
+}
+
+static int runBench()
+{
+  bool allOk = true;
+  for (const Plane &plane : benchPlanes())
+  {
+    const size_t rows = plane.height;
+    const std::vector<uint8_t> packed = encodePlane(plane.bytes.data(), plane.rowBytes(), rows);
+    std::vector<uint8_t> decoded;
+    const bool ok = decodePlane(packed, decoded, 64) && decoded == plane.bytes;
+    allOk = allOk && ok;
+
+    const int iterations = 2000;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) decodePlane(packed, decoded, 64);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%-22s %5zu -> %5zu bytes  ratio %6.2f:1  decode %7.1f MB/s  %s\n", plane.name, plane.bytes.size(),
+           packed.size(), static_cast<double>(plane.bytes.size()) / packed.size(),
+           plane.bytes.size() * iterations / seconds / 1e6, ok ? "round-trip ok" : "ROUND-TRIP FAILED");
+  }
+  return allOk ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc == 2 && std::string(argv[1]) == "--bench") return runBench();
+  if (argc != 5 || std::string(argv[1]) != "--width")
+  {
+    fprintf(stderr, "usage: epd_pack --width W IN OUT | epd_pack --bench\n");
+    return 2;
+  }
+  const size_t width = strtoul(argv[2], nullptr, 0);
+  const size_t rowBytes = (width + 7) / 8;
+  if (rowBytes == 0 || rowBytes > ROW_CODEC_MAX_ROW)
+  {
+    fprintf(stderr, "width must be 1..%zu\n", ROW_CODEC_MAX_ROW * 8);
+    return 2;
+  }
+
+  FILE *in = fopen(argv[3], "rb");
+  if (in == nullptr)
+  {
+    perror(argv[3]);
+    return 1;
+  }
+  std::vector<uint8_t> plane;
+  uint8_t buffer[4096];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), in)) > 0) plane.insert(plane.end(), buffer, buffer + n);
+  fclose(in);
+  if (plane.empty() || plane.size() % rowBytes != 0)
+  {
+    fprintf(stderr, "%s: %zu bytes is not a whole number of %zu-byte rows\n", argv[3], plane.size(), rowBytes);
+    return 1;
+  }
+
+  const std::vector<uint8_t> packed = encodePlane(plane.data(), rowBytes, plane.size() / rowBytes);
+  FILE *out = fopen(argv[4], "wb");
+  if (out == nullptr || fwrite(packed.data(), 1, packed.size(), out) != packed.size())
+  {
+    perror(argv[4]);
+    return 1;
+  }
+  fclose(out);
+  printf("%zu -> %zu bytes (%.2f:1)\n", plane.size(), packed.size(), static_cast<double>(plane.size()) / packed.size());
+  return 0;
+}
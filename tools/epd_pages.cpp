@@ -0,0 +1,324 @@
+// Host benchmark for paged rendering (PlaneDisplay with PageRows below the
+// panel height) against the full-frame raster, on the controller model of
+// tools/epd_sim.c.
+//
+// Build (Linux/macOS):
+//   cc -std=c99 -O2 -c tools/epd_sim.c -o epd_sim.o
+//   c++ -std=c++17 -O2 -Iinclude -Ilib/pio_ws2812_E-ink/generated -Itools tools/epd_pages.cpp epd_sim.o -o epd_pages
+//
+// Usage:
+//   epd_pages [--iterations N] [--spi-hz HZ] [--cs-us US] [--render-scale X]
+//
+// Each page of the diagnostics frame (shapes and status text, drawn
+// through the glyph cache) is rendered into a PlaneRaster of 8, 16 or 32
+// rows, or the full 212, and hashed. As GxEPD2_213c_Lab::writeImagePartAsync()
+// does, a page is sent only when its hash differs from the last page sent
+// to the same rows, as GxEPD2_213c's writeImagePart() sends it: 0x91, the
+// 0x90 window, the rows of 0x10 and 0x13, 0x92. Four frames are pushed in
+// turn: 'first' to a blank controller, 'busy' with the BUSY digit of the
+// status line flipped, 'same' unchanged and 'nudge' one pixel to the right.
+// After each the model's RAM must match the full-frame raster, in every
+// rotation.
+//
+// SPI time is modelled as in epd_cost: bytes * 8 / HZ plus US per CS
+// window, GxEPD2 opening one window per command and per _writeData() byte.
+// Render time (drawing and hashing the page) is measured here per page and
+// multiplied by X, the ratio of the target's render time to this host's
+// (1 by default; measure it on the board). 'serial' renders and sends page
+// after page; 'overlap' sends the black rows of page N by DMA while page
+// N + 1 renders into the other buffer, the rest of page N (window, plane
+// commands, red rows) from the CPU:
+//   render[0] + sum (spi[i] - black[i]) + sum max(render[i + 1], black[i]) + black[last]
+// with spi and black 0 for a skipped page. 'all pages' is the overlapped time with
+// every page sent, as before pages were hashed.
+// Exits non-zero on any mismatch.
+
+#include "diag_frame.h"
+#include "epd_sim.h"
+#include "panel_traits.h"
+#include "plane_raster.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+using Panel = Panel213c;
+using Controller = Panel::Controller;
+
+
+struct BusModel
+{
+  uint32_t spiHz = 4000000;
+  double csUs = 5.0;
+  double renderScale = 1.0;
+};
+
+// What reaches the bus for one page: command bytes, data bytes, CS windows;
+// the black rows, which go out by DMA, also on their own.
+struct BusCount
+{
+  size_t bytes = 0;
+  size_t windows = 0;
+  size_t blackBytes = 0;
+
+  double us(const BusModel &model) const
+  {
+    return bytes * 8.0 * 1e6 / model.spiHz + windows * model.csUs;
+  }
+
+  double blackUs(const BusModel &model) const
+  {
+    return blackBytes * 8.0 * 1e6 / model.spiHz + (blackBytes > 0 ? model.csUs : 0.0);
+  }
+};
+
+static void command(epd_sim_t *sim, BusCount &bus, uint8_t cmd)
+{
+  epd_sim_command(sim, cmd);
+  ++bus.bytes;
+  ++bus.windows;
+}
+
+static void data(epd_sim_t *sim, BusCount &bus, const uint8_t *bytes, size_t count, bool window)
+{
+  epd_sim_data(sim, bytes, count);
+  bus.bytes += count;
+  if (window) ++bus.windows;
+}
+
+// GxEPD2_213c::writeImagePart() for physical rows [y, y + rows) of a page.
+template <typename Raster>
+static BusCount sendPage(epd_sim_t *sim, const Raster &page, uint16_t y, uint16_t rows)
+{
+  BusCount bus;
+  const uint16_t ye = y + rows - 1;
+  const uint8_t area[7] = {0, static_cast<uint8_t>((Panel::width - 1) | 7), static_cast<uint8_t>(y >> 8),
+                           static_cast<uint8_t>(y), static_cast<uint8_t>(ye >> 8), static_cast<uint8_t>(ye), 0x01};
+  command(sim, bus, Controller::partialIn);
+  command(sim, bus, Controller::partialWindow);
+  for (uint8_t b : area) data(sim, bus, &b, 1, true);
+  const uint8_t *planes[2] = {page.black(), page.red()};
+  const uint8_t opcodes[2] = {Controller::blackPlane, Controller::redPlane};
+  for (int p = 0; p < 2; ++p)
+  {
+    command(sim, bus, opcodes[p]);
+    const uint8_t *row = planes[p] + static_cast<size_t>(y - page.top()) * Raster::STRIDE;
+    for (uint16_t r = 0; r < rows; ++r, row += Raster::STRIDE) data(sim, bus, row, Panel::rowBytes, r == 0);
+    if (p == 0) bus.blackBytes = static_cast<size_t>(rows) * Panel::rowBytes;
+  }
+  command(sim, bus, Controller::partialOut);
+  return bus;
+}
+
+// FNV-1a over the page's rows of both planes and its window, 32 bits at a
+// time, as GxEPD2_213c_Lab::hashPart() does.
+template <typename Raster>
+static uint64_t hashPage(const Raster &page, uint16_t y, uint16_t rows)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  auto mix = [&hash](uint32_t value) { hash = (hash ^ value) * 1099511628211ULL; };
+  mix((static_cast<uint32_t>(y) << 16) | rows);
+  const uint8_t *planes[2] = {page.black(), page.red()};
+  for (const uint8_t *plane : planes)
+  {
+    const uint8_t *row = plane + static_cast<size_t>(y - page.top()) * Raster::STRIDE;
+    for (uint16_t r = 0; r < rows; ++r, row += Raster::STRIDE)
+    {
+      size_t i = 0;
+      for (; i + 4 <= Panel::rowBytes; i += 4)
+      {
+        uint32_t word;
+        memcpy(&word, row + i, sizeof(word));
+        mix(word);
+      }
+      for (; i < Panel::rowBytes; ++i) mix(row[i]);
+    }
+  }
+  return hash;
+}
+
+template <typename Body>
+static double bestOf(int iterations, Body body)
+{
+  double best = 0;
+  for (int round = 0; round < 5; ++round)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) body();
+    const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    if (round == 0 || us < best) best = us;
+  }
+  return best / iterations;
+}
+
+using FullRaster = PlaneRaster<Panel>;
+
+static bool sameAsRaster(const epd_sim_t *sim, const FullRaster &frame)
+{
+  for (uint16_t y = 0; y < Panel::height; ++y)
+  {
+    for (uint16_t x = 0; x < Panel::width; ++x)
+    {
+      const size_t i = static_cast<size_t>(y) * FullRaster::STRIDE + x / 8;
+      const uint8_t bit = 0x80 >> (x & 7);
+      const epd_sim_pixel_t want = !(frame.red()[i] & bit)     ? EPD_SIM_RED
+                                   : !(frame.black()[i] & bit) ? EPD_SIM_BLACK
+                                                               : EPD_SIM_WHITE;
+      if (epd_sim_pixel(sim, x, y) != want) return false;
+    }
+  }
+  return true;
+}
+
+// Overlapped time of one frame: the black rows of page N sent while page
+// N + 1 renders.
+static double overlapUs(const std::vector<double> &renderUs, const std::vector<double> &spiUs,
+                        const std::vector<double> &blackUs)
+{
+  const size_t pages = renderUs.size();
+  double total = renderUs[0] + blackUs[pages - 1];
+  for (size_t i = 0; i < pages; ++i) total += spiUs[i] - blackUs[i];
+  for (size_t i = 0; i + 1 < pages; ++i) total += renderUs[i + 1] > blackUs[i] ? renderUs[i + 1] : blackUs[i];
+  return total;
+}
+
+struct Step
+{
+  const char *name;
+  DiagView view;
+};
+
+template <uint16_t Rows>
+static bool run(const BusModel &model, int iterations, uint8_t timedRotation)
+{
+  using Raster = PlaneRaster<Panel, Rows>;
+  constexpr uint16_t pages = (Panel::height + Rows - 1) / Rows;
+  constexpr uint8_t buffers = Raster::PAGED ? 2 : 1;
+  static Raster raster[2];
+  static FullRaster reference;
+  static DiagFrame<Panel> paged;
+  static DiagFrame<Panel> full;
+  static constexpr size_t STEPS = 4;
+
+  bool allOk = true;
+  std::vector<double> renderUs(pages);
+  std::vector<double> allSpiUs(pages);
+  std::vector<double> allBlackUs(pages);
+  std::vector<double> spiUs[STEPS];
+  std::vector<double> blackUs[STEPS];
+  size_t sent[STEPS] = {};
+  size_t bytes[STEPS] = {};
+  Step steps[STEPS] = {{"first", {}}, {"busy", {}}, {"same", {}}, {"nudge", {}}};
+  for (uint8_t rotation = 0; rotation < 4; ++rotation)
+  {
+    for (Step &step : steps) step.view.rotation = rotation;
+    steps[1].view.busy = steps[2].view.busy = steps[3].view.busy = 1;
+    steps[3].view.offsetX = 1;
+    const bool timed = rotation == timedRotation;
+    epd_sim_t *sim = epd_sim_create(EPD_SIM_UC8151_3C, Panel::width, Panel::height);
+    std::vector<uint64_t> last(pages);
+    for (size_t k = 0; k < STEPS; ++k)
+    {
+      const DiagView &view = steps[k].view;
+      full.draw(reference, view);
+      if (timed)
+      {
+        spiUs[k].assign(pages, 0.0);
+        blackUs[k].assign(pages, 0.0);
+      }
+      for (uint16_t page = 0; page < pages; ++page)
+      {
+        const uint16_t y = page * Rows;
+        const uint16_t rows = Panel::height - y < Rows ? Panel::height - y : Rows;
+        Raster &r = raster[page % buffers];
+        r.setPage(y);
+        paged.draw(r, view);
+        const uint64_t hash = hashPage(r, y, rows);
+        if (k > 0 && hash == last[page]) continue;
+        last[page] = hash;
+        const BusCount bus = sendPage(sim, r, y, rows);
+        if (!timed) continue;
+        ++sent[k];
+        bytes[k] += bus.bytes;
+        spiUs[k][page] = bus.us(model);
+        blackUs[k][page] = bus.blackUs(model);
+        if (k > 0) continue;
+        allSpiUs[page] = spiUs[k][page];
+        allBlackUs[page] = blackUs[k][page];
+        renderUs[page] = model.renderScale * bestOf(iterations, [&]() {
+                           paged.draw(r, view);
+                           (void)hashPage(r, y, rows);
+                         });
+      }
+      if (!sameAsRaster(sim, reference))
+      {
+        printf("rows %3u rot %u %s: controller RAM differs from the full frame\n", Rows, rotation, steps[k].name);
+        allOk = false;
+      }
+    }
+    epd_sim_destroy(sim);
+  }
+
+  double render = 0;
+  for (double us : renderUs) render += us;
+  const size_t ram = buffers * 2 * sizeof(uint32_t) * ((Raster::PLANE_BYTES + 3) / 4);
+  const size_t hashes = pages * (sizeof(uint64_t) + sizeof(bool));
+  printf("rows %3u  %2u pages  RAM %5zu B + %3zu B hashes  render %8.1f us  all pages %8.1f us  %s\n", Rows, pages,
+         ram, hashes, render, overlapUs(renderUs, allSpiUs, allBlackUs), allOk ? "identical" : "MISMATCH");
+  for (size_t k = 0; k < STEPS; ++k)
+  {
+    double spi = 0;
+    for (double us : spiUs[k]) spi += us;
+    const double overlap = overlapUs(renderUs, spiUs[k], blackUs[k]);
+    printf("  %-6s %2zu sent  SPI %5zu B %8.1f us  serial %8.1f us  overlap %8.1f us  (%5.1f%% less than all pages)\n",
+           steps[k].name, sent[k], bytes[k], spi, render + spi, overlap,
+           100.0 * (1.0 - overlap / overlapUs(renderUs, allSpiUs, allBlackUs)));
+  }
+  return allOk;
+}
+
+int main(int argc, char **argv)
+{
+  BusModel model;
+  int iterations = 200;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (arg == "--iterations" && i + 1 < argc)
+    {
+      iterations = atoi(argv[++i]);
+    }
+    else if (arg == "--spi-hz" && i + 1 < argc)
+    {
+      model.spiHz = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+    }
+    else if (arg == "--cs-us" && i + 1 < argc)
+    {
+      model.csUs = atof(argv[++i]);
+    }
+    else if (arg == "--render-scale" && i + 1 < argc)
+    {
+      model.renderScale = atof(argv[++i]);
+    }
+    else
+    {
+      fprintf(stderr, "usage: epd_pages [--iterations N] [--spi-hz HZ] [--cs-us US] [--render-scale X]\n");
+      return 2;
+    }
+  }
+  if (iterations < 1) iterations = 1;
+  if (model.spiHz == 0) model.spiHz = 1;
+
+  // rotation 1 is the firmware's default
+  printf("SPI %u Hz, %.1f us per CS window, render time x%.1f, rotation 1\n", model.spiHz, model.csUs,
+         model.renderScale);
+  bool allOk = true;
+  allOk = run<8>(model, iterations, 1) && allOk;
+  allOk = run<16>(model, iterations, 1) && allOk;
+  allOk = run<32>(model, iterations, 1) && allOk;
+  allOk = run<Panel::height>(model, iterations, 1) && allOk;
+  return allOk ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+// Host check of the lib's frame push on the recording HAL backend: one
+// epd_frame_push() must be two CS transactions, 0x10 with 2912 bytes of
+// 0x00 and 0x13 with the frame, against one transaction per byte when the
+// planes go out through epd_write_data() as before.
+//
+// Build (from the repo root):
+//   cc -std=c99 -O2 -DEPD_HOST_BUILD -DEPD_HAL_RECORD -Ilib/pio_ws2812_E-ink
+//      tools/epd_push_check.c lib/pio_ws2812_E-ink/epd.c
+//      lib/pio_ws2812_E-ink/epd_spi_host.c lib/pio_ws2812_E-ink/epd_hal_record.c
+//      -o epd_push_check
+//
+// Exits non-zero on any mismatch.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "epd.h"
+#include "epd_hal.h"
+#include "epd_spi.h"
+
+typedef struct {
+    int opcode;
+    unsigned cmd_bytes;
+    unsigned data_bytes;
+} tx_t;
+
+// Data bytes as they reach the line, plane after plane
+static uint8_t wire[2 * EPD_ARRAY];
+static size_t wire_len;
+
+static void spi_sink(bool dc, const uint8_t *buf, size_t len, void *user){
+    (void)user;
+    if (!dc) return;
+    for (size_t i = 0; i < len && wire_len < sizeof(wire); i++) wire[wire_len++] = buf[i];
+}
+
+// "tx" lines of the CSV log; returns their count, at most max
+static size_t read_log(FILE *f, tx_t *txs, size_t max){
+    char line[256];
+    size_t n = 0;
+    rewind(f);
+    if (!fgets(line, sizeof(line), f)) return 0;   // header
+    while (fgets(line, sizeof(line), f)){
+        unsigned seq, vt, cmd = 0, data = 0, op = 0;
+        double t;
+        char kind[8];
+        if (sscanf(line, "%u,%lf,%u,%7[^,],", &seq, &t, &vt, kind) != 4) continue;
+        if (strcmp(kind, "tx") != 0) continue;
+        const char *p = strstr(line, ",tx,") + 4;
+        const int has_op = sscanf(p, "0x%x,%u,%u", &op, &cmd, &data) == 3;
+        if (!has_op) sscanf(p, ",%u,%u", &cmd, &data);
+        if (n < max) txs[n] = (tx_t){ has_op ? (int)op : -1, cmd, data };
+        n++;
+    }
+    return n;
+}
+
+typedef void (*push_fn)(const uint8_t *frame);
+
+// Planes through epd_write_data(), one CS window per byte
+static void push_per_byte(const uint8_t *frame){
+    epd_write_cmd(0x10);
+    for (int i = 0; i < EPD_ARRAY; i++) epd_write_data(0x00);
+    epd_write_cmd(0x13);
+    for (int i = 0; i < EPD_ARRAY; i++) epd_write_data(frame[i]);
+}
+
+static size_t record(push_fn push, const uint8_t *frame, tx_t *txs, size_t max, epd_spi_stats_t *stats){
+    FILE *f = tmpfile();
+    if (!f){
+        perror("tmpfile");
+        exit(1);
+    }
+    wire_len = 0;
+    epd_spi_stats_reset();
+    epd_hal_record_start(f);
+    push(frame);
+    epd_hal_record_stop();
+    epd_spi_stats_get(stats);
+    const size_t n = read_log(f, txs, max);
+    fclose(f);
+    return n;
+}
+
+int main(void){
+    static uint8_t frame[EPD_ARRAY];
+    for (int i = 0; i < EPD_ARRAY; i++) frame[i] = (uint8_t)(i * 37 + (i >> 5));
+    epd_spi_host_set_sink(spi_sink, NULL);
+    epd_spi_init();
+
+    int fails = 0;
+    tx_t txs[4];
+    epd_spi_stats_t st;
+    const size_t n = record(epd_frame_push, frame, txs, 4, &st);
+    printf("epd_frame_push: %zu transactions, %u command bytes, %u data bytes\n", n, st.cmd_bytes, st.data_bytes);
+    const int opcodes[2] = { 0x10, 0x13 };
+    if (n != 2 || st.transactions != 2){
+        printf("  expected 2 transactions, log has %zu, backend counted %u\n", n, st.transactions);
+        fails++;
+    }
+    for (size_t i = 0; i < 2 && i < n; i++){
+        printf("  tx %zu: opcode 0x%02X, %u + %u bytes\n", i, txs[i].opcode, txs[i].cmd_bytes, txs[i].data_bytes);
+        if (txs[i].opcode != opcodes[i] || txs[i].cmd_bytes != 1 || txs[i].data_bytes != EPD_ARRAY){
+            printf("  expected opcode 0x%02X, 1 + %d bytes\n", opcodes[i], EPD_ARRAY);
+            fails++;
+        }
+    }
+    if (st.data_bytes != 2 * EPD_ARRAY || st.cmd_bytes != 2){
+        printf("  expected 2 command and %d data bytes\n", 2 * EPD_ARRAY);
+        fails++;
+    }
+    bool same = wire_len == 2 * EPD_ARRAY && memcmp(wire + EPD_ARRAY, frame, EPD_ARRAY) == 0;
+    for (size_t i = 0; same && i < EPD_ARRAY; i++) same = wire[i] == 0x00;
+    if (!same){
+        printf("  plane data differs from 0x00 / the frame\n");
+        fails++;
+    }
+
+    const size_t old = record(push_per_byte, frame, txs, 0, &st);
+    printf("per-byte writes: %zu transactions, %u data bytes\n", old, st.data_bytes);
+    if (old != 2 + 2 * EPD_ARRAY || st.data_bytes != 2 * EPD_ARRAY){
+        printf("  expected %d transactions\n", 2 + 2 * EPD_ARRAY);
+        fails++;
+    }
+    printf("%s\n", fails ? "FAILED" : "ok");
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,544 @@
+// Host benchmark for the PlaneRaster kernels in include/plane_raster.h
+// against the stock GxEPD2_3C + Adafruit_GFX path they replace.
+//
+// Build (Linux/macOS):
+//   c++ -std=c++17 -O2 -Iinclude tools/epd_raster.cpp -o epd_raster
+//
+// Usage:
+//   epd_raster [--iterations N]
+//
+// The stock path is modelled as the libraries implement it: fillScreen is a
+// memset, drawFastHLine/drawFastVLine go through Adafruit_GFX::writeLine and
+// fillRect through one writeFastVLine per column, all ending in a virtual
+// drawPixel with GxEPD2_3C's rotation, window, page and colour checks.
+// Both paths draw the shapes of renderDiagnostics() in every rotation, plus
+// a batch of random rectangles; the planes must come out bit-identical.
+//
+// Rotated bulk images: a full-frame 1bpp bitmap is drawn per pixel through
+// Adafruit_GFX::drawBitmap and through PlaneRaster::blit (8x8 transposes),
+// in every rotation, then random bitmaps at odd sizes and offsets. The
+// transpose kernel is also checked against a bit loop on random blocks.
+// Exits non-zero on any mismatch.
+
+#include "panel_traits.h"
+#include "plane_raster.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+using Panel = Panel213c;
+using Raster = PlaneRaster<Panel>;
+
+static constexpr uint16_t WHITE = 0xFFFF;
+static constexpr uint16_t BLACK = 0x0000;
+static constexpr uint16_t RED = 0xF800;
+
+enum class ShapeKind : uint8_t
+{
+  Screen,
+  HLine,
+  VLine,
+  Rect,
+  Fill
+};
+
+struct Shape
+{
+  ShapeKind kind;
+  int16_t x;
+  int16_t y;
+  int16_t w;
+  int16_t h;
+  uint16_t color;
+};
+
+// GxEPD2_3C<GxEPD2_213c, HEIGHT> full window, one page, with the
+// Adafruit_GFX default primitives on top.
+class StockGfx
+{
+public:
+  StockGfx()
+  {
+    fillScreen(WHITE);
+  }
+
+  virtual ~StockGfx() = default;
+
+  void setRotation(uint8_t r)
+  {
+    _rotation = r & 3;
+    _width = (_rotation & 1) ? Panel::height : Panel::width;
+    _height = (_rotation & 1) ? Panel::width : Panel::height;
+  }
+
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color)
+  {
+    if ((x < 0) || (x >= _width) || (y < 0) || (y >= _height)) return;
+    switch (_rotation)
+    {
+      case 1:
+        swap(x, y);
+        x = Panel::width - x - 1;
+        break;
+      case 2:
+        x = Panel::width - x - 1;
+        y = Panel::height - y - 1;
+        break;
+      case 3:
+        swap(x, y);
+        y = Panel::height - y - 1;
+        break;
+    }
+    x -= _pwX;
+    y -= _pwY;
+    if ((x < 0) || (x >= int16_t(_pwW)) || (y < 0) || (y >= int16_t(_pwH))) return;
+    y -= _currentPage * _pageHeight;
+    if ((y < 0) || (y >= int16_t(_pageHeight))) return;
+    const uint16_t i = x / 8 + y * (_pwW / 8);
+    _black[i] = (_black[i] | (1 << (7 - x % 8)));
+    _color[i] = (_color[i] | (1 << (7 - x % 8)));
+    if (color == WHITE) return;
+    else if (color == BLACK) _black[i] = (_black[i] & (0xFF ^ (1 << (7 - x % 8))));
+    else if ((color == RED) || (color == 0xFFE0)) _color[i] = (_color[i] & (0xFF ^ (1 << (7 - x % 8))));
+    else
+    {
+      if ((color & 0xF100) > (0xF100 / 2)) _color[i] = (_color[i] & (0xFF ^ (1 << (7 - x % 8))));
+      else if ((((color & 0xF800) >> 8) + ((color & 0x07E0) >> 3) + ((color & 0x001F) << 3)) < ((3 * 256) / 2))
+      {
+        _black[i] = (_black[i] & (0xFF ^ (1 << (7 - x % 8))));
+      }
+    }
+  }
+
+  void fillScreen(uint16_t color)
+  {
+    const PlaneInk ink = planeInk(color);
+    memset(_black, ink.black, sizeof(_black));
+    memset(_color, ink.red, sizeof(_color));
+  }
+
+  void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color)
+  {
+    const bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep)
+    {
+      swap(x0, y0);
+      swap(x1, y1);
+    }
+    if (x0 > x1)
+    {
+      swap(x0, x1);
+      swap(y0, y1);
+    }
+    const int16_t dx = x1 - x0;
+    const int16_t dy = abs(y1 - y0);
+    int16_t err = dx / 2;
+    const int16_t ystep = y0 < y1 ? 1 : -1;
+    for (; x0 <= x1; x0++)
+    {
+      if (steep) drawPixel(y0, x0, color);
+      else drawPixel(x0, y0, color);
+      err -= dy;
+      if (err < 0)
+      {
+        y0 += ystep;
+        err += dx;
+      }
+    }
+  }
+
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+  {
+    writeLine(x, y, x + w - 1, y, color);
+  }
+
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+  {
+    writeLine(x, y, x, y + h - 1, color);
+  }
+
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+  {
+    for (int16_t i = x; i < x + w; i++) drawFastVLine(i, y, h, color);
+  }
+
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+  {
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y + h - 1, w, color);
+    drawFastVLine(x, y, h, color);
+    drawFastVLine(x + w - 1, y, h, color);
+  }
+
+  void drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t color)
+  {
+    const int16_t byteWidth = (w + 7) / 8;
+    uint8_t b = 0;
+    for (int16_t j = 0; j < h; j++, y++)
+    {
+      for (int16_t i = 0; i < w; i++)
+      {
+        if (i & 7) b <<= 1;
+        else b = bitmap[j * byteWidth + i / 8];
+        if (b & 0x80) drawPixel(x + i, y, color);
+      }
+    }
+  }
+
+  const uint8_t *black() const
+  {
+    return _black;
+  }
+
+  const uint8_t *red() const
+  {
+    return _color;
+  }
+
+private:
+  template <typename T>
+  static void swap(T &a, T &b)
+  {
+    T t = a;
+    a = b;
+    b = t;
+  }
+
+  uint8_t _black[Panel::planeBytes];
+  uint8_t _color[Panel::planeBytes];
+  uint8_t _rotation = 0;
+  int16_t _width = Panel::width;
+  int16_t _height = Panel::height;
+  uint16_t _pwX = 0;
+  uint16_t _pwY = 0;
+  uint16_t _pwW = Panel::width;
+  uint16_t _pwH = Panel::height;
+  int16_t _currentPage = 0;
+  uint16_t _pageHeight = Panel::height;
+};
+
+// What PlaneDisplay does with the same calls; drawRect is Adafruit_GFX's
+// four fast lines.
+class FastGfx
+{
+public:
+  void setRotation(uint8_t r)
+  {
+    _rotation = r & 3;
+  }
+
+  void fillScreen(uint16_t color)
+  {
+    raster.fill(planeInk(color));
+  }
+
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+  {
+    raster.fillRect(_rotation, x, y, w, 1, planeInk(color));
+  }
+
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+  {
+    raster.fillRect(_rotation, x, y, 1, h, planeInk(color));
+  }
+
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+  {
+    raster.fillRect(_rotation, x, y, w, h, planeInk(color));
+  }
+
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+  {
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y + h - 1, w, color);
+    drawFastVLine(x, y, h, color);
+    drawFastVLine(x + w - 1, y, h, color);
+  }
+
+  void drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t color)
+  {
+    raster.blit(_rotation, x, y, bitmap, w, h, planeInk(color));
+  }
+
+  Raster raster;
+
+private:
+  uint8_t _rotation = 0;
+};
+
+template <typename Gfx>
+static void drawShapes(Gfx &gfx, const std::vector<Shape> &shapes)
+{
+  for (const Shape &s : shapes)
+  {
+    switch (s.kind)
+    {
+      case ShapeKind::Screen:
+        gfx.fillScreen(s.color);
+        break;
+      case ShapeKind::HLine:
+        gfx.drawFastHLine(s.x, s.y, s.w, s.color);
+        break;
+      case ShapeKind::VLine:
+        gfx.drawFastVLine(s.x, s.y, s.h, s.color);
+        break;
+      case ShapeKind::Rect:
+        gfx.drawRect(s.x, s.y, s.w, s.h, s.color);
+        break;
+      case ShapeKind::Fill:
+        gfx.fillRect(s.x, s.y, s.w, s.h, s.color);
+        break;
+    }
+  }
+}
+
+// renderDiagnostics() without the text, offsets 0
+static std::vector<Shape> diagnosticsFrame(uint8_t rotation)
+{
+  const int16_t w = Panel::widthFor(rotation);
+  const int16_t h = Panel::heightFor(rotation);
+  const int16_t box = 48;
+  return {
+      {ShapeKind::Screen, 0, 0, w, h, WHITE},
+      {ShapeKind::HLine, 0, static_cast<int16_t>(h / 2), w, 1, BLACK},
+      {ShapeKind::VLine, static_cast<int16_t>(w / 2), 0, 1, h, BLACK},
+      {ShapeKind::Rect, 0, 0, w, h, BLACK},
+      {ShapeKind::Fill, static_cast<int16_t>(w / 2 - box / 2), static_cast<int16_t>(h / 2 - box / 2), box, box, RED},
+  };
+}
+
+static std::vector<Shape> randomShapes(uint8_t rotation, size_t count, uint32_t &seed)
+{
+  const uint16_t colors[] = {WHITE, BLACK, RED, 0xFFE0, 0x7BEF, 0xF81F};
+  const int16_t w = Panel::widthFor(rotation);
+  const int16_t h = Panel::heightFor(rotation);
+  auto next = [&seed](int32_t range)
+  {
+    seed = seed * 1103515245u + 12345u;
+    return static_cast<int16_t>((seed >> 8) % static_cast<uint32_t>(range));
+  };
+  std::vector<Shape> shapes;
+  for (size_t i = 0; i < count; ++i)
+  {
+    const ShapeKind kind = static_cast<ShapeKind>(1 + next(4));
+    shapes.push_back({kind, static_cast<int16_t>(next(w + 20) - 10), static_cast<int16_t>(next(h + 20) - 10),
+                      static_cast<int16_t>(next(w) + 1), static_cast<int16_t>(next(h) + 1), colors[next(6)]});
+  }
+  return shapes;
+}
+
+static size_t shapePixels(const std::vector<Shape> &shapes)
+{
+  size_t n = 0;
+  for (const Shape &s : shapes)
+  {
+    switch (s.kind)
+    {
+      case ShapeKind::HLine:
+        n += s.w;
+        break;
+      case ShapeKind::VLine:
+        n += s.h;
+        break;
+      case ShapeKind::Rect:
+        n += 2 * (s.w + s.h);
+        break;
+      default:
+        n += static_cast<size_t>(s.w) * s.h;
+        break;
+    }
+  }
+  return n;
+}
+
+static bool samePlanes(const StockGfx &stock, const FastGfx &fast)
+{
+  for (uint16_t y = 0; y < Panel::height; ++y)
+  {
+    const size_t a = static_cast<size_t>(y) * Panel::rowBytes;
+    const size_t b = static_cast<size_t>(y) * Raster::STRIDE;
+    if (memcmp(stock.black() + a, fast.raster.black() + b, Panel::rowBytes) != 0) return false;
+    if (memcmp(stock.red() + a, fast.raster.red() + b, Panel::rowBytes) != 0) return false;
+  }
+  return true;
+}
+
+static std::vector<uint8_t> randomBitmap(int16_t w, int16_t h, uint32_t &seed)
+{
+  std::vector<uint8_t> bits(static_cast<size_t>((w + 7) / 8) * h);
+  for (uint8_t &b : bits)
+  {
+    seed = seed * 1103515245u + 12345u;
+    b = static_cast<uint8_t>(seed >> 16);
+  }
+  return bits;
+}
+
+static bool checkTranspose(uint32_t &seed)
+{
+  for (int round = 0; round < 10000; ++round)
+  {
+    uint8_t in[8];
+    uint8_t out[8];
+    for (uint8_t &b : in)
+    {
+      seed = seed * 1103515245u + 12345u;
+      b = static_cast<uint8_t>(seed >> 16);
+    }
+    transpose8(in, out);
+    for (int j = 0; j < 8; ++j)
+    {
+      uint8_t expect = 0;
+      for (int k = 0; k < 8; ++k)
+      {
+        if (in[k] & (0x80 >> j)) expect |= 0x80 >> k;
+      }
+      if (out[j] != expect) return false;
+    }
+  }
+  return true;
+}
+
+// Best of five rounds, in microseconds per call of body; a shared host
+// makes single averages too noisy for the ratios printed here.
+template <typename Body>
+static double bestOf(int iterations, Body body)
+{
+  double best = 0;
+  for (int round = 0; round < 5; ++round)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) body();
+    const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    if (round == 0 || us < best) best = us;
+  }
+  return best / iterations;
+}
+
+template <typename Gfx>
+static double timeBitmap(Gfx &gfx, uint8_t rotation, const std::vector<uint8_t> &bits, int iterations)
+{
+  gfx.setRotation(rotation);
+  const int16_t w = Panel::widthFor(rotation);
+  const int16_t h = Panel::heightFor(rotation);
+  return bestOf(iterations, [&]()
+  {
+    gfx.fillScreen(WHITE);
+    gfx.drawBitmap(0, 0, bits.data(), w, h, BLACK);
+  });
+}
+
+template <typename Gfx>
+static double timeShapes(Gfx &gfx, uint8_t rotation, const std::vector<Shape> &shapes, int iterations)
+{
+  gfx.setRotation(rotation);
+  return bestOf(iterations, [&]() { drawShapes(gfx, shapes); });
+}
+
+int main(int argc, char **argv)
+{
+  int iterations = 2000;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (std::string(argv[i]) == "--iterations" && i + 1 < argc)
+    {
+      iterations = atoi(argv[++i]);
+    }
+    else
+    {
+      fprintf(stderr, "usage: epd_raster [--iterations N]\n");
+      return 2;
+    }
+  }
+  if (iterations < 1) iterations = 1;
+
+  static StockGfx stock;
+  static FastGfx fast;
+  bool allOk = true;
+  for (uint8_t rotation = 0; rotation < 4; ++rotation)
+  {
+    const std::vector<Shape> frame = diagnosticsFrame(rotation);
+    const double stockUs = timeShapes(stock, rotation, frame, iterations);
+    const double fastUs = timeShapes(fast, rotation, frame, iterations);
+    const bool ok = samePlanes(stock, fast);
+    allOk = allOk && ok;
+    const double pixels = static_cast<double>(shapePixels(frame));
+    printf("diagnostics rot %u  stock %8.2f us %7.1f px/us  raster %7.2f us %8.1f px/us  x%6.1f  %s\n", rotation,
+           stockUs, pixels / stockUs, fastUs, pixels / fastUs, stockUs / fastUs, ok ? "identical" : "MISMATCH");
+  }
+
+  uint32_t seed = 12345;
+  size_t checked = 0;
+  bool shapesOk = true;
+  for (uint8_t rotation = 0; rotation < 4; ++rotation)
+  {
+    for (int round = 0; round < 50; ++round)
+    {
+      const std::vector<Shape> shapes = randomShapes(rotation, 40, seed);
+      stock.setRotation(rotation);
+      fast.setRotation(rotation);
+      stock.fillScreen(WHITE);
+      fast.fillScreen(WHITE);
+      drawShapes(stock, shapes);
+      drawShapes(fast, shapes);
+      const bool ok = samePlanes(stock, fast);
+      if (!ok) printf("random shapes rot %u round %d MISMATCH\n", rotation, round);
+      shapesOk = shapesOk && ok;
+      checked += shapes.size();
+    }
+  }
+  allOk = allOk && shapesOk;
+  printf("random shapes: %zu checked against the stock path, %s\n", checked, shapesOk ? "all identical" : "MISMATCH");
+
+  const bool transposeOk = checkTranspose(seed);
+  allOk = allOk && transposeOk;
+  printf("transpose8: 10000 random blocks %s\n", transposeOk ? "match the bit loop" : "MISMATCH");
+
+  for (uint8_t rotation = 0; rotation < 4; ++rotation)
+  {
+    const std::vector<uint8_t> bits =
+        randomBitmap(Panel::widthFor(rotation), Panel::heightFor(rotation), seed);
+    const double stockUs = timeBitmap(stock, rotation, bits, iterations / 4 + 1);
+    const double fastUs = timeBitmap(fast, rotation, bits, iterations);
+    const bool ok = samePlanes(stock, fast);
+    allOk = allOk && ok;
+    printf("full-frame blit rot %u  per-pixel %8.2f us  transpose %7.2f us  x%6.1f  %s\n", rotation, stockUs,
+           fastUs, stockUs / fastUs, ok ? "identical" : "MISMATCH");
+  }
+
+  size_t blits = 0;
+  bool blitsOk = true;
+  for (uint8_t rotation = 0; rotation < 4; ++rotation)
+  {
+    stock.setRotation(rotation);
+    fast.setRotation(rotation);
+    stock.fillScreen(WHITE);
+    fast.fillScreen(WHITE);
+    for (int round = 0; round < 300; ++round)
+    {
+      seed = seed * 1103515245u + 12345u;
+      const int16_t w = static_cast<int16_t>(1 + (seed >> 8) % 60);
+      seed = seed * 1103515245u + 12345u;
+      const int16_t h = static_cast<int16_t>(1 + (seed >> 8) % 60);
+      seed = seed * 1103515245u + 12345u;
+      const int16_t x = static_cast<int16_t>(static_cast<int32_t>((seed >> 8) % (Panel::widthFor(rotation) + 40)) - 30);
+      seed = seed * 1103515245u + 12345u;
+      const int16_t y = static_cast<int16_t>(static_cast<int32_t>((seed >> 8) % (Panel::heightFor(rotation) + 40)) - 30);
+      const uint16_t color = round % 3 == 0 ? RED : (round % 3 == 1 ? BLACK : WHITE);
+      const std::vector<uint8_t> bits = randomBitmap(w, h, seed);
+      stock.drawBitmap(x, y, bits.data(), w, h, color);
+      fast.drawBitmap(x, y, bits.data(), w, h, color);
+      ++blits;
+    }
+    const bool ok = samePlanes(stock, fast);
+    if (!ok) printf("random blits rot %u MISMATCH\n", rotation);
+    blitsOk = blitsOk && ok;
+  }
+  allOk = allOk && blitsOk;
+  printf("random blits: %zu at odd sizes and offsets, %s\n", blits, blitsOk ? "all identical" : "MISMATCH");
+  return allOk ? 0 : 1;
+}
@@ -0,0 +1,154 @@
+// Host check of RefreshEngine (src/refresh_engine.cpp) against FakeBusyLine:
+// a refresh that completes, one whose BUSY never releases, and one that
+// times out waiting for the panel to go idle, with the firmware's deadlines
+// and GxEPD2_213c's 15 s full refresh.
+//
+// Build (from the repo root):
+//   c++ -std=c++17 -O2 -Iinclude tools/epd_refresh_check.cpp src/refresh_engine.cpp -o epd_refresh_check
+//
+// Exits non-zero on any mismatch.
+
+#include "fake_busy_line.h"
+#include "refresh_engine.h"
+
+#include <stdio.h>
+
+static constexpr RefreshDeadlines DEADLINES = RefreshEngine::UC8151_DEADLINES;
+static constexpr RefreshOpcodes OPCODES = RefreshEngine::UC8151_OPCODES;
+static constexpr uint32_t POWER_ON_MS = 80;
+static constexpr uint32_t FULL_REFRESH_MS = 15000;
+static constexpr uint32_t POWER_OFF_MS = 40;
+static constexpr uint32_t STEP_MS = 5;
+
+static int g_fails = 0;
+
+static void expect(bool ok, const char *what)
+{
+  if (!ok)
+  {
+    printf("  expected %s\n", what);
+    ++g_fails;
+  }
+}
+
+static void setUpPanel(FakeBusyLine &line)
+{
+  line.setBusyFor(OPCODES.powerOn, POWER_ON_MS);
+  line.setBusyFor(OPCODES.refresh, FULL_REFRESH_MS);
+  line.setBusyFor(OPCODES.powerOff, POWER_OFF_MS);
+}
+
+// Polls as loop() does, STEP_MS apart, until the engine reports an event.
+static RefreshEvent run(RefreshEngine &engine, FakeBusyLine &line, uint32_t &polls)
+{
+  RefreshEvent event = RefreshEvent::None;
+  polls = 0;
+  while (event == RefreshEvent::None && polls < 100000)
+  {
+    line.advance(STEP_MS);
+    event = engine.poll(line);
+    ++polls;
+  }
+  return event;
+}
+
+static void printCommands(const FakeBusyLine &line)
+{
+  printf("  commands:");
+  for (size_t i = 0; i < line.commandCount(); ++i) printf(" 0x%02X", line.command(i));
+  printf("\n");
+}
+
+static void completes()
+{
+  printf("full refresh, BUSY released after %u ms\n", FULL_REFRESH_MS);
+  FakeBusyLine line;
+  setUpPanel(line);
+  RefreshEngine engine(DEADLINES);
+  expect(engine.start(line, true), "start() to accept the refresh");
+  expect(!engine.start(line, true), "a second start() to be refused");
+  uint32_t polls = 0;
+  const RefreshEvent event = run(engine, line, polls);
+  printCommands(line);
+  printf("  %s after %u polls, %u ms\n", event == RefreshEvent::Done ? "done" : "no Done", polls,
+         engine.lastDurationMs());
+  expect(event == RefreshEvent::Done, "Done");
+  expect(line.commandCount() == 3 && line.command(0) == OPCODES.powerOn && line.command(1) == OPCODES.refresh &&
+           line.command(2) == OPCODES.powerOff,
+         "power-on, refresh, power-off");
+  expect(engine.poweredOff(), "the panel powered off");
+  expect(engine.lastDurationMs() >= POWER_ON_MS + FULL_REFRESH_MS + POWER_OFF_MS &&
+           engine.lastDurationMs() <= POWER_ON_MS + FULL_REFRESH_MS + POWER_OFF_MS + 3 * STEP_MS,
+         "the duration of the three BUSY phases");
+
+  // Already powered: no power-on. The edge interrupt dates the release,
+  // so a late poll does not stretch the measured duration.
+  FakeBusyLine edged;
+  edged.setBusyFor(OPCODES.refresh, 100);
+  edged.setBusyFor(OPCODES.powerOff, 20);
+  RefreshEngine second(DEADLINES);
+  second.start(edged, false);
+  second.poll(edged);
+  edged.advance(150);
+  second.poll(edged);
+  edged.advance(20);
+  second.notifyBusyEdge(edged.nowMs());
+  edged.advance(80);
+  const RefreshEvent late = second.poll(edged);
+  expect(late == RefreshEvent::Done, "Done on the poll after the edge");
+  expect(edged.commandCount() == 2 && edged.command(0) == OPCODES.refresh, "no power-on when already powered");
+  expect(second.lastDurationMs() == 170, "the duration up to the power-off edge, not the late poll");
+}
+
+static void stuckRefresh()
+{
+  printf("BUSY stuck after the refresh command\n");
+  FakeBusyLine line;
+  setUpPanel(line);
+  line.setBusyFor(OPCODES.refresh, 60000);
+  RefreshEngine engine(DEADLINES);
+  engine.start(line, true);
+  uint32_t polls = 0;
+  const RefreshEvent event = run(engine, line, polls);
+  printCommands(line);
+  printf("  %s in %s phase after %u ms\n", event == RefreshEvent::Timeout ? "timeout" : "no Timeout",
+         RefreshEngine::phaseName(engine.failedPhase()), engine.lastDurationMs());
+  expect(event == RefreshEvent::Timeout, "Timeout");
+  expect(engine.failedPhase() == RefreshPhase::Refresh, "the refresh phase to fail");
+  expect(!engine.busy(), "the engine idle again");
+  expect(line.commandCount() == 3 && line.command(2) == OPCODES.powerOff, "power-off after the timeout");
+  expect(engine.poweredOff(), "poweredOff() after the timeout");
+  expect(engine.lastDurationMs() > POWER_ON_MS + DEADLINES.refreshMs, "the timeout past the refresh deadline");
+}
+
+static void stuckIdle()
+{
+  printf("BUSY stuck before the sequence starts\n");
+  FakeBusyLine line;
+  setUpPanel(line);
+  line.setStuck(true);
+  RefreshEngine engine(DEADLINES);
+  engine.start(line, true);
+  uint32_t polls = 0;
+  const RefreshEvent event = run(engine, line, polls);
+  printCommands(line);
+  printf("  %s in %s phase after %u ms\n", event == RefreshEvent::Timeout ? "timeout" : "no Timeout",
+         RefreshEngine::phaseName(engine.failedPhase()), engine.lastDurationMs());
+  expect(event == RefreshEvent::Timeout && engine.failedPhase() == RefreshPhase::Init, "Timeout in init");
+  expect(line.commandCount() == 0, "no commands to a panel that never went idle");
+  expect(!engine.poweredOff(), "the power state left alone");
+
+  // The engine takes the next refresh once the line recovers.
+  line.setStuck(false);
+  expect(engine.start(line, true), "a new start() after the timeout");
+  expect(run(engine, line, polls) == RefreshEvent::Done, "Done once BUSY behaves");
+}
+
+int main()
+{
+  completes();
+  stuckRefresh();
+  stuckIdle();
+  printf("%s\n", g_fails ? "FAILED" : "ok");
+  return g_fails ? 1 : 0;
+}
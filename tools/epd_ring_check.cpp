@@ -0,0 +1,170 @@
+// Host check of SpscRing (include/spsc_ring.h), the queue between the
+// console core and the render core. Single-threaded: a full ring refuses
+// pushes, an empty one pops nothing, and order survives the slot index and
+// the free-running 32-bit indices wrapping. Two threads: a producer and a
+// consumer pass a million sequence-numbered items through a small ring,
+// also across the 2^32 wrap; the consumer checks order and that no item
+// arrives torn. Build it with ThreadSanitizer so a missing acquire/release
+// shows up as a data race on the slots:
+//
+// Build (from the repo root):
+//   c++ -std=c++17 -O1 -g -fsanitize=thread -pthread -Iinclude tools/epd_ring_check.cpp -o epd_ring_check
+//
+// Usage:
+//   epd_ring_check [--items N]
+//
+// Exits non-zero on any mismatch.
+
+#include "spsc_ring.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+
+// Larger than a word so a read racing a write would be caught torn.
+struct Item
+{
+  uint32_t seq;
+  uint32_t check;
+  uint8_t pad[24];
+};
+
+static constexpr size_t DEPTH = 8;
+using Ring = SpscRing<Item, DEPTH>;
+
+static int g_fails = 0;
+
+static void expect(bool ok, const char *what)
+{
+  if (!ok)
+  {
+    printf("  expected %s\n", what);
+    ++g_fails;
+  }
+}
+
+static Item makeItem(uint32_t seq)
+{
+  Item item{};
+  item.seq = seq;
+  item.check = ~seq * 2654435761u;
+  for (size_t i = 0; i < sizeof(item.pad); ++i) item.pad[i] = static_cast<uint8_t>(seq + i);
+  return item;
+}
+
+static bool intact(const Item &item)
+{
+  if (item.check != ~item.seq * 2654435761u) return false;
+  for (size_t i = 0; i < sizeof(item.pad); ++i)
+  {
+    if (item.pad[i] != static_cast<uint8_t>(item.seq + i)) return false;
+  }
+  return true;
+}
+
+static void fullAndEmpty()
+{
+  printf("full and empty ring\n");
+  Ring ring;
+  Item out;
+  expect(ring.empty() && !ring.pop(out), "an empty ring to pop nothing");
+  for (uint32_t i = 0; i < DEPTH; ++i) expect(ring.push(makeItem(i)), "pushes up to the depth to succeed");
+  expect(ring.full() && ring.size() == DEPTH && ring.space() == 0, "the ring full at its depth");
+  expect(!ring.push(makeItem(DEPTH)), "a push into a full ring to be refused");
+  expect(ring.pop(out) && out.seq == 0, "the oldest item first");
+  expect(ring.push(makeItem(DEPTH)), "a push once a slot is free");
+  for (uint32_t i = 1; i <= DEPTH; ++i) expect(ring.pop(out) && out.seq == i && intact(out), "items in push order");
+  expect(ring.empty() && !ring.pop(out), "the ring empty again");
+}
+
+// Batches of 1..DEPTH items, so the slot index wraps at every phase.
+static void wraparound(const char *name, uint32_t first)
+{
+  printf("%s, indices from 0x%08X\n", name, first);
+  Ring ring(first);
+  uint32_t pushed = 0;
+  uint32_t popped = 0;
+  bool ordered = true;
+  for (uint32_t round = 0; round < 64; ++round)
+  {
+    const uint32_t batch = 1 + round % DEPTH;
+    for (uint32_t i = 0; i < batch; ++i) ring.push(makeItem(pushed++));
+    if (ring.size() != batch) ordered = false;
+    Item out;
+    while (ring.pop(out))
+    {
+      if (out.seq != popped++ || !intact(out)) ordered = false;
+    }
+  }
+  expect(ordered && popped == pushed, "every batch back in order with the right size");
+}
+
+static void twoThreads(const char *name, uint32_t first, uint32_t items)
+{
+  Ring ring(first);
+  uint32_t refused = 0;
+  std::thread producer([&] {
+    for (uint32_t seq = 0; seq < items; ++seq)
+    {
+      const Item item = makeItem(seq);
+      while (!ring.push(item))
+      {
+        ++refused;
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  uint32_t next = 0;
+  uint32_t disorder = 0;
+  uint32_t torn = 0;
+  uint32_t maxSize = 0;
+  while (next < items)
+  {
+    const uint32_t size = static_cast<uint32_t>(ring.size());
+    if (size > maxSize) maxSize = size;
+    Item out;
+    if (!ring.pop(out))
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    if (out.seq != next) ++disorder;
+    if (!intact(out)) ++torn;
+    next = out.seq + 1;
+  }
+  producer.join();
+  printf("%s, indices from 0x%08X: %u items, %u pushes refused while full, max size %u\n", name, first, items,
+         refused, maxSize);
+  expect(disorder == 0, "items in order");
+  expect(torn == 0, "no torn items");
+  expect(maxSize <= DEPTH, "size() never above the depth");
+  expect(ring.empty(), "the ring drained");
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t items = 1000000;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (arg == "--items" && i + 1 < argc)
+    {
+      items = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+    }
+    else
+    {
+      fprintf(stderr, "usage: epd_ring_check [--items N]\n");
+      return 2;
+    }
+  }
+
+  fullAndEmpty();
+  wraparound("slot wraparound", 0);
+  wraparound("index wraparound", 0xFFFFFFF0u);
+  twoThreads("two threads", 0, items);
+  twoThreads("two threads", 0xFFFFFFFFu - items / 2, items);
+  printf("%s\n", g_fails ? "FAILED" : "ok");
+  return g_fails ? 1 : 0;
+}
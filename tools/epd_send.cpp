@@ -0,0 +1,297 @@
+// Host sender for the binary console frames in include/frame_protocol.h.
+//
+// Build (Linux/macOS):
+//   c++ -std=c++17 -O2 -Iinclude tools/epd_send.cpp -o epd_send
+//
+// Usage:
+//   epd_send [--ssd] [--window x0 x1 y0 y1] [--black FILE] [--red FILE]
+//            [--packed [--width W]] [--no-update] PORT
+//   epd_send --loopback [--bytes N] [--chunk N]
+//
+// Plane files are raw controller bytes (1 bit per pixel, rows padded to a
+// byte), sent as-is or, with --packed, in the row_codec.h format for a plane
+// W pixels wide (default 104). Each frame waits for the device's "[BIN] ok"
+// line before the next one goes out. --loopback runs the same frames through
+// the firmware's decoder in-process, in USB-packet sized pieces, and reports
+// sustained bytes/s and CRC checks.
+
+#include "frame_protocol.h"
+#include "panel_traits.h"
+#include "row_codec.h"
+
+#include <chrono>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <termios.h>
+#include <unistd.h>
+#include <vector>
+
+static constexpr uint16_t FRAME_PAYLOAD_MAX = 0xFFFF;
+static constexpr int REPLY_TIMEOUT_MS = 30000;
+
+static double secondsSince(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static std::vector<uint8_t> encodeFrame(FrameTarget target, const uint8_t *payload, uint16_t length)
+{
+  std::vector<uint8_t> frame(FRAME_HEADER_BYTES + length + FRAME_TRAILER_BYTES);
+  frameEncodeHeader(frame.data(), target, length);
+  if (length > 0) memcpy(frame.data() + FRAME_HEADER_BYTES, payload, length);
+  frameEncodeTrailer(frame.data() + FRAME_HEADER_BYTES + length, frame.data(), payload, length);
+  return frame;
+}
+
+static bool readFile(const char *path, std::vector<uint8_t> &out)
+{
+  FILE *f = fopen(path, "rb");
+  if (f == nullptr)
+  {
+    perror(path);
+    return false;
+  }
+  uint8_t buffer[4096];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0)
+  {
+    out.insert(out.end(), buffer, buffer + n);
+  }
+  fclose(f);
+  if (out.empty() || out.size() > FRAME_PAYLOAD_MAX)
+  {
+    fprintf(stderr, "%s: size %zu out of range\n", path, out.size());
+    return false;
+  }
+  return true;
+}
+
+static int openPort(const char *path)
+{
+  const int fd = open(path, O_RDWR | O_NOCTTY);
+  if (fd < 0)
+  {
+    perror(path);
+    return -1;
+  }
+  termios tio;
+  tcgetattr(fd, &tio);
+  cfmakeraw(&tio);
+  cfsetispeed(&tio, B115200);
+  cfsetospeed(&tio, B115200);
+  tio.c_cc[VMIN] = 0;
+  tio.c_cc[VTIME] = 1;
+  tcsetattr(fd, TCSANOW, &tio);
+  tcflush(fd, TCIOFLUSH);
+  return fd;
+}
+
+static bool writeAll(int fd, const uint8_t *data, size_t count)
+{
+  while (count > 0)
+  {
+    const ssize_t n = write(fd, data, count);
+    if (n < 0)
+    {
+      perror("write");
+      return false;
+    }
+    data += n;
+    count -= static_cast<size_t>(n);
+  }
+  return true;
+}
+
+// Echoes device lines until one starts with expect; "[ERR]" lines fail.
+static bool waitFor(int fd, const char *expect)
+{
+  std::string line;
+  const auto start = std::chrono::steady_clock::now();
+  while (secondsSince(start) * 1000 < REPLY_TIMEOUT_MS)
+  {
+    char c;
+    if (read(fd, &c, 1) != 1) continue;
+    if (c == '\r') continue;
+    if (c != '\n')
+    {
+      line += c;
+      continue;
+    }
+    printf("< %s\n", line.c_str());
+    if (line.rfind(expect, 0) == 0) return true;
+    if (line.rfind("[ERR]", 0) == 0) return false;
+    line.clear();
+  }
+  fprintf(stderr, "timeout waiting for \"%s\"\n", expect);
+  return false;
+}
+
+static bool packPlane(std::vector<uint8_t> &plane, size_t width)
+{
+  const size_t rowBytes = (width + 7) / 8;
+  if (rowBytes == 0 || rowBytes > ROW_CODEC_MAX_ROW || plane.size() % rowBytes != 0)
+  {
+    fprintf(stderr, "plane of %zu bytes does not fit width %zu\n", plane.size(), width);
+    return false;
+  }
+  std::vector<uint8_t> packed(rowCodecBound(rowBytes, plane.size() / rowBytes));
+  packed.resize(rowCodecEncode(plane.data(), rowBytes, plane.size() / rowBytes, packed.data()));
+  printf("packed %zu -> %zu bytes\n", plane.size(), packed.size());
+  plane.swap(packed);
+  return true;
+}
+
+static bool sendFrame(int fd, FrameTarget target, const std::vector<uint8_t> &payload, const char *expect)
+{
+  const std::vector<uint8_t> frame = encodeFrame(target, payload.data(), static_cast<uint16_t>(payload.size()));
+  return writeAll(fd, frame.data(), frame.size()) && waitFor(fd, expect);
+}
+
+static int runLoopback(size_t totalBytes, size_t chunk)
+{
+  // one 2.13" tri-colour plane per frame, every tenth frame corrupted
+  const uint16_t planeBytes = Panel213c::planeBytes;
+  std::vector<uint8_t> plane(planeBytes);
+  for (size_t i = 0; i < plane.size(); ++i)
+  {
+    plane[i] = static_cast<uint8_t>(i * 31 + 7);
+  }
+  std::vector<uint8_t> stream;
+  size_t frames = 0;
+  while (stream.size() < totalBytes)
+  {
+    std::vector<uint8_t> frame = encodeFrame(FrameTarget::Black, plane.data(), planeBytes);
+    if (frames % 10 == 9) frame[FRAME_HEADER_BYTES + frames % planeBytes] ^= 0x01;
+    stream.insert(stream.end(), frame.begin(), frame.end());
+    ++frames;
+  }
+
+  FrameDecoder decoder;
+  size_t good = 0;
+  size_t bad = 0;
+  size_t payload = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t pos = 0; pos < stream.size(); pos += chunk)
+  {
+    const size_t n = stream.size() - pos < chunk ? stream.size() - pos : chunk;
+    size_t used = 0;
+    while (used < n)
+    {
+      FrameEvent event;
+      used += decoder.feed(stream.data() + pos + used, n - used, event);
+      if (event.kind == FrameEvent::Kind::Data) payload += event.size;
+      if (event.kind == FrameEvent::Kind::End) (event.crcOk ? good : bad)++;
+    }
+  }
+  const double seconds = secondsSince(start);
+  const size_t expectBad = frames / 10;
+  printf("loopback: %zu frames, %zu ok, %zu bad (expected %zu), %zu payload bytes\n", frames, good, bad,
+         expectBad, payload);
+  printf("loopback: %.1f MB/s sustained (%zu-byte pieces)\n", stream.size() / seconds / 1e6, chunk);
+  return (bad == expectBad && good + bad == frames) ? 0 : 1;
+}
+
+static void usage()
+{
+  fprintf(stderr,
+          "usage: epd_send [--ssd] [--window x0 x1 y0 y1] [--black FILE] [--red FILE]\n"
+          "                [--packed [--width W]] [--no-update] PORT\n"
+          "       epd_send --loopback [--bytes N] [--chunk N]\n");
+}
+
+int main(int argc, char **argv)
+{
+  bool ssd = false;
+  bool update = true;
+  bool loopback = false;
+  bool window = false;
+  bool packed = false;
+  size_t width = Panel213c::width;
+  uint16_t area[4] = {};
+  size_t loopbackBytes = 16u << 20;
+  size_t chunk = 64;
+  const char *blackPath = nullptr;
+  const char *redPath = nullptr;
+  const char *port = nullptr;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (arg == "--ssd") ssd = true;
+    else if (arg == "--no-update") update = false;
+    else if (arg == "--loopback") loopback = true;
+    else if (arg == "--packed") packed = true;
+    else if (arg == "--width" && i + 1 < argc) width = strtoul(argv[++i], nullptr, 0);
+    else if (arg == "--black" && i + 1 < argc) blackPath = argv[++i];
+    else if (arg == "--red" && i + 1 < argc) redPath = argv[++i];
+    else if (arg == "--bytes" && i + 1 < argc) loopbackBytes = strtoul(argv[++i], nullptr, 0);
+    else if (arg == "--chunk" && i + 1 < argc) chunk = strtoul(argv[++i], nullptr, 0);
+    else if (arg == "--window" && i + 4 < argc)
+    {
+      window = true;
+      for (int k = 0; k < 4; ++k) area[k] = static_cast<uint16_t>(strtoul(argv[++i], nullptr, 0));
+    }
+    else if (arg[0] != '-' && port == nullptr) port = argv[i];
+    else
+    {
+      usage();
+      return 2;
+    }
+  }
+  if (loopback) return runLoopback(loopbackBytes, chunk > 0 ? chunk : 64);
+  if (port == nullptr)
+  {
+    usage();
+    return 2;
+  }
+
+  std::vector<uint8_t> black;
+  std::vector<uint8_t> red;
+  if (blackPath != nullptr && !readFile(blackPath, black)) return 1;
+  if (redPath != nullptr && !readFile(redPath, red)) return 1;
+  const size_t rawBytes = black.size() + red.size();
+  if (packed && !black.empty() && !packPlane(black, width)) return 1;
+  if (packed && !red.empty() && !packPlane(red, width)) return 1;
+
+  const int fd = openPort(port);
+  if (fd < 0) return 1;
+  const char *enter = ssd ? "bin ssd\n" : "bin\n";
+  if (!writeAll(fd, reinterpret_cast<const uint8_t *>(enter), strlen(enter)) || !waitFor(fd, "[BIN] ready")) return 1;
+
+  bool ok = true;
+  if (ok && window)
+  {
+    std::vector<uint8_t> payload(FRAME_WINDOW_BYTES);
+    for (int k = 0; k < 4; ++k)
+    {
+      payload[k * 2] = static_cast<uint8_t>(area[k] & 0xFF);
+      payload[k * 2 + 1] = static_cast<uint8_t>(area[k] >> 8);
+    }
+    ok = sendFrame(fd, FrameTarget::Window, payload, "[BIN] ok W");
+  }
+  const auto start = std::chrono::steady_clock::now();
+  if (ok && !black.empty())
+  {
+    ok = packed ? sendFrame(fd, FrameTarget::PackedBlack, black, "[BIN] ok b")
+                : sendFrame(fd, FrameTarget::Black, black, "[BIN] ok B");
+  }
+  if (ok && !red.empty())
+  {
+    ok = packed ? sendFrame(fd, FrameTarget::PackedRed, red, "[BIN] ok r")
+                : sendFrame(fd, FrameTarget::Red, red, "[BIN] ok R");
+  }
+  const double seconds = secondsSince(start);
+  if (ok && rawBytes > 0)
+  {
+    printf("planes: %zu bytes (%zu on the wire) in %.3f s, %.0f B/s sustained\n", rawBytes,
+           black.size() + red.size(), seconds, rawBytes / seconds);
+  }
+  if (ok && update) ok = sendFrame(fd, FrameTarget::Update, {}, "[BIN] ok U");
+  // leave binary mode even after an error so the text console is usable
+  sendFrame(fd, FrameTarget::Exit, {}, "[BIN] exit");
+  close(fd);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,274 @@
+// Controller model behind epd_sim.h; see tools/epd_sim_main.c for the runner.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "epd_sim.h"
+
+#define EPD_SIM_MAX_ARGS 8
+
+struct epd_sim {
+    epd_sim_model_t model;
+    uint16_t width;
+    uint16_t height;
+    uint16_t row_bytes;
+    uint8_t *plane[2];
+
+    epd_sim_refresh_fn on_refresh;
+    void *refresh_user;
+    epd_sim_stats_t stats;
+
+    uint8_t cmd;
+    int plane_sel;              // -1 = current command is not a plane write
+    uint8_t args[EPD_SIM_MAX_ARGS];
+    size_t arg_count;
+
+    // RAM window: x in bytes, y in rows, both inclusive
+    uint16_t win_x0, win_x1, win_y0, win_y1;
+    uint16_t cur_x, cur_y;
+    uint8_t entry_mode;         // SSD16xx 0x11
+    bool partial;               // UC8151 0x91/0x92
+};
+
+static bool is_ssd(const epd_sim_t *s){
+    return s->model == EPD_SIM_SSD16XX_3C;
+}
+
+static void reset_window(epd_sim_t *s){
+    s->win_x0 = 0;
+    s->win_x1 = (uint16_t)(s->row_bytes - 1);
+    s->win_y0 = 0;
+    s->win_y1 = (uint16_t)(s->height - 1);
+    s->cur_x = 0;
+    s->cur_y = 0;
+    s->entry_mode = 0x03;
+}
+
+static bool alloc_planes(epd_sim_t *s, uint16_t width, uint16_t height){
+    const size_t row_bytes = (width + 7u) / 8u;
+    uint8_t *p0 = malloc(row_bytes * height);
+    uint8_t *p1 = malloc(row_bytes * height);
+    if (!p0 || !p1){
+        free(p0);
+        free(p1);
+        return false;
+    }
+    free(s->plane[0]);
+    free(s->plane[1]);
+    s->plane[0] = p0;
+    s->plane[1] = p1;
+    s->width = width;
+    s->height = height;
+    s->row_bytes = (uint16_t)row_bytes;
+    memset(p0, 0xFF, row_bytes * height);
+    memset(p1, is_ssd(s) ? 0x00 : 0xFF, row_bytes * height);
+    reset_window(s);
+    return true;
+}
+
+epd_sim_t *epd_sim_create(epd_sim_model_t model, uint16_t width, uint16_t height){
+    if (width == 0 || height == 0) return NULL;
+    epd_sim_t *s = calloc(1, sizeof(*s));
+    if (!s) return NULL;
+    s->model = model;
+    s->plane_sel = -1;
+    if (!alloc_planes(s, width, height)){
+        free(s);
+        return NULL;
+    }
+    return s;
+}
+
+void epd_sim_destroy(epd_sim_t *sim){
+    if (!sim) return;
+    free(sim->plane[0]);
+    free(sim->plane[1]);
+    free(sim);
+}
+
+void epd_sim_on_refresh(epd_sim_t *sim, epd_sim_refresh_fn fn, void *user){
+    sim->on_refresh = fn;
+    sim->refresh_user = user;
+}
+
+static void refresh(epd_sim_t *s){
+    s->stats.refreshes++;
+    if (s->on_refresh) s->on_refresh(s, s->refresh_user);
+}
+
+void epd_sim_command(epd_sim_t *s, uint8_t cmd){
+    s->stats.commands++;
+    s->cmd = cmd;
+    s->arg_count = 0;
+    s->plane_sel = -1;
+
+    if (is_ssd(s)){
+        switch (cmd){
+        case 0x24: s->plane_sel = 0; break;
+        case 0x26: s->plane_sel = 1; break;
+        case 0x20: refresh(s); break;
+        case 0x12: reset_window(s); break;   // SW reset: registers only, RAM stays
+        default: break;
+        }
+        return;
+    }
+
+    switch (cmd){
+    case 0x10:
+    case 0x13:
+        s->plane_sel = cmd == 0x10 ? 0 : 1;
+        // every plane command restarts at the window origin
+        if (!s->partial){
+            s->win_x0 = 0;
+            s->win_x1 = (uint16_t)(s->row_bytes - 1);
+            s->win_y0 = 0;
+            s->win_y1 = (uint16_t)(s->height - 1);
+        }
+        s->cur_x = s->win_x0;
+        s->cur_y = s->win_y0;
+        break;
+    case 0x12: refresh(s); break;
+    case 0x91: s->partial = true; break;
+    case 0x92: s->partial = false; break;
+    default: break;
+    }
+}
+
+// Register commands take effect once all their parameters arrived.
+static void apply_args(epd_sim_t *s){
+    const uint8_t *a = s->args;
+    const size_t n = s->arg_count;
+    if (is_ssd(s)){
+        switch (s->cmd){
+        case 0x11: if (n == 1) s->entry_mode = a[0] & 0x07; break;
+        case 0x44: if (n == 2){ s->win_x0 = a[0]; s->win_x1 = a[1]; } break;
+        case 0x45:
+            if (n == 4){
+                s->win_y0 = (uint16_t)((a[0] | (a[1] << 8)) & 0x1FF);
+                s->win_y1 = (uint16_t)((a[2] | (a[3] << 8)) & 0x1FF);
+            }
+            break;
+        case 0x4E: if (n == 1) s->cur_x = a[0]; break;
+        case 0x4F: if (n == 2) s->cur_y = (uint16_t)((a[0] | (a[1] << 8)) & 0x1FF); break;
+        default: break;
+        }
+        return;
+    }
+    switch (s->cmd){
+    case 0x61:
+        if (n == 3){
+            const uint16_t w = a[0] & 0xF8;
+            const uint16_t h = (uint16_t)(((a[1] << 8) | a[2]) & 0x1FF);
+            if (w && h && (w != s->width || h != s->height)) alloc_planes(s, w, h);
+        }
+        break;
+    case 0x90:
+        if (n == 7){
+            s->win_x0 = a[0] / 8;
+            s->win_x1 = a[1] / 8;
+            s->win_y0 = (uint16_t)((a[2] << 8) | a[3]);
+            s->win_y1 = (uint16_t)((a[4] << 8) | a[5]);
+        }
+        break;
+    default: break;
+    }
+}
+
+// One step of an address counter inside [start, end]; true when it wrapped.
+static bool step(uint16_t *pos, uint16_t start, uint16_t end, bool inc){
+    if (*pos == end){
+        *pos = start;
+        return true;
+    }
+    *pos = (uint16_t)(inc ? *pos + 1 : *pos - 1);
+    return false;
+}
+
+static void put_plane_byte(epd_sim_t *s, uint8_t b){
+    if (s->cur_x < s->row_bytes && s->cur_y < s->height){
+        s->plane[s->plane_sel][(size_t)s->cur_y * s->row_bytes + s->cur_x] = b;
+        s->stats.plane_bytes++;
+    } else {
+        s->stats.dropped_bytes++;
+    }
+
+    if (is_ssd(s)){
+        const bool x_inc = s->entry_mode & 0x01;
+        const bool y_inc = s->entry_mode & 0x02;
+        if (s->entry_mode & 0x04){
+            if (step(&s->cur_y, s->win_y0, s->win_y1, y_inc)) step(&s->cur_x, s->win_x0, s->win_x1, x_inc);
+        } else {
+            if (step(&s->cur_x, s->win_x0, s->win_x1, x_inc)) step(&s->cur_y, s->win_y0, s->win_y1, y_inc);
+        }
+        return;
+    }
+    // UC8151 fills the window row by row and stops at its end
+    if (s->cur_x < s->win_x1){
+        s->cur_x++;
+    } else {
+        s->cur_x = s->win_x0;
+        s->cur_y = s->cur_y < s->win_y1 ? (uint16_t)(s->cur_y + 1) : 0xFFFF;   // 0xFFFF: past the end
+    }
+}
+
+void epd_sim_data(epd_sim_t *s, const uint8_t *buf, size_t len){
+    s->stats.data_bytes += (uint32_t)len;
+    for (size_t i = 0; i < len; i++){
+        if (s->plane_sel >= 0){
+            put_plane_byte(s, buf[i]);
+            continue;
+        }
+        if (s->arg_count < EPD_SIM_MAX_ARGS) s->args[s->arg_count++] = buf[i];
+        apply_args(s);
+    }
+}
+
+uint16_t epd_sim_width(const epd_sim_t *sim){  return sim->width; }
+uint16_t epd_sim_height(const epd_sim_t *sim){ return sim->height; }
+const epd_sim_stats_t *epd_sim_stats(const epd_sim_t *sim){ return &sim->stats; }
+
+static bool bit_at(const epd_sim_t *s, int p, uint16_t x, uint16_t y){
+    return (s->plane[p][(size_t)y * s->row_bytes + x / 8] >> (7 - x % 8)) & 1;
+}
+
+epd_sim_pixel_t epd_sim_pixel(const epd_sim_t *s, uint16_t x, uint16_t y){
+    if (x >= s->width || y >= s->height) return EPD_SIM_WHITE;
+    switch (s->model){
+    case EPD_SIM_UC8151_BW:
+        return bit_at(s, 1, x, y) ? EPD_SIM_WHITE : EPD_SIM_BLACK;
+    case EPD_SIM_UC8151_3C:
+        if (!bit_at(s, 1, x, y)) return EPD_SIM_RED;
+        return bit_at(s, 0, x, y) ? EPD_SIM_WHITE : EPD_SIM_BLACK;
+    case EPD_SIM_SSD16XX_3C:
+    default:
+        if (bit_at(s, 1, x, y)) return EPD_SIM_RED;
+        return bit_at(s, 0, x, y) ? EPD_SIM_WHITE : EPD_SIM_BLACK;
+    }
+}
+
+const char *epd_sim_image_ext(const epd_sim_t *sim){
+    return sim->model == EPD_SIM_UC8151_BW ? "pbm" : "ppm";
+}
+
+bool epd_sim_write_image(const epd_sim_t *s, const char *path){
+    FILE *f = fopen(path, "wb");
+    if (!f) return false;
+    if (s->model == EPD_SIM_UC8151_BW){
+        // P4: 1 = black, rows padded to a byte like the RAM itself
+        fprintf(f, "P4\n%u %u\n", s->width, s->height);
+        for (uint16_t y = 0; y < s->height; y++){
+            for (uint16_t xb = 0; xb < s->row_bytes; xb++){
+                fputc((uint8_t)~s->plane[1][(size_t)y * s->row_bytes + xb], f);
+            }
+        }
+    } else {
+        static const uint8_t rgb[3][3] = { {255, 255, 255}, {0, 0, 0}, {200, 0, 0} };
+        fprintf(f, "P6\n%u %u\n255\n", s->width, s->height);
+        for (uint16_t y = 0; y < s->height; y++){
+            for (uint16_t x = 0; x < s->width; x++){
+                fwrite(rgb[epd_sim_pixel(s, x, y)], 1, 3, f);
+            }
+        }
+    }
+    return fclose(f) == 0;
+}
@@ -0,0 +1,64 @@
+// Controller model for off-target runs: consumes the command/data byte
+// stream a driver sends over SPI and keeps the panel RAM it would hold.
+//
+// Modelled: SSD16xx planes 0x24/0x26 with the RAM window (0x44/0x45), the
+// address counters (0x4E/0x4F) and data entry mode (0x11); UC8151 planes
+// 0x10/0x13 with resolution (0x61) and the partial window (0x90/0x91/0x92).
+// Refresh triggers (0x20 / 0x12) call the refresh hook. Other commands are
+// counted and their data ignored.
+
+#ifndef EPD_SIM_H
+#define EPD_SIM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    EPD_SIM_UC8151_BW,   // epd.c: 0x13 is the image, 0x10 the previous one
+    EPD_SIM_UC8151_3C,   // GxEPD2_213c: 0x10 black, 0x13 red (0 = inked)
+    EPD_SIM_SSD16XX_3C   // 0x24 black (0 = black), 0x26 red (1 = red)
+} epd_sim_model_t;
+
+typedef enum {
+    EPD_SIM_WHITE,
+    EPD_SIM_BLACK,
+    EPD_SIM_RED
+} epd_sim_pixel_t;
+
+typedef struct epd_sim epd_sim_t;
+typedef void (*epd_sim_refresh_fn)(const epd_sim_t *sim, void *user);
+
+typedef struct {
+    uint32_t commands;
+    uint32_t data_bytes;
+    uint32_t plane_bytes;   // data bytes that landed inside a plane
+    uint32_t dropped_bytes; // plane bytes outside RAM or the window
+    uint32_t refreshes;
+} epd_sim_stats_t;
+
+epd_sim_t *epd_sim_create(epd_sim_model_t model, uint16_t width, uint16_t height);
+void epd_sim_destroy(epd_sim_t *sim);
+void epd_sim_on_refresh(epd_sim_t *sim, epd_sim_refresh_fn fn, void *user);
+
+void epd_sim_command(epd_sim_t *sim, uint8_t cmd);
+void epd_sim_data(epd_sim_t *sim, const uint8_t *buf, size_t len);
+
+uint16_t epd_sim_width(const epd_sim_t *sim);
+uint16_t epd_sim_height(const epd_sim_t *sim);
+epd_sim_pixel_t epd_sim_pixel(const epd_sim_t *sim, uint16_t x, uint16_t y);
+const epd_sim_stats_t *epd_sim_stats(const epd_sim_t *sim);
+
+// PBM for the black/white model, PPM for the tri-colour ones
+bool epd_sim_write_image(const epd_sim_t *sim, const char *path);
+const char *epd_sim_image_ext(const epd_sim_t *sim);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
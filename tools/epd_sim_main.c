@@ -0,0 +1,204 @@
+// Off-target runner for the controller model in epd_sim.h.
+//
+// Build (from the repo root):
+//   cc -std=c99 -O2 -DEPD_HOST_BUILD -Ilib/pio_ws2812_E-ink -Itools
+//      tools/epd_sim_main.c tools/epd_sim.c
+//      lib/pio_ws2812_E-ink/epd.c lib/pio_ws2812_E-ink/epd_spi_host.c -o epd_sim
+// Add -DEPD_HAL_RECORD and lib/pio_ws2812_E-ink/epd_hal_record.c for
+// --record.
+//
+// Usage:
+//   epd_sim --demo bands [--out PREFIX] [--record CSV]
+//       runs the lib's epd_init_full/epd_frame_push/epd_update sequence with
+//       the make_test_bands() pattern through epd_spi_host.c; --record logs
+//       every CS transaction and BUSY wait of the lib (epd_hal.h)
+//   epd_sim --trace FILE [--model uc8151-3c|uc8151-bw|ssd16xx-3c]
+//           [--size WxH] [--out PREFIX]
+//       replays "[TRC] C xx" / "[TRC] D xx .." lines, as logged by the
+//       firmware built with EPD_TRACE_RAW=1; other lines are skipped
+//
+// Every refresh trigger writes PREFIX-NNN.pbm/ppm; without one the final
+// RAM is written to PREFIX-ram.pbm/ppm.
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "epd.h"
+#include "epd_spi.h"
+#include "epd_sim.h"
+#ifdef EPD_HAL_RECORD
+#include "epd_hal.h"
+#endif
+
+static const char *out_prefix = "epd_sim";
+#ifdef EPD_HAL_RECORD
+static const char *record_path = NULL;
+#endif
+
+static double now_seconds(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void write_snapshot(const epd_sim_t *sim, const char *tag){
+    char path[512];
+    snprintf(path, sizeof(path), "%s-%s.%s", out_prefix, tag, epd_sim_image_ext(sim));
+    if (epd_sim_write_image(sim, path)) printf("[SIM] wrote %s\n", path);
+    else perror(path);
+}
+
+static void on_refresh(const epd_sim_t *sim, void *user){
+    (void)user;
+    char tag[16];
+    snprintf(tag, sizeof(tag), "%03u", (unsigned)epd_sim_stats(sim)->refreshes);
+    write_snapshot(sim, tag);
+}
+
+static void spi_sink(bool dc, const uint8_t *buf, size_t len, void *user){
+    epd_sim_t *sim = user;
+    if (dc){
+        epd_sim_data(sim, buf, len);
+        return;
+    }
+    for (size_t i = 0; i < len; i++) epd_sim_command(sim, buf[i]);
+}
+
+// ws2812.c make_test_bands(): top half black
+static int run_demo_bands(epd_sim_t *sim){
+    static uint8_t fb[EPD_ARRAY];
+    const int stride = EPD_WIDTH / 8;
+    for (int y = 0; y < EPD_HEIGHT; y++){
+        memset(&fb[y * stride], (y < EPD_HEIGHT / 2) ? 0x00 : 0xFF, (size_t)stride);
+    }
+    epd_spi_host_set_sink(spi_sink, sim);
+    epd_spi_init();
+#ifdef EPD_HAL_RECORD
+    FILE *rec = NULL;
+    if (record_path){
+        rec = fopen(record_path, "w");
+        if (!rec){
+            perror(record_path);
+            return 1;
+        }
+        epd_hal_record_start(rec);
+    }
+#endif
+    bool ok = epd_init_full();
+    if (ok){
+        epd_frame_push(fb);
+        ok = epd_update();
+    }
+#ifdef EPD_HAL_RECORD
+    if (rec){
+        epd_hal_record_stop();
+        fclose(rec);
+        printf("[SIM] recorded %s\n", record_path);
+    }
+#endif
+    return ok ? 0 : 1;
+}
+
+// Returns -1 for a line that is not a trace record.
+static int replay_line(epd_sim_t *sim, char *line){
+    char *p = strstr(line, "[TRC]");
+    if (!p) return -1;
+    p += 5;
+    while (*p == ' ') p++;
+    const char kind = *p++;
+    if (kind != 'C' && kind != 'D') return -1;
+    uint8_t bytes[64];
+    size_t n = 0;
+    for (;;){
+        char *end;
+        const unsigned long v = strtoul(p, &end, 16);
+        if (end == p || n == sizeof(bytes)) break;
+        bytes[n++] = (uint8_t)v;
+        p = end;
+    }
+    if (kind == 'C'){
+        for (size_t i = 0; i < n; i++) epd_sim_command(sim, bytes[i]);
+    } else {
+        epd_sim_data(sim, bytes, n);
+    }
+    return 0;
+}
+
+static int run_trace(epd_sim_t *sim, const char *path){
+    FILE *f = fopen(path, "r");
+    if (!f){
+        perror(path);
+        return 1;
+    }
+    char line[512];
+    while (fgets(line, sizeof(line), f)) replay_line(sim, line);
+    fclose(f);
+    return 0;
+}
+
+static int parse_model(const char *name, epd_sim_model_t *out){
+    if (strcmp(name, "uc8151-bw") == 0) *out = EPD_SIM_UC8151_BW;
+    else if (strcmp(name, "uc8151-3c") == 0) *out = EPD_SIM_UC8151_3C;
+    else if (strcmp(name, "ssd16xx-3c") == 0) *out = EPD_SIM_SSD16XX_3C;
+    else return -1;
+    return 0;
+}
+
+static void usage(void){
+    fprintf(stderr,
+            "usage: epd_sim --demo bands [--out PREFIX] [--record CSV]\n"
+            "       epd_sim --trace FILE [--model uc8151-3c|uc8151-bw|ssd16xx-3c] [--size WxH] [--out PREFIX]\n");
+}
+
+int main(int argc, char **argv){
+    const char *demo = NULL;
+    const char *trace = NULL;
+    epd_sim_model_t model = EPD_SIM_UC8151_3C;
+    unsigned width = 104, height = 212;   // GxEPD2_213c
+
+    for (int i = 1; i < argc; i++){
+        if (strcmp(argv[i], "--demo") == 0 && i + 1 < argc) demo = argv[++i];
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) trace = argv[++i];
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) out_prefix = argv[++i];
+#ifdef EPD_HAL_RECORD
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) record_path = argv[++i];
+#endif
+        else if (strcmp(argv[i], "--model") == 0 && i + 1 < argc){
+            if (parse_model(argv[++i], &model) != 0){ usage(); return 2; }
+        }
+        else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc){
+            if (sscanf(argv[++i], "%ux%u", &width, &height) != 2){ usage(); return 2; }
+        }
+        else { usage(); return 2; }
+    }
+    if ((demo == NULL) == (trace == NULL)){ usage(); return 2; }
+    if (demo && strcmp(demo, "bands") != 0){ usage(); return 2; }
+    if (demo){
+        model = EPD_SIM_UC8151_BW;
+        width = EPD_WIDTH;
+        height = EPD_HEIGHT;
+    }
+
+    epd_sim_t *sim = epd_sim_create(model, (uint16_t)width, (uint16_t)height);
+    if (!sim){
+        fprintf(stderr, "cannot create a %ux%u panel\n", width, height);
+        return 1;
+    }
+    epd_sim_on_refresh(sim, on_refresh, NULL);
+
+    const double start = now_seconds();
+    const int rc = demo ? run_demo_bands(sim) : run_trace(sim, trace);
+    const double seconds = now_seconds() - start;
+
+    const epd_sim_stats_t *st = epd_sim_stats(sim);
+    if (st->refreshes == 0) write_snapshot(sim, "ram");
+    printf("[SIM] %ux%u: %u commands, %u data bytes (%u in planes, %u dropped), %u refreshes\n",
+           epd_sim_width(sim), epd_sim_height(sim), st->commands, st->data_bytes, st->plane_bytes,
+           st->dropped_bytes, st->refreshes);
+    printf("[SIM] %.3f s, %.0f commands/s\n", seconds, seconds > 0 ? st->commands / seconds : 0.0);
+    epd_sim_destroy(sim);
+    return rc;
+}
@@ -0,0 +1,656 @@
+// Host benchmark for the glyph cache in include/glyph_cache.h against the
+// per-pixel text path it replaces, and for packed fonts (glyph_codec.h)
+// against the GFXfonts they were made from.
+//
+// Build (Linux/macOS):
+//   c++ -std=c++17 -O2 -Iinclude -Ilib/pio_ws2812_E-ink/generated tools/epd_text.cpp -o epd_text
+//
+// Usage:
+//   epd_text [--iterations N]
+//
+// The per-pixel path is Adafruit_GFX::write()/drawChar() as the library
+// implements them, ending in a virtual drawPixel() that goes through the
+// raster's per-rotation pixel kernel, i.e. what PlaneDisplay did for text
+// before. The cached path mirrors PlaneDisplay::write(). Both draw the
+// status lines of renderDiagnostics() in every rotation with the 5x8 Font[]
+// of TextFonts.h, FreeMonoOblique12pt7b and the FreeMonoOblique12pt_sub
+// subset, then random text at random positions, colours and clipping, once
+// with a starved budget so the LRU keeps evicting and once with no slot at
+// all, so every glyph is unpacked and blitted. The packed versions of
+// the two 12pt fonts go through the same runs against the per-pixel path
+// of their GFXfont, every packed glyph is decoded and compared, and the
+// flash each form takes is reported along with render times from a cold
+// cache (every glyph decoded) and a warm one. The planes must come out
+// bit-identical; exits non-zero on any mismatch, or if a packed font is not
+// smaller than its GFXfont.
+
+#define TFT_ENABLE_FONTS
+#include "ST7735_TFT.h"
+#include "FreeMonoOblique12pt7b.h"
+#include "FreeMonoOblique12pt_sub.h"
+#include "TextFonts.h"
+#include "FreeMonoOblique12pt7bPacked.h"
+#include "FreeMonoOblique12pt_subPacked.h"
+
+#include "font_index.h"
+#include "glyph_cache.h"
+#include "glyph_codec.h"
+#include "panel_traits.h"
+#include "plane_raster.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+using Panel = Panel213c;
+using Raster = PlaneRaster<Panel>;
+
+static constexpr uint16_t WHITE = 0xFFFF;
+static constexpr uint16_t BLACK = 0x0000;
+static constexpr uint16_t RED = 0xF800;
+
+struct BenchFont
+{
+  const char *name;
+  const GFXfont *gfx;  // nullptr: the 5x8 column font
+  const char *charset;
+  const SubsetIndex *index;
+  const PackedFont *packed;  // drawn instead of gfx by the cached path
+};
+
+static const char CLASSIC_FIRST = 0x20;
+static const uint16_t CLASSIC_COUNT = sizeof(Font) / 5;
+
+// Adafruit_GFX text state and write(), shared by both paths.
+class TextState
+{
+public:
+  void setRotation(uint8_t r)
+  {
+    rotation = r & 3;
+    width = Panel::widthFor(rotation);
+  }
+
+  void setFont(const BenchFont &f)
+  {
+    font = &f;
+  }
+
+  void setCursor(int16_t x, int16_t y)
+  {
+    cursorX = x;
+    cursorY = y;
+  }
+
+  void setTextColor(uint16_t c, uint16_t bg)
+  {
+    color = c;
+    background = bg;
+  }
+
+  void print(const char *s)
+  {
+    for (; *s; ++s) write(static_cast<uint8_t>(*s));
+  }
+
+  Raster raster;
+
+protected:
+  virtual ~TextState() = default;
+  virtual void write(uint8_t c) = 0;
+
+  void newline()
+  {
+    cursorX = 0;
+    cursorY += font->gfx ? font->gfx->yAdvance : 8;
+  }
+
+  static int16_t gfxIndex(const GFXfont &f, uint8_t c)
+  {
+    if (f.subset)
+    {
+      const char *hit = c ? strchr(f.subset, c) : nullptr;
+      return hit ? static_cast<int16_t>(hit - f.subset) : -1;
+    }
+    return (c >= f.first && c <= f.last) ? static_cast<int16_t>(c - f.first) : -1;
+  }
+
+  const BenchFont *font = nullptr;
+  uint8_t rotation = 0;
+  int16_t width = Panel::width;
+  int16_t cursorX = 0;
+  int16_t cursorY = 0;
+  uint16_t color = BLACK;
+  uint16_t background = BLACK;
+};
+
+class PixelText : public TextState
+{
+public:
+  void setRotation(uint8_t r)
+  {
+    TextState::setRotation(r);
+    switch (rotation)
+    {
+      case 1:
+        _pixel = &Raster::pixelAt<1>;
+        break;
+      case 2:
+        _pixel = &Raster::pixelAt<2>;
+        break;
+      case 3:
+        _pixel = &Raster::pixelAt<3>;
+        break;
+      default:
+        _pixel = &Raster::pixelAt<0>;
+        break;
+    }
+  }
+
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t c)
+  {
+    (raster.*_pixel)(x, y, planeInk(c));
+  }
+
+protected:
+  void write(uint8_t c) override
+  {
+    if (c == '\n')
+    {
+      newline();
+      return;
+    }
+    if (c == '\r') return;
+    if (!font->gfx)
+    {
+      if (cursorX + 6 > width) newline();
+      drawClassic(cursorX, cursorY, c);
+      cursorX += 6;
+      return;
+    }
+    const int16_t index = gfxIndex(*font->gfx, c);
+    if (index < 0) return;
+    const GFXglyph &g = font->gfx->glyph[index];
+    if (g.width > 0 && g.height > 0)
+    {
+      if (cursorX + g.xOffset + g.width > width) newline();
+      drawGfx(cursorX, cursorY, g);
+    }
+    cursorX += g.xAdvance;
+  }
+
+private:
+  void drawClassic(int16_t x, int16_t y, uint8_t c)
+  {
+    const uint8_t *bits = reinterpret_cast<const uint8_t *>(Font) + (c - CLASSIC_FIRST) * 5;
+    for (int8_t i = 0; i < 5; ++i)
+    {
+      uint8_t line = bits[i];
+      for (int8_t j = 0; j < 8; ++j, line >>= 1)
+      {
+        if (line & 1) drawPixel(x + i, y + j, color);
+        else if (background != color) drawPixel(x + i, y + j, background);
+      }
+    }
+    if (background != color)
+    {
+      for (int8_t j = 0; j < 8; ++j) drawPixel(x + 5, y + j, background);
+    }
+  }
+
+  void drawGfx(int16_t x, int16_t y, const GFXglyph &g)
+  {
+    const uint8_t *bitmap = font->gfx->bitmap;
+    uint16_t bo = g.bitmapOffset;
+    uint8_t bits = 0, bit = 0;
+    for (uint8_t yy = 0; yy < g.height; ++yy)
+    {
+      for (uint8_t xx = 0; xx < g.width; ++xx)
+      {
+        if (!(bit++ & 7)) bits = bitmap[bo++];
+        if (bits & 0x80) drawPixel(x + g.xOffset + xx, y + g.yOffset + yy, color);
+        bits <<= 1;
+      }
+    }
+  }
+
+  void (Raster::*_pixel)(int16_t, int16_t, PlaneInk) = &Raster::pixelAt<0>;
+};
+
+// PlaneDisplay::write()
+template <size_t Budget>
+class CachedText : public TextState
+{
+public:
+  typename GlyphCache<Panel, Budget>::Stats stats() const
+  {
+    return _glyphs.stats();
+  }
+
+  void flush()
+  {
+    _glyphs.flush();
+  }
+
+protected:
+  void write(uint8_t c) override
+  {
+    if (c == '\n')
+    {
+      newline();
+      return;
+    }
+    if (c == '\r') return;
+    GlyphFace face = GlyphFace::columns(reinterpret_cast<const uint8_t *>(Font), CLASSIC_FIRST, CLASSIC_COUNT);
+    if (font->packed)
+    {
+      face = font->index ? GlyphFace::packed(*font->packed, *font->index) : GlyphFace::packed(*font->packed);
+    }
+    else if (font->gfx)
+    {
+      face = font->index ? GlyphFace::gfx(*font->gfx, *font->index) : GlyphFace::gfx(*font->gfx);
+    }
+    GlyphSource glyph;
+    if (!face.glyph(c, glyph)) return;
+    if (font->gfx)
+    {
+      if (glyph.width > 0 && glyph.height > 0)
+      {
+        if (cursorX + glyph.xOffset + glyph.width > width) newline();
+        drawGlyph(c, face, glyph);
+      }
+    }
+    else
+    {
+      if (cursorX + 6 > width) newline();
+      if (background != color) raster.fillRect(rotation, cursorX, cursorY, 6, 8, planeInk(background));
+      drawGlyph(c, face, glyph);
+    }
+    cursorX += glyph.xAdvance;
+  }
+
+private:
+  // A glyph without a slot is unpacked and blitted, as in PlaneDisplay.
+  void drawGlyph(uint8_t c, const GlyphFace &face, const GlyphSource &glyph)
+  {
+    _glyphs.bind(face);
+    if (_glyphs.draw(raster, rotation, c, glyph, cursorX, cursorY, planeInk(color))) return;
+    uint8_t bitmap[128];
+    if (!unpackGlyph(glyph, bitmap, sizeof(bitmap)))
+    {
+      fprintf(stderr, "glyph 0x%02X did not fit a slot or the bitmap\n", c);
+      exit(1);
+    }
+    raster.blit(rotation, cursorX + glyph.xOffset, cursorY + glyph.yOffset, bitmap, glyph.width, glyph.height,
+                planeInk(color));
+  }
+
+  GlyphCache<Panel, Budget> _glyphs;
+};
+
+static const BenchFont FONTS[] = {
+    {"5x8 Font[]", nullptr, nullptr, nullptr, nullptr},
+    {"FreeMonoOblique12pt7b", &FreeMonoOblique12pt7b, nullptr, nullptr, nullptr},
+    {"FreeMonoOblique12pt_sub", &FreeMonoOblique12pt_sub, FreeMonoOblique12pt_subChars,
+     &FreeMonoOblique12pt_subIndex, nullptr},
+    {"FreeMonoOblique12pt7bPacked", &FreeMonoOblique12pt7b, nullptr, nullptr, &FreeMonoOblique12pt7bPacked},
+    {"FreeMonoOblique12pt_subPacked", &FreeMonoOblique12pt_sub, FreeMonoOblique12pt_subPackedChars,
+     &FreeMonoOblique12pt_subPackedIndex, &FreeMonoOblique12pt_subPacked},
+};
+
+// A packed font, the entry of its GFXfont in FONTS and what each takes in
+// flash: bitmap bytes against run bytes plus the two codes. The glyph
+// tables are the same size in both.
+struct PackedBench
+{
+  const BenchFont &raw;
+  const BenchFont &packed;
+  size_t rawBytes;
+  size_t packedBytes;
+};
+
+static const PackedBench PACKED[] = {
+    {FONTS[1], FONTS[3], sizeof(FreeMonoOblique12pt7bBitmaps),
+     sizeof(FreeMonoOblique12pt7bPackedBitmaps) + 2 * sizeof(RunCode)},
+    {FONTS[2], FONTS[4], sizeof(FreeMonoOblique12pt_subBitmaps),
+     sizeof(FreeMonoOblique12pt_subPackedBitmaps) + 2 * sizeof(RunCode)},
+};
+
+// The index is built by the compiler.
+static_assert(FreeMonoOblique12pt_subIndex[' '] == 0, "space is the first subset glyph");
+static_assert(FreeMonoOblique12pt_subIndex['a'] == 19, "'a' is the last subset glyph");
+static_assert(FreeMonoOblique12pt_subIndex['x'] == -1, "'x' is not in the subset");
+
+static bool glyphBit(const GFXfont &font, const GFXglyph &g, uint16_t i)
+{
+  return font.bitmap[g.bitmapOffset + i / 8] & (0x80 >> (i % 8));
+}
+
+// Every character of the subset must be the glyph of the full font, and
+// every other character must have no entry.
+static bool checkSubset(const GFXfont &sub, const SubsetIndex &index, const GFXfont &full, size_t &checked)
+{
+  bool ok = true;
+  for (uint16_t c = 0; c < 256; ++c)
+  {
+    const int16_t slot = index[static_cast<uint8_t>(c)];
+    const char *hit = c ? strchr(sub.subset, c) : nullptr;
+    if (slot != (hit ? hit - sub.subset : -1))
+    {
+      printf("subset index: 0x%02X maps to %d, the subset string says %d\n", c, slot,
+             hit ? static_cast<int>(hit - sub.subset) : -1);
+      ok = false;
+    }
+    if (slot < 0) continue;
+    ++checked;
+    const GFXglyph &s = sub.glyph[slot];
+    const GFXglyph &f = full.glyph[c - full.first];
+    if (s.width != f.width || s.height != f.height || s.xAdvance != f.xAdvance || s.xOffset != f.xOffset ||
+        s.yOffset != f.yOffset)
+    {
+      printf("subset glyph '%c': metrics %ux%u %+d%+d adv %u, full font %ux%u %+d%+d adv %u\n", c, s.width, s.height,
+             s.xOffset, s.yOffset, s.xAdvance, f.width, f.height, f.xOffset, f.yOffset, f.xAdvance);
+      ok = false;
+      continue;
+    }
+    for (uint16_t i = 0; i < s.width * s.height; ++i)
+    {
+      if (glyphBit(sub, s, i) != glyphBit(full, f, i))
+      {
+        printf("subset glyph '%c': pixel %u,%u differs from the full font\n", c, i % s.width, i / s.width);
+        ok = false;
+      }
+    }
+  }
+  return ok;
+}
+
+// Every packed glyph must decode to its GFXfont glyph, metrics included.
+static bool checkPacked(const GFXfont &raw, const PackedFont &packed, size_t &checked)
+{
+  const size_t count = raw.subset ? strlen(raw.subset) : static_cast<size_t>(raw.last - raw.first + 1);
+  bool ok = (packed.subset == nullptr) == (raw.subset == nullptr) && packed.first == raw.first &&
+            packed.last == raw.last && packed.yAdvance == raw.yAdvance;
+  if (!ok) printf("packed font: header differs from the GFXfont\n");
+  for (size_t i = 0; i < count; ++i, ++checked)
+  {
+    const GFXglyph &r = raw.glyph[i];
+    const PackedGlyph &p = packed.glyph[i];
+    if (r.width != p.width || r.height != p.height || r.xAdvance != p.xAdvance || r.xOffset != p.xOffset ||
+        r.yOffset != p.yOffset)
+    {
+      printf("packed glyph %zu: metrics differ\n", i);
+      ok = false;
+      continue;
+    }
+    RunDecoder runs(packed, p);
+    for (uint16_t b = 0; b < r.width * r.height; ++b)
+    {
+      if (runs.next() != glyphBit(raw, r, b))
+      {
+        printf("packed glyph %zu: pixel %u,%u decodes wrong\n", i, b % r.width, b / r.width);
+        ok = false;
+        break;
+      }
+    }
+  }
+  return ok;
+}
+
+struct Line
+{
+  int16_t x;
+  int16_t y;
+  std::string text;
+};
+
+// The text of renderDiagnostics(); subset fonts get readings in their
+// character set instead.
+static std::vector<Line> statusLines(const BenchFont &font, uint8_t rotation)
+{
+  const int16_t w = Panel::widthFor(rotation);
+  const int16_t h = Panel::heightFor(rotation);
+  char buf[64];
+  std::vector<Line> lines;
+  if (font.charset)
+  {
+    lines.push_back(Line{4, 20, "12.5% +0.3"});
+    lines.push_back(Line{4, 44, "Ph 7/20"});
+    lines.push_back(Line{4, static_cast<int16_t>(h - 30), "Ca -4.25"});
+    lines.push_back(Line{4, static_cast<int16_t>(h - 6), "99.9%"});
+    return lines;
+  }
+  const bool gfx = font.gfx != nullptr;
+  lines.push_back(Line{10, static_cast<int16_t>(gfx ? 20 : 16), "Diag GxEPD2_213c"});
+  snprintf(buf, sizeof(buf), "w=%d h=%d", w, h);
+  lines.push_back(Line{10, static_cast<int16_t>(gfx ? 44 : 36), buf});
+  snprintf(buf, sizeof(buf), "rot=%u busy=0", rotation);
+  lines.push_back(Line{10, static_cast<int16_t>(h - (gfx ? 30 : 24)), buf});
+  lines.push_back(Line{10, static_cast<int16_t>(h - (gfx ? 6 : 10)), "off=0,0 base=0,0"});
+  return lines;
+}
+
+template <typename Text>
+static void drawLines(Text &text, const std::vector<Line> &lines)
+{
+  for (const Line &line : lines)
+  {
+    text.setCursor(line.x, line.y);
+    text.print(line.text.c_str());
+  }
+}
+
+static size_t lineGlyphs(const std::vector<Line> &lines)
+{
+  size_t n = 0;
+  for (const Line &line : lines) n += line.text.size();
+  return n;
+}
+
+static bool samePlanes(const Raster &a, const Raster &b)
+{
+  return memcmp(a.black(), b.black(), Raster::PLANE_BYTES) == 0 && memcmp(a.red(), b.red(), Raster::PLANE_BYTES) == 0;
+}
+
+static uint32_t nextRandom(uint32_t &seed)
+{
+  seed = seed * 1103515245u + 12345u;
+  return seed >> 8;
+}
+
+// Random lines at random positions (partly off-panel), colours and, for
+// the 5x8 font, opaque backgrounds.
+template <size_t Budget>
+static bool randomText(const BenchFont &font, uint32_t &seed, size_t &glyphs, CachedText<Budget> &cached)
+{
+  static PixelText pixel;
+  static const uint16_t COLORS[] = {BLACK, RED, WHITE};
+  std::string charset;
+  if (font.charset) charset = font.charset;
+  else for (int c = 0x20; c < 0x7F; ++c) charset += static_cast<char>(c);
+  bool ok = true;
+  for (uint8_t rotation = 0; rotation < 4; ++rotation)
+  {
+    pixel.setRotation(rotation);
+    cached.setRotation(rotation);
+    pixel.setFont(font);
+    cached.setFont(font);
+    pixel.raster.fill(planeInk(WHITE));
+    cached.raster.fill(planeInk(WHITE));
+    for (int round = 0; round < 200; ++round)
+    {
+      const int16_t x = static_cast<int16_t>(static_cast<int32_t>(nextRandom(seed) % (Panel::widthFor(rotation) + 40)) - 30);
+      const int16_t y = static_cast<int16_t>(static_cast<int32_t>(nextRandom(seed) % (Panel::heightFor(rotation) + 40)) - 20);
+      const uint16_t color = COLORS[nextRandom(seed) % 3];
+      const uint16_t background = (!font.gfx && nextRandom(seed) % 4 == 0) ? COLORS[nextRandom(seed) % 3] : color;
+      std::string text;
+      const size_t length = 1 + nextRandom(seed) % 12;
+      for (size_t i = 0; i < length; ++i)
+      {
+        text += nextRandom(seed) % 16 == 0 ? '\n' : charset[nextRandom(seed) % charset.size()];
+      }
+      pixel.setTextColor(color, background);
+      cached.setTextColor(color, background);
+      pixel.setCursor(x, y);
+      cached.setCursor(x, y);
+      pixel.print(text.c_str());
+      cached.print(text.c_str());
+      glyphs += length;
+    }
+    ok = ok && samePlanes(pixel.raster, cached.raster);
+  }
+  return ok;
+}
+
+template <typename Body>
+static double bestOf(int iterations, Body body)
+{
+  double best = 0;
+  for (int round = 0; round < 5; ++round)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) body();
+    const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    if (round == 0 || us < best) best = us;
+  }
+  return best / iterations;
+}
+
+template <size_t Budget>
+static bool statusText(const BenchFont &font, PixelText &pixel, CachedText<Budget> &cached, int iterations)
+{
+  bool allOk = true;
+  for (uint8_t rotation = 0; rotation < 4; ++rotation)
+  {
+    const std::vector<Line> lines = statusLines(font, rotation);
+    pixel.setRotation(rotation);
+    cached.setRotation(rotation);
+    pixel.setFont(font);
+    cached.setFont(font);
+    pixel.setTextColor(BLACK, BLACK);
+    cached.setTextColor(BLACK, BLACK);
+    pixel.raster.fill(planeInk(WHITE));
+    cached.raster.fill(planeInk(WHITE));
+    const double pixelUs = bestOf(iterations, [&]() { drawLines(pixel, lines); });
+    const double cachedUs = bestOf(iterations, [&]() { drawLines(cached, lines); });
+    const bool ok = samePlanes(pixel.raster, cached.raster);
+    allOk = allOk && ok;
+    const auto st = cached.stats();
+    printf("%-29s rot %u  %2zu glyphs  per-pixel %7.2f us  cached %6.2f us  x%5.1f  %3u slots of %2u B  %s\n",
+           font.name, rotation, lineGlyphs(lines), pixelUs, cachedUs, pixelUs / cachedUs, st.slots, st.slotBytes,
+           ok ? "identical" : "MISMATCH");
+  }
+  return allOk;
+}
+
+int main(int argc, char **argv)
+{
+  int iterations = 2000;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (std::string(argv[i]) == "--iterations" && i + 1 < argc)
+    {
+      iterations = atoi(argv[++i]);
+    }
+    else
+    {
+      fprintf(stderr, "usage: epd_text [--iterations N]\n");
+      return 2;
+    }
+  }
+  if (iterations < 1) iterations = 1;
+
+  // 2048 B is PlaneDisplay's default, sized for the 5x8 font; the 12pt
+  // fonts need about four times that to hold a screen of status text.
+  static PixelText pixel;
+  static CachedText<2048> small;
+  static CachedText<8192> cached;
+  bool allOk = true;
+  for (const BenchFont &font : FONTS)
+  {
+    const bool ok = font.gfx ? statusText(font, pixel, cached, iterations) : statusText(font, pixel, small, iterations);
+    allOk = allOk && ok;
+  }
+
+  // Cold: the cache is flushed before each frame, so every glyph of it is
+  // decoded (or, for the GFXfont, unpacked from its bitstream) once.
+  printf("\n");
+  for (const PackedBench &pb : PACKED)
+  {
+    size_t checked = 0;
+    const bool ok = checkPacked(*pb.raw.gfx, *pb.packed.packed, checked);
+    allOk = allOk && ok;
+    const std::vector<Line> lines = statusLines(pb.raw, 0);
+    cached.setRotation(0);
+    cached.setTextColor(BLACK, BLACK);
+    double us[2][2];
+    for (int form = 0; form < 2; ++form)
+    {
+      cached.setFont(form ? pb.packed : pb.raw);
+      us[form][0] = bestOf(iterations, [&]()
+      {
+        cached.flush();
+        drawLines(cached, lines);
+      });
+      us[form][1] = bestOf(iterations, [&]() { drawLines(cached, lines); });
+    }
+    // A font is only worth packing if the runs and codes undercut its bitmap
+    const bool pays = pb.packedBytes < pb.rawBytes;
+    allOk = allOk && pays;
+    printf("%-29s flash %4zu B -> %4zu B (%3.0f%%, %4ld B saved)  cold %6.2f -> %6.2f us  warm %5.2f -> %5.2f us  "
+           "%zu glyphs %s\n",
+           pb.packed.name, pb.rawBytes, pb.packedBytes, 100.0 * pb.packedBytes / pb.rawBytes,
+           static_cast<long>(pb.rawBytes) - static_cast<long>(pb.packedBytes), us[0][0], us[1][0], us[0][1], us[1][1],
+           checked, !ok ? "MISDECODE" : pays ? "decode" : "decode, NOT SMALLER");
+  }
+  printf("\n");
+
+  uint32_t seed = 4242;
+  size_t glyphs = 0;
+  bool randomOk = true;
+  static CachedText<384> starved;
+  static CachedText<16> slotless;
+  for (const BenchFont &font : FONTS)
+  {
+    const bool ok = randomText(font, seed, glyphs, cached) && randomText(font, seed, glyphs, starved) &&
+                    randomText(font, seed, glyphs, slotless);
+    if (!ok) printf("random text %s MISMATCH\n", font.name);
+    randomOk = randomOk && ok;
+  }
+  allOk = allOk && randomOk;
+  const auto st = starved.stats();
+  printf("random text: %zu glyphs, 8192 B, 384 B (%u slots, %.0f%% hits) and 16 B (no slot, blitted) budgets, %s\n",
+         glyphs, st.slots, 100.0 * st.hits / (st.hits + st.misses), randomOk ? "all identical" : "MISMATCH");
+
+  size_t subsetChecked = 0;
+  const bool subsetOk =
+      checkSubset(FreeMonoOblique12pt_sub, FreeMonoOblique12pt_subIndex, FreeMonoOblique12pt7b, subsetChecked);
+  allOk = allOk && subsetOk;
+  const char *probe = "12.5% +0.3 Ph 7/20 Ca -4.25 99.9% xyz";
+  const size_t probeLength = strlen(probe);
+  volatile int32_t sink = 0;
+  const double searchUs = bestOf(iterations, [&]()
+  {
+    int32_t sum = 0;
+    for (size_t i = 0; i < probeLength; ++i)
+    {
+      const char *hit = strchr(FreeMonoOblique12pt_sub.subset, probe[i]);
+      sum += hit ? static_cast<int32_t>(hit - FreeMonoOblique12pt_sub.subset) : -1;
+    }
+    sink = sink + sum;
+  });
+  const double indexUs = bestOf(iterations, [&]()
+  {
+    int32_t sum = 0;
+    for (size_t i = 0; i < probeLength; ++i) sum += FreeMonoOblique12pt_subIndex[static_cast<uint8_t>(probe[i])];
+    sink = sink + sum;
+  });
+  printf("subset index: %zu glyphs of FreeMonoOblique12pt_sub %s FreeMonoOblique12pt7b; lookup %.1f ns by search, "
+         "%.1f ns by index\n",
+         subsetChecked, subsetOk ? "match" : "DIFFER FROM", 1000.0 * searchUs / probeLength,
+         1000.0 * indexUs / probeLength);
+  return allOk ? 0 : 1;
+}
@@ -0,0 +1,356 @@
+#pragma once
+
+// Reads a GFXfont header as fontconvert (Adafruit) or ST7735_TFT.h subset
+// fonts write them: a <name>Bitmaps[] byte array, a <name>Glyphs[] array of
+// { offset, width, height, xAdvance, xOffset, yOffset } and the GFXfont
+// { bitmap, glyph, first, last, yAdvance [, subset] }, the subset given as
+// a string literal or a macro #defined in the same file. Comments are
+// skipped, so the '// 0x41 'A'' annotations don't matter. Host tools only.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+struct GfxGlyphSource
+{
+  uint16_t bitmapOffset;
+  uint8_t width;
+  uint8_t height;
+  uint8_t xAdvance;
+  int8_t xOffset;
+  int8_t yOffset;
+};
+
+struct GfxFontSource
+{
+  std::string name;
+  std::vector<uint8_t> bitmap;
+  std::vector<GfxGlyphSource> glyphs;
+  uint16_t first = 0;
+  uint16_t last = 0;
+  uint8_t yAdvance = 0;
+  bool hasSubset = false;
+  std::string subset;
+  std::string subsetMacro;  // the #define the font names, if any
+
+  // Character of glyph i.
+  uint8_t character(size_t i) const
+  {
+    return hasSubset ? static_cast<uint8_t>(subset[i]) : static_cast<uint8_t>(first + i);
+  }
+
+  // Glyph number of c, or -1; first occurrence wins, as with strchr().
+  int glyphOf(uint8_t c) const
+  {
+    if (hasSubset)
+    {
+      const size_t at = c ? subset.find(static_cast<char>(c)) : std::string::npos;
+      return at == std::string::npos ? -1 : static_cast<int>(at);
+    }
+    return (c >= first && c <= last && c - first < static_cast<int>(glyphs.size())) ? c - first : -1;
+  }
+
+  // Pixels of glyph i, row-major; empty if its bits run past the bitmap.
+  std::vector<bool> pixels(size_t i) const
+  {
+    const GfxGlyphSource &g = glyphs[i];
+    const size_t count = static_cast<size_t>(g.width) * g.height;
+    std::vector<bool> out;
+    if (g.bitmapOffset + (count + 7) / 8 > bitmap.size()) return out;
+    out.resize(count);
+    for (size_t p = 0; p < count; ++p) out[p] = bitmap[g.bitmapOffset + p / 8] & (0x80 >> (p % 8));
+    return out;
+  }
+};
+
+namespace gfxfont_source
+{
+
+// The file without comments, string literals kept.
+inline std::string stripComments(const std::string &text)
+{
+  std::string out;
+  out.reserve(text.size());
+  for (size_t i = 0; i < text.size(); ++i)
+  {
+    if (text[i] == '"' || text[i] == '\'')
+    {
+      const char quote = text[i];
+      out += text[i++];
+      while (i < text.size() && text[i] != quote)
+      {
+        if (text[i] == '\\' && i + 1 < text.size()) out += text[i++];
+        out += text[i++];
+      }
+      if (i < text.size()) out += text[i];
+    }
+    else if (text.compare(i, 2, "//") == 0)
+    {
+      while (i < text.size() && text[i] != '\n') ++i;
+      out += '\n';
+    }
+    else if (text.compare(i, 2, "/*") == 0)
+    {
+      const size_t end = text.find("*/", i + 2);
+      i = end == std::string::npos ? text.size() : end + 1;
+      out += ' ';
+    }
+    else
+    {
+      out += text[i];
+    }
+  }
+  return out;
+}
+
+inline bool identChar(char c)
+{
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+// Identifier ending just before 'end'.
+inline std::string identBefore(const std::string &text, size_t end)
+{
+  size_t start = end;
+  while (start > 0 && identChar(text[start - 1])) --start;
+  return text.substr(start, end - start);
+}
+
+// Body between the '{' after 'from' and its matching '}'.
+inline bool braces(const std::string &text, size_t from, std::string &body, size_t &end)
+{
+  const size_t open = text.find('{', from);
+  if (open == std::string::npos) return false;
+  int depth = 0;
+  for (size_t i = open; i < text.size(); ++i)
+  {
+    if (text[i] == '{') ++depth;
+    else if (text[i] == '}' && --depth == 0)
+    {
+      body = text.substr(open + 1, i - open - 1);
+      end = i + 1;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Integer literals of 'body' in order (decimal or hex, signed); casts and
+// identifiers are skipped.
+inline std::vector<long> numbers(const std::string &body)
+{
+  std::vector<long> out;
+  for (size_t i = 0; i < body.size();)
+  {
+    if (identChar(body[i]) && !(body[i] >= '0' && body[i] <= '9'))
+    {
+      while (i < body.size() && identChar(body[i])) ++i;
+      continue;
+    }
+    if (body[i] >= '0' && body[i] <= '9')
+    {
+      bool negative = false;
+      size_t j = i;
+      while (j > 0 && (body[j - 1] == ' ' || body[j - 1] == '\t')) --j;
+      if (j > 0 && body[j - 1] == '-') negative = true;
+      char *end = nullptr;
+      const long value = strtol(body.c_str() + i, &end, 0);
+      out.push_back(negative ? -value : value);
+      i = end - body.c_str();
+      while (i < body.size() && identChar(body[i])) ++i;  // suffixes
+      continue;
+    }
+    ++i;
+  }
+  return out;
+}
+
+// Contents of the string literal starting at or after 'from'.
+inline bool literal(const std::string &text, size_t from, std::string &out)
+{
+  const size_t open = text.find('"', from);
+  if (open == std::string::npos) return false;
+  out.clear();
+  for (size_t i = open + 1; i < text.size(); ++i)
+  {
+    if (text[i] == '"') return true;
+    if (text[i] != '\\' || i + 1 >= text.size())
+    {
+      out += text[i];
+      continue;
+    }
+    const char e = text[++i];
+    if (e == 'x')
+    {
+      char *end = nullptr;
+      out += static_cast<char>(strtol(text.c_str() + i + 1, &end, 16));
+      i = end - text.c_str() - 1;
+    }
+    else if (e >= '0' && e <= '7')
+    {
+      int value = 0;
+      for (int n = 0; n < 3 && i < text.size() && text[i] >= '0' && text[i] <= '7'; ++n, ++i)
+      {
+        value = value * 8 + (text[i] - '0');
+      }
+      --i;
+      out += static_cast<char>(value);
+    }
+    else
+    {
+      out += e == 'n' ? '\n' : e == 't' ? '\t' : e;
+    }
+  }
+  return false;
+}
+
+}  // namespace gfxfont_source
+
+inline bool loadGfxFont(const char *path, GfxFontSource &font, std::string &error)
+{
+  using namespace gfxfont_source;
+  FILE *f = fopen(path, "rb");
+  if (!f)
+  {
+    error = std::string("cannot open ") + path;
+    return false;
+  }
+  std::string raw;
+  char buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) raw.append(buf, n);
+  fclose(f);
+  const std::string text = stripComments(raw);
+
+  const size_t fontAt = text.find("GFXfont ");
+  if (fontAt == std::string::npos)
+  {
+    error = "no GFXfont definition";
+    return false;
+  }
+  size_t nameEnd = fontAt + 8;
+  while (nameEnd < text.size() && text[nameEnd] == ' ') ++nameEnd;
+  size_t nameStart = nameEnd;
+  while (nameEnd < text.size() && identChar(text[nameEnd])) ++nameEnd;
+  font.name = text.substr(nameStart, nameEnd - nameStart);
+
+  std::string body;
+  size_t end = 0;
+  if (!braces(text, nameEnd, body, end))
+  {
+    error = "no initializer for " + font.name;
+    return false;
+  }
+  // bitmap and glyph arrays by name: '(uint8_t *)xBitmaps, (GFXglyph *)xGlyphs, ...'
+  std::vector<std::string> fields;
+  {
+    std::string field;
+    int depth = 0;
+    for (char c : body)
+    {
+      if (c == '(') ++depth;
+      if (c == ')') --depth;
+      if (c == ',' && depth == 0)
+      {
+        fields.push_back(field);
+        field.clear();
+      }
+      else
+      {
+        field += c;
+      }
+    }
+    fields.push_back(field);
+  }
+  if (fields.size() < 5)
+  {
+    error = font.name + ": expected bitmap, glyph, first, last, yAdvance";
+    return false;
+  }
+  auto trailingIdent = [](const std::string &field)
+  {
+    size_t e = field.size();
+    while (e > 0 && !identChar(field[e - 1])) --e;
+    return identBefore(field, e);
+  };
+  const std::string bitmapName = trailingIdent(fields[0]);
+  const std::string glyphName = trailingIdent(fields[1]);
+  font.first = static_cast<uint16_t>(strtol(fields[2].c_str(), nullptr, 0));
+  font.last = static_cast<uint16_t>(strtol(fields[3].c_str(), nullptr, 0));
+  font.yAdvance = static_cast<uint8_t>(strtol(fields[4].c_str(), nullptr, 0));
+  if (fields.size() > 5)
+  {
+    const std::string &s = fields[5];
+    if (s.find('"') != std::string::npos)
+    {
+      font.hasSubset = literal(s, 0, font.subset);
+    }
+    else
+    {
+      font.subsetMacro = trailingIdent(s);
+      if (!font.subsetMacro.empty() && font.subsetMacro != "nullptr" && font.subsetMacro != "NULL")
+      {
+        const size_t def = text.find("#define " + font.subsetMacro);
+        font.hasSubset = def != std::string::npos && literal(text, def, font.subset);
+        if (!font.hasSubset)
+        {
+          error = font.name + ": subset macro " + font.subsetMacro + " not defined as a string";
+          return false;
+        }
+      }
+      else
+      {
+        font.subsetMacro.clear();
+      }
+    }
+  }
+
+  const size_t bitmapAt = text.find(bitmapName + "[]");
+  const size_t glyphAt = text.find(glyphName + "[]");
+  if (bitmapAt == std::string::npos || glyphAt == std::string::npos)
+  {
+    error = font.name + ": arrays " + bitmapName + "[] and " + glyphName + "[] not found";
+    return false;
+  }
+  if (!braces(text, bitmapAt, body, end))
+  {
+    error = bitmapName + ": no initializer";
+    return false;
+  }
+  for (long v : numbers(body)) font.bitmap.push_back(static_cast<uint8_t>(v));
+  if (!braces(text, glyphAt, body, end))
+  {
+    error = glyphName + ": no initializer";
+    return false;
+  }
+  const std::vector<long> g = numbers(body);
+  if (g.size() % 6 != 0)
+  {
+    error = glyphName + ": entries are not 6 numbers each";
+    return false;
+  }
+  for (size_t i = 0; i < g.size(); i += 6)
+  {
+    font.glyphs.push_back(GfxGlyphSource{static_cast<uint16_t>(g[i]), static_cast<uint8_t>(g[i + 1]),
+                                         static_cast<uint8_t>(g[i + 2]), static_cast<uint8_t>(g[i + 3]),
+                                         static_cast<int8_t>(g[i + 4]), static_cast<int8_t>(g[i + 5])});
+  }
+  const size_t expected = font.hasSubset ? font.subset.size() : static_cast<size_t>(font.last - font.first + 1);
+  if (font.glyphs.size() != expected)
+  {
+    error = font.name + ": " + std::to_string(font.glyphs.size()) + " glyphs, expected " + std::to_string(expected);
+    return false;
+  }
+  for (size_t i = 0; i < font.glyphs.size(); ++i)
+  {
+    if (font.pixels(i).size() != static_cast<size_t>(font.glyphs[i].width) * font.glyphs[i].height)
+    {
+      error = font.name + ": glyph " + std::to_string(i) + " runs past the bitmap";
+      return false;
+    }
+  }
+  return true;
+}